@@ -370,6 +370,451 @@ bool sir_alert(PRINTF_FORMAT const char* format, ...);
 PRINTF_FORMAT_ATTR(1, 2)
 bool sir_emerg(PRINTF_FORMAT const char* format, ...);
 
+/**
+ * @brief Dispatches a log message at the specified level, along with the
+ * source location it originated from.
+ *
+ * Behaves like the level-specific functions (e.g., ::sir_info), except that
+ * the level is a parameter, and the source location in `cs` is made available
+ * to destinations that can record it (e.g., the systemd journal fields
+ * `CODE_FILE`, `CODE_LINE`, and `CODE_FUNC`). Normally called via the
+ * ::SIR_LOGAT macro, which declares the ::sir_callsite for you.
+ *
+ * @param   cs     Source location of the call. May be NULL.
+ * @param   level  The ::sir_level of the message (exactly one level).
+ * @param   format A printf-style format string, representing the template for
+ *                 the message to dispatch.
+ * @param   ...    Arguments whose type and position align with the format
+ *                 specifiers in `format`.
+ * @returns bool   `true` if the message was dispatched successfully to all
+ *                 registered destinations, `false` otherwise. Call ::sir_geterror
+ *                 to obtain information about any error that may have occurred.
+ */
+PRINTF_FORMAT_ATTR(3, 4)
+bool sir_logat(const sir_callsite* cs, sir_level level, PRINTF_FORMAT const char* format, ...);
+
+/**
+ * @brief Calls ::sir_logat with the source location of the macro invocation.
+ *
+ * Example: `SIR_LOGAT(SIRL_WARN, "disk %d is %d%% full", disk, pct);`
+ */
+# define SIR_LOGAT(level, ...) \
+    do { \
+        static const sir_callsite _sir_cs_ = {__FILE__, __LINE__, __func__}; \
+        (void)sir_logat(&_sir_cs_, (level), __VA_ARGS__); \
+    } while (0)
+
+/**
+ * @brief Dispatches a log message in a named category, if the rules set by
+ * ::sir_setcategories let its level through.
+ *
+ * Whether each level is logged for the category is decided on the first call,
+ * and cached in `site`. Until the rules are changed, later calls only compare
+ * the cached decision with the current rules before returning, so a message
+ * that is filtered out costs almost nothing: it isn't formatted, and no locks
+ * are taken. Normally called via the ::SIR_LOGCAT macro, which declares the
+ * ::sir_catsite for you.
+ *
+ * Messages which get through are then subject to the levels registered for
+ * each destination, as usual.
+ *
+ * @param   site   The call site (with static storage duration), which names
+ *                 the category (e.g., `"net.http"`).
+ * @param   level  The ::sir_level of the message (exactly one level).
+ * @param   format A printf-style format string, representing the template for
+ *                 the message to dispatch.
+ * @param   ...    Arguments whose type and position align with the format
+ *                 specifiers in `format`.
+ * @returns bool   `true` if the message was dispatched successfully to all
+ *                 registered destinations, `false` otherwise (including when it
+ *                 was filtered out, in which case ::sir_geterror returns
+ *                 ::SIR_E_NOERROR, as it does for squelched messages). Call
+ *                 ::sir_geterror to obtain information about any error that may
+ *                 have occurred.
+ */
+PRINTF_FORMAT_ATTR(3, 4)
+bool sir_logcat(sir_catsite* site, sir_level level, PRINTF_FORMAT const char* format, ...);
+
+/**
+ * @brief Calls ::sir_logcat with a ::sir_catsite for the macro invocation.
+ *
+ * Example: `SIR_LOGCAT("net.http", SIRL_DEBUG, "GET %s: %d", path, status);`
+ */
+# define SIR_LOGCAT(category, level, ...) \
+    do { \
+        static sir_catsite _sir_cat_ = {(category), 0U}; \
+        (void)sir_logcat(&_sir_cat_, (level), __VA_ARGS__); \
+    } while (0)
+
+/**
+ * @brief Dispatches a log message, unless the rate limit or sampling of its
+ * call site suppresses it.
+ *
+ * Of the calls made with `site`, one in every `site->sample` is chosen; those
+ * chosen are then let through at no more than `site->per_sec` per second on
+ * average, with up to `site->burst` at once (a token bucket). The decision is
+ * made without taking any locks, before the message is formatted.
+ *
+ * Messages suppressed by the rate limit or skipped by sampling are reported in
+ * a line in the format ::SIR_LIMIT_MSG_FORMAT with their number, at most once
+ * every ::SIR_LIMIT_REPORT_INTERVAL milliseconds per call site (any in between
+ * are included in the next). It precedes the next message let through, or, if
+ * none is by then, is logged by the ticker thread (at the level of the last
+ * message suppressed), or when the context is cleaned up. They are also counted
+ * in ::sir_stats.limited.
+ *
+ * Normally called via the ::SIR_LOGLIMIT or ::SIR_LOGSAMPLE macros, which
+ * declare the ::sir_limitsite for you.
+ *
+ * @param   site   The call site (with static storage duration); see
+ *                 ::SIR_LIMITSITE_INIT.
+ * @param   level  The ::sir_level of the message (exactly one level).
+ * @param   format A printf-style format string, representing the template for
+ *                 the message to dispatch.
+ * @param   ...    Arguments whose type and position align with the format
+ *                 specifiers in `format`.
+ * @returns bool   `true` if the message was dispatched successfully to all
+ *                 registered destinations, `false` otherwise (including when it
+ *                 was suppressed, in which case ::sir_geterror returns
+ *                 ::SIR_E_NOERROR, as it does for squelched messages). Call
+ *                 ::sir_geterror to obtain information about any error that may
+ *                 have occurred.
+ */
+PRINTF_FORMAT_ATTR(3, 4)
+bool sir_loglimit(sir_limitsite* site, sir_level level, PRINTF_FORMAT const char* format, ...);
+
+/**
+ * @brief Initializes a ::sir_limitsite for the source location where it is used.
+ *
+ * Example: `static sir_limitsite site = SIR_LIMITSITE_INIT(10, 20, 0);`
+ */
+# define SIR_LIMITSITE_INIT(per_sec, burst, sample) \
+    {(per_sec), (burst), (sample), __FILE__, __LINE__, 0, 0, 0U, 0U, 0U, 0U, NULL, NULL}
+
+/**
+ * @brief Calls ::sir_loglimit, letting through at most `per_sec` messages per
+ * second from the macro invocation.
+ *
+ * Example: `SIR_LOGLIMIT(10, SIRL_ERROR, "read failed: %d", err);`
+ */
+# define SIR_LOGLIMIT(per_sec, level, ...) \
+    do { \
+        static sir_limitsite _sir_ls_ = SIR_LIMITSITE_INIT((per_sec), 0U, 0U); \
+        (void)sir_loglimit(&_sir_ls_, (level), __VA_ARGS__); \
+    } while (0)
+
+/**
+ * @brief Calls ::sir_loglimit, letting through one in every `n` messages from
+ * the macro invocation.
+ *
+ * Example: `SIR_LOGSAMPLE(100, SIRL_DEBUG, "packet %u", seq);`
+ */
+# define SIR_LOGSAMPLE(n, level, ...) \
+    do { \
+        static sir_limitsite _sir_ls_ = SIR_LIMITSITE_INIT(0U, 0U, (n)); \
+        (void)sir_loglimit(&_sir_ls_, (level), __VA_ARGS__); \
+    } while (0)
+
+/**
+ * @brief Sets the rules which decide the levels logged in each category (see
+ * ::sir_logcat).
+ *
+ * `spec` is a comma-separated list of `category=level` rules, e.g.
+ * `"net=info,net.http=debug,*=warn"`. A rule lets through its level and those
+ * more severe; the level names are `debug`, `info`, `notice`, `warn`, `error`,
+ * `crit`, `alert`, `emerg`, `all` and `none`. Category names are made of
+ * letters, digits, `_` and `-`, in components separated by dots.
+ *
+ * A category follows the rule with the longest name which is either its own
+ * name or that of one of its parents (`net` is the parent of `net.http`), or
+ * else the `*` rule. If there is no such rule, all levels are logged.
+ *
+ * @note Messages logged without a category (e.g., with ::sir_info) are not
+ * affected.
+ *
+ * @param   spec   The rules, or NULL or an empty string to remove all rules.
+ * @returns bool   `true` if the rules were replaced, `false` otherwise (e.g.,
+ *                 `spec` was malformed or had more than ::SIR_MAXCATEGORIES
+ *                 rules, in which case the existing rules are unchanged). Call
+ *                 ::sir_geterror to obtain information about any error that may
+ *                 have occurred.
+ */
+bool sir_setcategories(const char* spec);
+
+/** Constructs a string ::sir_kv_value for ::sir_logkv. */
+# define SIR_KV_STR(val) _sir_kv_str(val)
+
+/** Constructs a signed integer ::sir_kv_value for ::sir_logkv. */
+# define SIR_KV_INT(val) _sir_kv_int(val)
+
+/** Constructs an unsigned integer ::sir_kv_value for ::sir_logkv. */
+# define SIR_KV_UINT(val) _sir_kv_uint(val)
+
+/** Constructs a floating-point ::sir_kv_value for ::sir_logkv. */
+# define SIR_KV_FLOAT(val) _sir_kv_float(val)
+
+/** Constructs a boolean ::sir_kv_value for ::sir_logkv. */
+# define SIR_KV_BOOL(val) _sir_kv_bool(val)
+
+/** Terminates the list of fields passed to ::sir_logkv. */
+# define SIR_KV_END ((const char*)NULL)
+
+static inline
+sir_kv_value _sir_kv_str(const char* val) {
+    sir_kv_value kv;
+    kv.type = SIRKV_STR;
+    kv.v.s  = val;
+    return kv;
+}
+
+static inline
+sir_kv_value _sir_kv_int(int64_t val) {
+    sir_kv_value kv;
+    kv.type = SIRKV_INT;
+    kv.v.i  = val;
+    return kv;
+}
+
+static inline
+sir_kv_value _sir_kv_uint(uint64_t val) {
+    sir_kv_value kv;
+    kv.type = SIRKV_UINT;
+    kv.v.u  = val;
+    return kv;
+}
+
+static inline
+sir_kv_value _sir_kv_float(double val) {
+    sir_kv_value kv;
+    kv.type = SIRKV_FLOAT;
+    kv.v.f  = val;
+    return kv;
+}
+
+static inline
+sir_kv_value _sir_kv_bool(bool val) {
+    sir_kv_value kv;
+    kv.type = SIRKV_BOOL;
+    kv.v.b  = val;
+    return kv;
+}
+
+/**
+ * @brief Dispatches a message with key/value fields attached.
+ *
+ * Unlike ::sir_info and friends, `message` is not a format string; it is used
+ * as-is. The fields are carried alongside the message, rather than formatted
+ * into it, and each destination renders them in its own way:
+ *
+ * - Text output (`stdout`/`stderr`, log files, and the lines sent to plugins
+ *   and the system logger): appended to the message as logfmt pairs, e.g.
+ *   `request done user=bob ms=12`.
+ * - Destinations with ::SIRO_JSON: additional members of the object.
+ * - The built-in RFC 5424 transport (see ::sir_syslogaddr): parameters in the
+ *   structured data element.
+ * - The systemd journal: fields, with their names upper-cased.
+ * - Plugins with ::SIR_PLUGINCAP_RECORDS: @ref sir_plugin_record.fields
+ *   "sir_plugin_record.fields".
+ *
+ * Fields are passed as pairs of a key and a ::sir_kv_value constructed by one
+ * of the `SIR_KV_*` macros, and the list must end with ::SIR_KV_END:
+ *
+ * `sir_info_kv("request done", "user", SIR_KV_STR(user), "ms", SIR_KV_INT(12), SIR_KV_END);`
+ *
+ * The keys and string values must remain valid for the duration of the call.
+ *
+ * @remark At most ::SIR_MAXFIELDS fields are used; any others are ignored.
+ * Fields which don't fit in a destination's output are left out of it.
+ *
+ * @param   level   The ::sir_level of the message (exactly one level).
+ * @param   message The message to dispatch.
+ * @param   ...     Pairs of `const char*` key and ::sir_kv_value, followed by
+ *                  ::SIR_KV_END.
+ * @returns bool    `true` if the message was dispatched successfully to all
+ *                  registered destinations, `false` otherwise. Call
+ *                  ::sir_geterror to obtain information about any error that
+ *                  may have occurred.
+ */
+SENTINEL_ATTR
+bool sir_logkv(sir_level level, const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_DEBUG level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_debug_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_INFO level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_info_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_NOTICE level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_notice_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_WARN level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_warn_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_ERROR level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_error_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_CRIT level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_crit_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_ALERT level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_alert_kv(const char* message, ...);
+
+/** @brief Dispatches a ::SIRL_EMERG level message with key/value fields. @see ::sir_logkv */
+SENTINEL_ATTR
+bool sir_emerg_kv(const char* message, ...);
+
+/**
+ * @brief Initializes a new, independent instance of libsir.
+ *
+ * By default, every libsir function operates on one process-wide instance,
+ * set up by ::sir_init. A context is another instance, with its own
+ * configuration, log files, plugins (and their queues), locks and squelch
+ * state, so that it does not contend with any other. It could be used by one
+ * subsystem of a program, or by a library that does not want to share libsir
+ * with the program that uses it.
+ *
+ * Each function that logs to, or configures, an instance has a counterpart
+ * prefixed with `sir_ctx_` that takes the context as its first argument (e.g.
+ * ::sir_ctx_info, ::sir_ctx_addfile); the rest operate on the default instance.
+ *
+ * @remark `stdout`, `stderr`, the system logger, text styles and statistics
+ * belong to the process, and are shared by all contexts. If more than one
+ * context logs to the system logger, the last to set its identity wins.
+ *
+ * @param   si          Pointer to a ::sirinit structure, as for ::sir_init.
+ * @returns sir_context A new context, or NULL if it could not be initialized.
+ *                      Call ::sir_geterror to obtain information about any error
+ *                      that may have occurred. Pass it to ::sir_ctx_cleanup when
+ *                      no longer needed.
+ */
+sir_context* sir_ctx_init(sirinit* si);
+
+/**
+ * @brief Tears down and frees a context created by ::sir_ctx_init.
+ *
+ * No thread may use `ctx` during or after this call.
+ *
+ * @param   ctx  The context to clean up.
+ * @returns bool `true` if cleanup was successful, `false` otherwise. Call
+ *               ::sir_geterror to obtain information about any error that may
+ *               have occurred.
+ */
+bool sir_ctx_cleanup(sir_context* ctx);
+
+/** @brief Dispatches a ::SIRL_DEBUG level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_debug(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_INFO level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_info(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_NOTICE level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_notice(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_WARN level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_warn(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_ERROR level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_error(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_CRIT level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_crit(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_ALERT level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_alert(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Dispatches a ::SIRL_EMERG level message using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_emerg(sir_context* ctx, PRINTF_FORMAT const char* format, ...);
+
+/** @brief Like ::sir_logcat, using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(4, 5)
+bool sir_ctx_logcat(sir_context* ctx, sir_catsite* site, sir_level level,
+    PRINTF_FORMAT const char* format, ...);
+
+/** @brief Like ::sir_loglimit, using `ctx`. @see ::sir_ctx_init */
+PRINTF_FORMAT_ATTR(4, 5)
+bool sir_ctx_loglimit(sir_context* ctx, sir_limitsite* site, sir_level level,
+    PRINTF_FORMAT const char* format, ...);
+
+/** @brief Like ::sir_setcategories, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_setcategories(sir_context* ctx, const char* spec);
+
+/** @brief Like ::sir_addfile, for `ctx`. @see ::sir_ctx_init */
+sirfileid sir_ctx_addfile(sir_context* ctx, const char* path, sir_levels levels,
+    sir_options opts);
+
+/** @brief Like ::sir_remfile, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_remfile(sir_context* ctx, sirfileid id);
+
+/** @brief Like ::sir_filelevels, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_filelevels(sir_context* ctx, sirfileid id, sir_levels levels);
+
+/** @brief Like ::sir_fileopts, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_fileopts(sir_context* ctx, sirfileid id, sir_options opts);
+
+/** @brief Like ::sir_loadplugin, for `ctx`. @see ::sir_ctx_init */
+sirpluginid sir_ctx_loadplugin(sir_context* ctx, const char* path);
+
+/** @brief Like ::sir_unloadplugin, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_unloadplugin(sir_context* ctx, sirpluginid id);
+
+/** @brief Like ::sir_pluginpolicy, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_pluginpolicy(sir_context* ctx, sirpluginid id, sir_plugin_overflow policy);
+
+/** @brief Like ::sir_pluginstats, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_pluginstats(sir_context* ctx, sirpluginid id, sir_plugin_stats* stats);
+
+/** @brief Like ::sir_stdoutlevels, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_stdoutlevels(sir_context* ctx, sir_levels levels);
+
+/** @brief Like ::sir_stdoutopts, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_stdoutopts(sir_context* ctx, sir_options opts);
+
+/** @brief Like ::sir_stderrlevels, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_stderrlevels(sir_context* ctx, sir_levels levels);
+
+/** @brief Like ::sir_stderropts, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_stderropts(sir_context* ctx, sir_options opts);
+
+/** @brief Like ::sir_settimeformat, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_settimeformat(sir_context* ctx, sir_time_format format,
+    sir_time_precision precision);
+
+/** @brief Like ::sir_sysloglevels, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_sysloglevels(sir_context* ctx, sir_levels levels);
+
+/** @brief Like ::sir_syslogopts, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_syslogopts(sir_context* ctx, sir_options opts);
+
+/** @brief Like ::sir_syslogid, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_syslogid(sir_context* ctx, const char* identity);
+
+/** @brief Like ::sir_syslogcat, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_syslogcat(sir_context* ctx, const char* category);
+
+/** @brief Like ::sir_syslogaddr, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_syslogaddr(sir_context* ctx, const char* address);
+
+/** @brief Like ::sir_lockstats, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_lockstats(sir_context* ctx, sir_mutex_id mid, sir_lock_stats* stats);
+
+/** @brief Like ::sir_resetlockstats, for `ctx`. @see ::sir_ctx_init */
+bool sir_ctx_resetlockstats(sir_context* ctx);
+
 /**
  * @brief Adds a log file and registers it to receive log output.
  *
@@ -481,6 +926,47 @@ sirpluginid sir_loadplugin(const char* path);
  */
 bool sir_unloadplugin(sirpluginid id);
 
+/**
+ * @brief Sets what happens when a plugin's queue is full.
+ *
+ * Each loaded plugin has its own worker thread, which delivers messages from a
+ * bounded queue of up to ::SIR_PLUGIN_QUEUE_SIZE messages, so a plugin that is
+ * slow to process messages does not stall the threads that log them. When the
+ * queue is full:
+ *
+ * - ::SIRPO_DROP: the message is discarded and counted as dropped (see
+ *   ::sir_pluginstats), and the logging call returns `false`.
+ * - ::SIRPO_BLOCK: the logging thread waits until the worker makes room.
+ *
+ * Plugins start with ::SIR_PLUGIN_OVERFLOW_DEFAULT.
+ *
+ * @see ::sir_pluginstats
+ *
+ * @param   id     The ::sirpluginid obtained when the plugin was loaded.
+ * @param   policy The ::sir_plugin_overflow policy to apply.
+ * @returns bool   `true` if the plugin was located and its policy was set,
+ *                 `false` otherwise. Use ::sir_geterror to obtain information
+ *                 about any error that may have occurred.
+ */
+bool sir_pluginpolicy(sirpluginid id, sir_plugin_overflow policy);
+
+/**
+ * @brief Retrieves the counters of a plugin's queue.
+ *
+ * Includes the number of messages queued, delivered, failed (the plugin
+ * returned `false`), and dropped (the queue was full), the current queue depth,
+ * and the average and maximum time from queueing to delivery.
+ *
+ * @see ::sir_pluginpolicy
+ *
+ * @param   id    The ::sirpluginid obtained when the plugin was loaded.
+ * @param   stats Pointer to a ::sir_plugin_stats structure to receive the counters.
+ * @returns bool  `true` if the plugin was located, `false` otherwise. Use
+ *                ::sir_geterror to obtain information about any error that may
+ *                have occurred.
+ */
+bool sir_pluginstats(sirpluginid id, sir_plugin_stats* stats);
+
 /**
  * @brief Set new level registrations for a log file already managed by libsir.
  *
@@ -691,6 +1177,32 @@ bool sir_stderrlevels(sir_levels levels);
  */
 bool sir_stderropts(sir_options opts);
 
+/**
+ * @brief Set how time stamps are formatted.
+ *
+ * Applies to every destination (stdio, log files, and plugins that receive the
+ * formatted line). By default, time stamps are in local time, with millisecond
+ * precision (e.g. `21:16:15.034`).
+ *
+ * | Format          | Example                          |
+ * | --------------- | -------------------------------- |
+ * | ::SIRTF_LOCAL   | `21:16:15.034`                   |
+ * | ::SIRTF_UTC     | `01:16:15.034`                   |
+ * | ::SIRTF_ISO8601 | `2026-10-19T01:16:15.034Z`       |
+ * | ::SIRTF_EPOCH   | `1792372575.034`                 |
+ *
+ * ::SIRTP_USEC and ::SIRTP_NSEC print six or nine digits instead of three, and
+ * read the precise wall clock rather than the (cheaper) coarse one. The fraction
+ * of a second may be omitted with ::SIRO_NOMSEC.
+ *
+ * @param   format    The ::sir_time_format to use.
+ * @param   precision The ::sir_time_precision to use.
+ * @returns bool      `true` if successfully updated, `false` otherwise. Use
+ *                    ::sir_geterror to obtain information about any error that
+ *                    may have occurred.
+ */
+bool sir_settimeformat(sir_time_format format, sir_time_precision precision);
+
 /**
  * @brief Set new level registrations for the system logger destination.
  *
@@ -787,6 +1299,126 @@ bool sir_syslogid(const char* identity);
  */
 bool sir_syslogcat(const char* category);
 
+/**
+ * @brief Send system logger messages directly to a syslog receiver.
+ *
+ * Instead of handing messages to the platform's system logging facility (e.g.,
+ * `syslog`), libsir formats them according to RFC 5424 and sends them over its
+ * own non-blocking datagram socket. Messages are queued and sent in batches of
+ * up to ::SIR_NETSYSLOG_BATCH (using `sendmmsg` where available), at least
+ * every ::SIR_TICKER_INTERVAL milliseconds, and immediately when a level in
+ * ::SIR_NETSYSLOG_FLUSH_LEVELS is logged. Messages that cannot be sent without
+ * blocking are dropped and counted (see ::sir_syslogstats). If the receiver goes
+ * away (e.g., it is restarted), the ticker thread reconnects, waiting from
+ * ::SIR_NETSYSLOG_BACKOFF_MIN up to ::SIR_NETSYSLOG_BACKOFF_MAX milliseconds
+ * between attempts; messages logged meanwhile are dropped and counted.
+ *
+ * Accepted address forms are:
+ *
+ * - `unix:/path/to/socket` (e.g., `unix:/dev/log`)
+ * - `udp:host:port` (e.g., `udp:127.0.0.1:514` or `udp:[::1]:514`)
+ * - `journal:` or `journal:/path/to/socket` (Linux only): the systemd journal's
+ *   native protocol, with the socket defaulting to ::SIR_JOURNAL_SOCKET.
+ *   Records are sent immediately (not batched), and carry the fields `MESSAGE`,
+ *   `PRIORITY`, `SYSLOG_IDENTIFIER`, `SYSLOG_FACILITY`, `SYSLOG_PID`, `TID`,
+ *   `SIR_CATEGORY`, and, when logged via ::SIR_LOGAT, `CODE_FILE`, `CODE_LINE`
+ *   and `CODE_FUNC`, plus any key/value fields attached by ::sir_logkv.
+ *   Records too large for a datagram are passed in a sealed memfd, as
+ *   `sd_journal_send` does.
+ *
+ * Pass an empty string to go back to using the system logging facility. The
+ * address may also be set before initialization via
+ * @ref sir_syslog_dest.address "sirinit.d_syslog.address".
+ *
+ * The transport belongs to the process, and is shared by every context (see
+ * ::sir_ctx_init) that uses it: it stays open until the last of them stops
+ * using it. While other contexts are using it, it can't be moved to a different
+ * address; attempting to do so fails with ::SIR_E_INVALID, leaving their
+ * messages (and counters) untouched.
+ *
+ * @remark If `SIR_NO_SYSTEM_LOGGERS` is defined when compiling libsir, this
+ * function will immediately return false, and set the last error to
+ * ::SIR_E_UNAVAIL. The built-in transport is not available on Windows.
+ *
+ * @param   address The address of the syslog receiver, or an empty string.
+ * @returns bool    `true` if successfully updated, `false` otherwise. Use
+ *                  ::sir_geterror to obtain information about any error that
+ *                  may have occurred.
+ */
+bool sir_syslogaddr(const char* address);
+
+/**
+ * @brief Retrieves counters for messages sent via ::sir_syslogaddr.
+ *
+ * The counters are reset each time a connection to a new address is made.
+ *
+ * @param   stats Pointer to a ::sir_syslog_stats structure to receive the counters.
+ * @returns bool  `true` if successful, `false` otherwise. Use ::sir_geterror
+ *                to obtain information about any error that may have occurred.
+ */
+bool sir_syslogstats(sir_syslog_stats* stats);
+
+/**
+ * @brief Retrieves the contention counters for one of libsir's locked sections.
+ *
+ * Every libsir lock guards one section (e.g., ::SIRMI_CONFIG, the
+ * configuration, or ::SIRMI_FILECACHE, the log files). For the given section,
+ * reports how many times it was entered, how many of those had to wait for
+ * another thread, the total time spent waiting, and the longest time any
+ * thread stayed inside. The counters are only collected by builds with
+ * `SIR_LOCK_PROFILE` defined; otherwise, fails with `SIR_E_UNAVAIL`.
+ *
+ * @remark Each context (see ::sir_ctx_init) keeps its own counters; the ones
+ * reported are those of the default instance (see ::sir_ctx_lockstats), except
+ * for ::SIRMI_TEXTSTYLE, which is shared by all of them.
+ *
+ * @see ::sir_resetlockstats
+ *
+ * @param   mid   The ::sir_mutex_id of the section.
+ * @param   stats Pointer to a ::sir_lock_stats structure to receive the counters.
+ * @returns bool  `true` if successful, `false` otherwise. Use ::sir_geterror
+ *                to obtain information about any error that may have occurred.
+ */
+bool sir_lockstats(sir_mutex_id mid, sir_lock_stats* stats);
+
+/**
+ * @brief Zeroes the contention counters for all of libsir's locked sections
+ * (those of the default instance, and the shared text style section).
+ *
+ * @see ::sir_lockstats
+ *
+ * @returns bool `true` if successful, `false` otherwise. Use ::sir_geterror
+ *               to obtain information about any error that may have occurred.
+ */
+bool sir_resetlockstats(void);
+
+/**
+ * @brief Retrieves runtime counters for messages and destinations.
+ *
+ * Reports how many messages were logged at each level, how many were squelched,
+ * rate-limited or had no destination, and for stdout, stderr, the system logger, and each
+ * log file and plugin, how many lines and bytes were written and how many
+ * writes failed. Builds with `SIR_STATS_LATENCY` defined also keep latency
+ * histograms: `logv` for the whole call, and `latency` for each destination's
+ * writes (otherwise, they are all zero). Bucket `n` of a ::sir_histogram counts
+ * samples of at least 2^n nanoseconds (and less than 2^(n+1)).
+ *
+ * The counters are kept per thread group without locking, so the values are
+ * not a consistent snapshot while other threads are logging. They are reset
+ * by ::sir_init. Builds without C11 atomics, or with `SIR_NO_STATS` defined,
+ * fail with `SIR_E_UNAVAIL`.
+ *
+ * @remark The counters belong to the process: files and plugins of every
+ * context (see ::sir_ctx_init) are reported together, and beyond
+ * ::SIR_MAXFILES files or ::SIR_MAXPLUGINS plugins in all, the rest are not
+ * counted.
+ *
+ * @param   stats Pointer to a ::sir_stats structure to receive the counters.
+ * @returns bool  `true` if successful, `false` otherwise. Use ::sir_geterror
+ *                to obtain information about any error that may have occurred.
+ */
+bool sir_getstats(sir_stats* stats);
+
 /**
  * @brief Returns the current libsir version as a string.
  *
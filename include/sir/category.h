@@ -0,0 +1,83 @@
+/*
+ * category.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_CATEGORY_H_INCLUDED
+# define _SIR_CATEGORY_H_INCLUDED
+
+# include "sir/types.h"
+
+/**
+ * The decision cached in a ::sir_catsite: the generation of the rules it was
+ * made under, shifted left by this many bits, OR'ed with the levels that pass.
+ */
+# define SIR_CATGEN_SHIFT 8
+
+/** The generations of category rules wrap around at this mask (0 is never used). */
+# define SIR_CATGEN_MASK 0x00ffffffU
+
+/**
+ * Parses a category specification (e.g., `"net=info,net.http=debug,*=warn"`)
+ * into at most ::SIR_MAXCATEGORIES rules. NULL or an empty string yields no
+ * rules. Sets ::SIR_E_INVALID and returns `false` if `spec` is malformed.
+ */
+bool _sir_parsecategories(const char* spec, sir_category_rule* rules, size_t* count);
+
+/**
+ * Returns the levels that pass for `category`: those of the rule with the
+ * longest name that is either `category` itself or one of its parents (e.g.,
+ * `net` for `net.http`); failing that, those of the default rule; failing that,
+ * all levels.
+ */
+sir_levels _sir_matchcategory(const sir_category_rule* rules, size_t count,
+    const char* category);
+
+/** Reads the decision cached in a ::sir_catsite. */
+static inline
+uint32_t _sir_catsite_load(const sir_catsite* site) {
+# if defined(__GNUC__)
+    return __atomic_load_n(&site->cache, __ATOMIC_RELAXED);
+# else
+    return site->cache;
+# endif
+}
+
+/** Caches a decision in a ::sir_catsite. */
+static inline
+void _sir_catsite_store(sir_catsite* site, uint32_t cache) {
+# if defined(__GNUC__)
+    __atomic_store_n(&site->cache, cache, __ATOMIC_RELAXED);
+# else
+    site->cache = cache;
+# endif
+}
+
+#endif /* !_SIR_CATEGORY_H_INCLUDED */
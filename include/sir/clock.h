@@ -0,0 +1,104 @@
+/*
+ * clock.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_CLOCK_H_INCLUDED
+# define _SIR_CLOCK_H_INCLUDED
+
+# include "sir/types.h"
+
+/** Whether (and how) the CPU's time stamp counter can be read. */
+# if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  if defined(_MSC_VER)
+#   include <intrin.h>
+#   define SIR_TSC_X86
+#  elif defined(__GNUC__)
+#   include <x86intrin.h>
+#   define SIR_TSC_X86
+#  endif
+# elif defined(__aarch64__) && defined(__GNUC__)
+#  define SIR_TSC_ARM64
+# endif
+
+/**
+ * Calibrates the CPU's time stamp counter against the wall clock. The first
+ * time (i.e., when `cal->valid` is false), checks that the counter is invariant
+ * and measures its rate over ::SIR_TSC_CALIBRATION_USEC; after that, refines the
+ * rate and moves the base of the conversion up to now. Returns `false` (leaving
+ * `cal->valid` false) if the counter can't be used.
+ */
+bool _sir_tsc_calibrate(sir_tsc_calib* cal);
+
+/**
+ * Turns the time published for ::SIRTS_CACHED on or off; turning it on also
+ * publishes the current time. Returns `false` if atomics are unavailable.
+ */
+bool _sir_clock_setcached(bool enabled);
+
+/** Returns `true` if the ticker thread should publish the time. */
+bool _sir_clock_cached(void);
+
+/** Publishes the current time; called by the ticker thread. */
+void _sir_clock_publish(void);
+
+/** Reads the time last published. Returns `false` if there is none. */
+bool _sir_clock_getcached(time_t* sec, long* nsec);
+
+/** Reads the CPU's time stamp counter (0 if there isn't one). */
+static inline
+uint64_t _sir_tsc_read(void) {
+# if defined(SIR_TSC_X86)
+    return (uint64_t)__rdtsc();
+# elif defined(SIR_TSC_ARM64)
+    uint64_t ticks = 0;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+# else
+    return 0;
+# endif
+}
+
+/** Converts a value read by ::_sir_tsc_read to wall clock time, using `cal`. */
+static inline
+void _sir_tsc_totime(const sir_tsc_calib* cal, uint64_t ticks, time_t* sec, long* nsec) {
+    int64_t delta = (int64_t)(ticks - cal->ticks);
+    int64_t ns    = (int64_t)cal->nsec + (int64_t)((double)delta * cal->nsec_per_tick);
+
+    *sec = cal->sec + (time_t)(ns / 1000000000LL);
+    ns  %= 1000000000LL;
+    if (ns < 0) {
+        ns += 1000000000LL;
+        (*sec)--;
+    }
+    *nsec = (long)ns;
+}
+
+#endif /* !_SIR_CLOCK_H_INCLUDED */
@@ -42,7 +42,6 @@
  */
 bool _sir_condcreate(sir_condition* cond);
 
-# if 0
 /**
  * Signals a condition variable.
  *
@@ -50,7 +49,6 @@ bool _sir_condcreate(sir_condition* cond);
  * @returns bool `true` if successful, `false` otherwise.
  */
 bool _sir_condsignal(sir_condition* cond);
-# endif
 
 /**
  * Broadcast signals a condition variable.
@@ -68,7 +66,6 @@ bool _sir_condbroadcast(sir_condition* cond);
  */
 bool _sir_conddestroy(sir_condition* cond);
 
-# if 0
 /**
  * Waits indefinitely for a condition variable to become signaled.
  *
@@ -76,7 +73,6 @@ bool _sir_conddestroy(sir_condition* cond);
  * @returns bool `true` if successful, `false` otherwise.
  */
 bool _sir_condwait(sir_condition* cond, sir_mutex* mutex);
-# endif
 
 /**
  * Waits a given amount of time for a condition variable to become signaled.
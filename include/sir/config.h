@@ -40,9 +40,10 @@
 
 /**
  * The time stamp format string at the start of log messages-not including
- * milliseconds (as::SIR_MSECFORMAT), which is added separately.
+ * the fraction of a second, which is added separately.
  *
- * @remark Only applies if ::SIRO_NOTIME is not set.
+ * @remark Only applies if ::SIRO_NOTIME is not set, and the time stamp format
+ * is ::SIRTF_LOCAL or ::SIRTF_UTC (see ::sir_settimeformat).
  *
  * **Example**
  *   ~~~
@@ -53,21 +54,6 @@
 #  define SIR_TIMEFORMAT "%H:%M:%S"
 # endif
 
-/**
- * The format for milliseconds (1000ths of a second) in time stamps.
- *
- * @remark Only applies if ::SIRO_NOTIME *or* ::SIRO_NOMSEC are not set.
- * @remark ::SIRO_NOTIME implies ::SIRO_NOMSEC.
- *
- * **Example**
- *   ~~~
- *   .034
- *   ~~~
- */
-# if !defined(SIR_MSECFORMAT)
-#  define SIR_MSECFORMAT ".%03ld"
-# endif
-
 /**
  * The carriage return (CR) character to use in the end of line
  * sequence when SIR_USE_EOL_CRLF is defined.
@@ -329,6 +315,100 @@
 #  define SIR_MAXPLUGINS 16
 # endif
 
+/**
+ * The maximum number of messages that may wait in each plugin's queue for its
+ * worker thread. When the queue is full, the plugin's overflow policy applies
+ * (see ::sir_pluginpolicy).
+ */
+# if !defined(SIR_PLUGIN_QUEUE_SIZE)
+#  define SIR_PLUGIN_QUEUE_SIZE 256
+# endif
+
+/**
+ * The size, in bytes, of the buffer which holds the text of the messages in
+ * each plugin's queue. Must be able to hold at least one message and line,
+ * along with ::SIR_MAXFIELDS fields; a field's key or string value is cut off
+ * at ::SIR_MAXMESSAGE characters when it is copied into the queue.
+ */
+# if !defined(SIR_PLUGIN_QUEUE_BYTES)
+#  define SIR_PLUGIN_QUEUE_BYTES 262144
+# endif
+
+/**
+ * The number of key/value fields (see ::sir_logkv) which may be held in each
+ * plugin's queue, across all of its messages.
+ */
+# if !defined(SIR_PLUGIN_QUEUE_FIELDS)
+#  define SIR_PLUGIN_QUEUE_FIELDS 1024
+# endif
+
+/**
+ * The maximum number of records delivered to a plugin with the
+ * ::SIR_PLUGINCAP_RECORDS capability in one call.
+ */
+# if !defined(SIR_PLUGIN_BATCH)
+#  define SIR_PLUGIN_BATCH 64
+# endif
+
+/** The overflow policy that newly loaded plugins start with. */
+# if !defined(SIR_PLUGIN_OVERFLOW_DEFAULT)
+#  define SIR_PLUGIN_OVERFLOW_DEFAULT SIRPO_DROP
+# endif
+
+/**
+ * The maximum number of jobs that may be outstanding in a thread pool at once.
+ * Each worker's queue has room for this many (rounded up to a power of two).
+ */
+# if !defined(SIR_THREADPOOL_QUEUE_SIZE)
+#  define SIR_THREADPOOL_QUEUE_SIZE 1024
+# endif
+
+/**
+ * The assumed size, in bytes, of a CPU cache line. Variables written frequently
+ * by different threads (e.g., the ends of a ::sir_queue) are kept at least this
+ * far apart, so that they do not share one.
+ */
+# if !defined(SIR_CACHELINE)
+#  define SIR_CACHELINE 64
+# endif
+
+/**
+ * The number of buckets in a ::sir_histogram. The last one holds every sample
+ * of 2^(SIR_STATS_BUCKETS - 1) nanoseconds or more.
+ */
+# if !defined(SIR_STATS_BUCKETS)
+#  define SIR_STATS_BUCKETS 32
+# endif
+
+/**
+ * The number of sets of counters kept by libsir for ::sir_getstats. Each thread
+ * updates one set, and shares it with as few others as possible; the sets are
+ * added together when read.
+ */
+# if !defined(SIR_STATS_SHARDS)
+#  define SIR_STATS_SHARDS 8
+# endif
+
+/**
+ * With `SIR_ADAPTIVE_MUTEX`, the number of times a thread checks whether a
+ * locked mutex has become free before it asks the kernel to put it to sleep.
+ */
+# if !defined(SIR_MUTEX_SPIN)
+#  define SIR_MUTEX_SPIN 100
+# endif
+
+/**
+ * The size, in characters, of the buffer used to hold the address of the
+ * system logger to send RFC 5424 messages to (see ::sir_syslogaddr).
+ */
+# if !defined(SIR_MAX_SYSLOG_ADDR)
+#  if !defined(SIR_EMBEDDED)
+#   define SIR_MAX_SYSLOG_ADDR 128
+#  else
+#   define SIR_MAX_SYSLOG_ADDR 1
+#  endif
+# endif
+
 /** The size, in characters, of the buffer used to hold file header format strings. */
 # if !defined(SIR_MAXFHEADER)
 #  define SIR_MAXFHEADER 128
@@ -341,6 +421,23 @@
 #  define SIR_MAXHOST 1
 # endif
 
+/**
+ * The maximum length of a category name (see ::sir_setcategories), including
+ * the null terminator.
+ */
+# if !defined(SIR_MAXCATEGORY)
+#  define SIR_MAXCATEGORY 48
+# endif
+
+/** The maximum number of rules in a category specification (see ::sir_setcategories). */
+# if !defined(SIR_MAXCATEGORIES)
+#  if !defined(SIR_EMBEDDED)
+#   define SIR_MAXCATEGORIES 32
+#  else
+#   define SIR_MAXCATEGORIES 8
+#  endif
+# endif
+
 /**
  * The maximum number of characters allowable in one log message. This
  * does not include accompanying formatted output (see ::SIR_MAXOUTPUT).
@@ -353,14 +450,29 @@
 #  endif
 # endif
 
+/**
+ * The maximum number of key/value fields which may be attached to one message
+ * (see ::sir_logkv). Any beyond this are ignored.
+ */
+# if !defined(SIR_MAXFIELDS)
+#  if !defined(SIR_EMBEDDED)
+#   define SIR_MAXFIELDS 16
+#  else
+#   define SIR_MAXFIELDS 4
+#  endif
+# endif
+
 /** The size, in characters, of the buffer used to hold time format strings. */
 # if !defined(SIR_MAXTIME)
 #  define SIR_MAXTIME 64
 # endif
 
-/** The size, in characters, of the buffer used to hold millisecond strings. */
+/**
+ * The size, in characters, of the buffer used to hold the fraction of a second
+ * in time stamps (up to nanoseconds, e.g. `.123456789`).
+ */
 # if !defined(SIR_MAXMSEC)
-#  define SIR_MAXMSEC 5
+#  define SIR_MAXMSEC 11
 # endif
 
 /** The size, in characters, of the buffer used to hold level format strings. */
@@ -430,7 +542,7 @@
 
 /** The maximum size, in characters, of final formatted output. */
 # define SIR_MAXOUTPUT \
-    (SIR_MAXMESSAGE + (SIR_MAXSTYLE * 2) + SIR_MAXTIME + SIR_MAXLEVEL + \
+    (SIR_MAXMESSAGE + (SIR_MAXSTYLE * 2) + SIR_MAXTIME + SIR_MAXMSEC + SIR_MAXLEVEL + \
         SIR_MAXNAME + (SIR_MAXPID   * 2) + SIR_MAXMISC + 2 + 1)
 
 /** The maximum size, in characters, of an error message. */
@@ -519,6 +631,56 @@
 #  define SIR_FILE_CHK_SIZE_WRITES 10
 # endif
 
+/**
+ * The size, in bytes, of the buffer used to batch output to stdout and stderr
+ * when they are not connected to a terminal. Buffered output is written when
+ * the buffer would otherwise overflow, when a level in ::SIR_CONSOLE_FLUSH_LEVELS
+ * is logged, and every ::SIR_TICKER_INTERVAL milliseconds.
+ */
+# if !defined(SIR_CONSOLE_BUFSIZE)
+#  if !defined(SIR_EMBEDDED)
+#   define SIR_CONSOLE_BUFSIZE 65536
+#  else
+#   define SIR_CONSOLE_BUFSIZE 4096
+#  endif
+# endif
+
+/**
+ * The ::sir_level flags which cause batched console output to be written
+ * immediately, along with the message being logged.
+ */
+# if !defined(SIR_CONSOLE_FLUSH_LEVELS)
+#  define SIR_CONSOLE_FLUSH_LEVELS (SIRL_EMERG | SIRL_ALERT | SIRL_CRIT | SIRL_ERROR)
+# endif
+
+/**
+ * The number of milliseconds between wakeups of the background ticker thread,
+ * which writes any batched console output and queued system logger messages
+ * that are waiting, recalibrates the time stamp counter (see ::SIRTS_TSC), and
+ * reports messages suppressed by rate limits (see ::sir_loglimit).
+ */
+# if !defined(SIR_TICKER_INTERVAL)
+#  define SIR_TICKER_INTERVAL 100
+# endif
+
+/**
+ * The number of microseconds spent measuring the rate of the CPU's time stamp
+ * counter during ::sir_init, when ::SIRTS_TSC is in use. The rate is refined
+ * on every tick of the ticker thread thereafter.
+ */
+# if !defined(SIR_TSC_CALIBRATION_USEC)
+#  define SIR_TSC_CALIBRATION_USEC 2000
+# endif
+
+/**
+ * The number of milliseconds between updates of the time published by the
+ * ticker thread, when ::SIRTS_CACHED is in use (the ticker wakes this often,
+ * rather than every ::SIR_TICKER_INTERVAL milliseconds).
+ */
+# if !defined(SIR_CLOCK_CACHE_INTERVAL)
+#  define SIR_CLOCK_CACHE_INTERVAL 1
+# endif
+
 # if defined(SIR_OS_LOG_ENABLED)
 /**
  * The special format specifier to send to os_log. By default, the log will only
@@ -530,6 +692,65 @@
 #  endif
 # endif
 
+/**
+ * The maximum number of RFC 5424 messages that are queued before being sent to
+ * the system logger in one batch, when ::sir_syslogaddr is in use. Messages
+ * are also sent every ::SIR_TICKER_INTERVAL milliseconds, and immediately when
+ * a level in ::SIR_NETSYSLOG_FLUSH_LEVELS is logged.
+ */
+# if !defined(SIR_NETSYSLOG_BATCH)
+#  define SIR_NETSYSLOG_BATCH 32
+# endif
+
+/** The maximum size, in bytes, of one RFC 5424 message (longer ones are truncated). */
+# if !defined(SIR_NETSYSLOG_MAXFRAME)
+#  define SIR_NETSYSLOG_MAXFRAME (SIR_MAXMESSAGE + 1024)
+# endif
+
+/**
+ * The ::sir_level flags which cause queued RFC 5424 messages to be sent
+ * immediately, along with the message being logged.
+ */
+# if !defined(SIR_NETSYSLOG_FLUSH_LEVELS)
+#  define SIR_NETSYSLOG_FLUSH_LEVELS (SIRL_EMERG | SIRL_ALERT | SIRL_CRIT | SIRL_ERROR)
+# endif
+
+/** The syslog facility used in RFC 5424 messages (1 = user-level). */
+# if !defined(SIR_NETSYSLOG_FACILITY)
+#  define SIR_NETSYSLOG_FACILITY 1
+# endif
+
+/**
+ * The number of milliseconds the ticker thread waits before trying to reconnect
+ * to the system logger after the receiver goes away (e.g., it was restarted).
+ * Doubled after each failed attempt, up to ::SIR_NETSYSLOG_BACKOFF_MAX.
+ */
+# if !defined(SIR_NETSYSLOG_BACKOFF_MIN)
+#  define SIR_NETSYSLOG_BACKOFF_MIN 250
+# endif
+
+/** The maximum number of milliseconds between attempts to reconnect to the
+ * system logger (see ::SIR_NETSYSLOG_BACKOFF_MIN). */
+# if !defined(SIR_NETSYSLOG_BACKOFF_MAX)
+#  define SIR_NETSYSLOG_BACKOFF_MAX 30000
+# endif
+
+/**
+ * The SD-ID of the structured data element included in RFC 5424 messages. The
+ * default uses the enterprise number reserved for documentation (RFC 5612).
+ */
+# if !defined(SIR_NETSYSLOG_SDID)
+#  define SIR_NETSYSLOG_SDID "sir@32473"
+# endif
+
+/**
+ * The path of the systemd journal's native protocol socket, used when the
+ * system logger address is `journal:` with no path (see ::sir_syslogaddr).
+ */
+# if !defined(SIR_JOURNAL_SOCKET)
+#  define SIR_JOURNAL_SOCKET "/run/systemd/journal/socket"
+# endif
+
 /**
  * The number of consecutive duplicate messages that will cause libsir to
  * squelch further identical messages, and instead log the message
@@ -556,4 +777,22 @@
 #  define SIR_SQUELCH_MSG_FORMAT "previous message repeated %zu times"
 # endif
 
+/**
+ * The minimum number of milliseconds between the ::SIR_LIMIT_MSG_FORMAT lines
+ * logged for a call site whose messages are being suppressed by its rate limit
+ * or sampling (see ::sir_loglimit).
+ */
+# if !defined(SIR_LIMIT_REPORT_INTERVAL)
+#  define SIR_LIMIT_REPORT_INTERVAL 10000
+# endif
+
+/**
+ * The message logged when a call site has suppressed messages by its rate limit
+ * or sampling, with their number, and the file and line of the call site (see
+ * ::sir_loglimit).
+ */
+# if !defined(SIR_LIMIT_MSG_FORMAT)
+#  define SIR_LIMIT_MSG_FORMAT "suppressed %" PRIu64 " message(s) from %s:%" PRIu32
+# endif
+
 #endif /* !_SIR_CONFIG_H_INCLUDED */
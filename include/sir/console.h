@@ -36,18 +36,44 @@
 # include "sir/helpers.h"
 
 # if !defined(__WIN__)
-bool _sir_write_stdio(FILE* stream, const char* message);
+extern sir_console_stream __sir_stdout;
+extern sir_console_stream __sir_stderr;
 
+/**
+ * Determines whether stdout and stderr are terminals, and (once per process)
+ * creates the mutexes which protect their output buffers.
+ */
+void _sir_initialize_stdio(void);
+
+/**
+ * Writes a formatted message to a console stream. If the stream is a terminal,
+ * or `level` is in ::SIR_CONSOLE_FLUSH_LEVELS, or the buffer would overflow,
+ * anything buffered is written along with the message; otherwise, the message
+ * is buffered until the next flush.
+ */
+bool _sir_write_stdio(sir_console_stream* stream, sir_level level,
+    const char* message, size_t len);
+
+static inline
+bool _sir_write_stdout(sir_level level, const char* message, size_t len) {
+    return _sir_write_stdio(&__sir_stdout, level, message, len);
+}
+
+static inline
+bool _sir_write_stderr(sir_level level, const char* message, size_t len) {
+    return _sir_write_stdio(&__sir_stderr, level, message, len);
+}
+
+/** Returns `true` if stdout output is batched (i.e., it is not a terminal). */
 static inline
-bool _sir_write_stdout(const char* message, size_t len) {
-    SIR_UNUSED(len);
-    return _sir_write_stdio(stdout, message);
+bool _sir_stdout_batched(void) {
+    return !__sir_stdout.tty;
 }
 
+/** Returns `true` if stderr output is batched (i.e., it is not a terminal). */
 static inline
-bool _sir_write_stderr(const char* message, size_t len) {
-    SIR_UNUSED(len);
-    return _sir_write_stdio(stderr, message);
+bool _sir_stderr_batched(void) {
+    return !__sir_stderr.tty;
 }
 # else /* __WIN__ */
 extern HANDLE __sir_stdout;
@@ -57,14 +83,29 @@ void _sir_initialize_stdio(void);
 bool _sir_write_stdio(HANDLE console, const char* message, size_t len);
 
 static inline
-bool _sir_write_stdout(const char* message, size_t len) {
+bool _sir_write_stdout(sir_level level, const char* message, size_t len) {
+    SIR_UNUSED(level);
     return _sir_write_stdio(__sir_stdout, message, len);
 }
 
 static inline
-bool _sir_write_stderr(const char* message, size_t len) {
+bool _sir_write_stderr(sir_level level, const char* message, size_t len) {
+    SIR_UNUSED(level);
     return _sir_write_stdio(__sir_stderr, message, len);
 }
+
+static inline
+bool _sir_stdout_batched(void) {
+    return false;
+}
+
+static inline
+bool _sir_stderr_batched(void) {
+    return false;
+}
 # endif /* !__WIN__ */
 
+/** Writes any batched console output immediately. */
+bool _sir_flush_stdio(void);
+
 #endif /* !_SIR_CONSOLE_H_INCLUDED */
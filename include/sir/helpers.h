@@ -57,6 +57,19 @@ extern "C" {
 # define _SIR_L_END() \
     va_end(args)
 
+/** Evil macros used for sir_ctx_ wrappers: selects `ctx` for the calling
+ * thread, so that the default API operates on it, and restores the previous one. */
+# define _SIR_CTX_START(ctx, ret) \
+    sir_context* prev = NULL; \
+    do { \
+        if (!_sir_validptr(ctx)) \
+            return ret; \
+        prev = _sir_ctx_use(ctx); \
+    } while (false)
+
+# define _SIR_CTX_END() \
+    (void)_sir_ctx_use(prev)
+
 /** Evil macros used to enter/leave locked sections. */
 # define _SIR_LOCK_SECTION(type, name, mid, ret) \
     type* name = _sir_locksection(mid); \
@@ -162,6 +175,27 @@ void _sir_setbitslow(uint32_t* flags, uint32_t set) {
         *flags &= ~set;
 }
 
+/**
+ * Returns the zero-based bit position of a single ::sir_level (e.g., SIRL_EMERG
+ * is 0, SIRL_DEBUG is 7), which is also its index in the per-level maps. If
+ * `level` is not exactly one of the SIRL_* values, returns SIR_NUMLEVELS.
+ */
+static inline
+size_t _sir_levelidx(sir_level level) {
+    if (0U == level || 0U != (level & (level - 1U)))
+        return SIR_NUMLEVELS;
+# if defined(__GNUC__)
+    size_t idx = (size_t)__builtin_ctz((unsigned int)level);
+# else
+    size_t idx = 0;
+    while (0U == (level & 1U)) {
+        level >>= 1;
+        idx++;
+    }
+# endif
+    return idx < SIR_NUMLEVELS ? idx : SIR_NUMLEVELS;
+}
+
 /** Effectively performs b &= expr without the linter warnings about using
  * bool as an operand for that operator. */
 # define _sir_eqland(b, expr) ((b) = (expr) && (b))
@@ -201,6 +235,9 @@ bool __sir_validupdatedata(const sir_update_config_data* data, const char* func,
 # define _sir_validupdatedata(data) \
     __sir_validupdatedata(data, __func__, __file__, __LINE__)
 
+/** Validates a ::sir_time_opts structure. */
+bool _sir_validtimeopts(const sir_time_opts* opts);
+
 /** Validates a set of ::sir_level flags. */
 bool __sir_validlevels(sir_levels levels, const char* func, const char* file,
     uint32_t line);
@@ -408,6 +445,41 @@ struct tm* _sir_localtime(const time_t* timer, struct tm* buf) {
 # endif
 }
 
+/**
+ * Wrapper for gmtime[_s,_r]; the UTC counterpart of ::_sir_localtime.
+ */
+static inline
+struct tm* _sir_gmtime(const time_t* timer, struct tm* buf) {
+    if (!timer || !buf)
+        return NULL;
+# if defined(__HAVE_STDC_SECURE_OR_EXT1__) && !defined(__EMBARCADEROC__)
+#  if !defined(__WIN__)
+    struct tm* ret = gmtime_s(timer, buf);
+    if (!ret) {
+        (void)_sir_handleerr(errno);
+        return NULL;
+    }
+#  else /* __WIN__ */
+    errno_t ret = gmtime_s(buf, timer);
+    if (0 != ret) {
+        (void)_sir_handleerr(ret);
+        return NULL;
+    }
+#  endif
+    return buf;
+# else /* !__HAVE_STDC_SECURE_OR_EXT1__ */
+#  if !defined(__WIN__) || \
+     (defined(__EMBARCADEROC__) && (__clang_major__ < 15))
+    struct tm* ret = gmtime_r(timer, buf);
+#  else
+    struct tm* ret = gmtime(timer);
+#  endif
+    if (!ret)
+        (void)_sir_handleerr(errno);
+    return ret;
+# endif
+}
+
 /** Formats the current time as a string. */
 # if defined(__GNUC__)
 __attribute__ ((format (strftime, 3, 0)))
@@ -509,6 +581,37 @@ char* _sir_strreplace(char *str, const char c, const char n);
  */
 size_t _sir_strcreplace(char *str, const char c, const char n, int32_t max);
 
+/**
+ * Copies `len` bytes of "src" to "dst" as the contents of a JSON string,
+ * escaping quotes, backslashes, and control characters in a single pass.
+ * Writes at most `size - 1` bytes, never splitting an escape sequence or a
+ * UTF-8 character, and NUL-terminates. Returns the number of bytes written.
+ */
+size_t _sir_json_escape(char* restrict dst, size_t size, const char* restrict src,
+    size_t len);
+
+/** The size, in characters, of a buffer large enough for any non-string
+ * ::sir_kv_value (see ::_sir_kv_tostr). */
+# define SIR_MAXKVNUM 32
+
+/**
+ * Returns the text of a ::sir_kv_value and stores its length in "len". Strings
+ * are returned as-is; other types are formatted into "num".
+ */
+const char* _sir_kv_tostr(const sir_kv_value* value, char num[SIR_MAXKVNUM], size_t* len);
+
+/**
+ * Appends " key=value" logfmt pairs for "count" fields to "dst" (of `size`
+ * bytes), quoting and escaping values as needed. A field is left out if its
+ * key won't fit; values are cut short. NUL-terminates, and returns the number
+ * of bytes written.
+ */
+size_t _sir_logfmt_fields(char* restrict dst, size_t size, const sir_kv* restrict fields,
+    size_t count);
+
+/** Continues the FNV-1a hash "hash" over the keys and values of "count" fields. */
+uint64_t _sir_kv_hash(uint64_t hash, const sir_kv* fields, size_t count);
+
 # if defined(__cplusplus)
 }
 # endif
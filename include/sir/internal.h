@@ -53,6 +53,21 @@ bool _sir_init(sirinit* si);
 /** Un-initializes libsir. */
 bool _sir_cleanup(void);
 
+/** Allocates and initializes a context. */
+sir_context* _sir_ctx_init(sirinit* si);
+
+/** Un-initializes and frees a context. */
+bool _sir_ctx_cleanup(sir_context* ctx);
+
+/** Sets the context used by the calling thread (NULL for the default context);
+ * returns the one that was in use. */
+sir_context* _sir_ctx_use(sir_context* ctx);
+
+/** Logs a message using the given context. */
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_ctx_logv(sir_context* ctx, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args);
+
 /** Evaluates whether or not libsir has been initialized. */
 bool _sir_isinitialized(void);
 
@@ -92,6 +107,12 @@ bool _sir_syslogid(sirinit* si, const sir_update_config_data* data);
 /** Updates the category for the system logger. */
 bool _sir_syslogcat(sirinit* si, const sir_update_config_data* data);
 
+/** Updates the address for the system logger. */
+bool _sir_syslogaddr(sirinit* si, const sir_update_config_data* data);
+
+/** Updates the time stamp settings. */
+bool _sir_settime(sirinit* si, const sir_update_config_data* data);
+
 /** Callback for updating values in the global config. */
 typedef bool (*sirinit_update)(sirinit*, const sir_update_config_data*);
 
@@ -107,6 +128,12 @@ void _sir_unlocksection(sir_mutex_id mid);
 /** Maps a ::sir_mutex_id to a ::sir_mutex and protected section. */
 bool _sir_mapmutexid(sir_mutex_id mid, sir_mutex** m, void** section);
 
+/** Copies the contention counters for a section (SIR_LOCK_PROFILE builds). */
+bool _sir_getlockstats(sir_mutex_id mid, sir_lock_stats* stats);
+
+/** Zeroes the contention counters for every section. */
+bool _sir_resetlockstats(void);
+
 # if !defined(__WIN__)
 /** Static initialization procedure. */
 void _sir_init_static_once(void);
@@ -125,6 +152,30 @@ bool _sir_once(sir_once* once, sir_once_fn func);
 PRINTF_FORMAT_ATTR(2, 0)
 bool _sir_logv(sir_level level, PRINTF_FORMAT const char* format, va_list args);
 
+/** Core output formatting, with the source location of the call (may be NULL). */
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_logv_at(const sir_callsite* cs, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args);
+
+/** Core output for ::sir_logkv: `args` holds the key/value pairs that follow
+ * `message`. */
+bool _sir_logkv(const sir_callsite* cs, sir_level level, const char* message, va_list args);
+
+/** Replaces the category rules with those in `spec` (see ::sir_setcategories). */
+bool _sir_setcategories(const char* spec);
+
+/** Core output for ::sir_logcat: logs via ::_sir_logv if the rules for the
+ * category of `site` let `level` through. */
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_logcatv(sir_catsite* site, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args);
+
+/** Core output for ::sir_loglimit: logs via ::_sir_logv if the rate limit or
+ * sampling of `site` lets the message through. */
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_loglimitv(sir_limitsite* site, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args);
+
 /** Output dispatching. */
 bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf);
 
@@ -173,6 +224,29 @@ const char* _sir_formattedlevelstr(sir_level level);
 /** Retrieves the current time w/ optional milliseconds. */
 bool _sir_clock_gettime(int clock, time_t* tbuf, long* msecbuf);
 
+/** Retrieves the current time w/ optional nanoseconds. */
+bool _sir_clock_gettimens(int clock, time_t* tbuf, long* nsecbuf);
+
+/**
+ * Refreshes the calibration of the time stamp counter, if it is in use. Called
+ * periodically by the ticker thread.
+ */
+bool _sir_tsc_recalibrate(void);
+
+/**
+ * Logs the summaries of the messages suppressed by rate-limited call sites
+ * which are due, and have not been reported by a later call. Called
+ * periodically by the ticker thread.
+ */
+bool _sir_limit_flush(void);
+
+/**
+ * Logs the summaries of the messages suppressed by rate-limited call sites
+ * whose last suppressed message was logged to `ctx` (which must be the calling
+ * thread's), if they are due, or `force` is true.
+ */
+void _sir_limit_flush_ctx(sir_context* ctx, bool force);
+
 /**
  * Returns the number of milliseconds elapsed since a point in time represented
  * by the when parameter.
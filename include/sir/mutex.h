@@ -40,6 +40,10 @@ bool _sir_mutexcreate(sir_mutex* mutex);
 /** Attempts to lock a mutex and waits indefinitely. */
 bool _sir_mutexlock(sir_mutex* mutex);
 
+/** Like _sir_mutexlock, but also reports whether the mutex was held by another
+ * thread, so that the caller had to wait for it. */
+bool _sir_mutexlock_waited(sir_mutex* mutex, bool* waited);
+
 /** Determines if a mutex is locked without waiting. */
 bool _sir_mutextrylock(sir_mutex* mutex);
 
@@ -49,4 +53,16 @@ bool _sir_mutexunlock(sir_mutex* mutex);
 /** Destroys a mutex. */
 bool _sir_mutexdestroy(sir_mutex* mutex);
 
+# if defined(SIR_ADAPTIVE_MUTEX)
+/** Returns the calling thread's ID, as recorded in the `owner` of a mutex. */
+pid_t _sir_mutexself(void);
+
+/** Sleeps until `*addr` is woken, if it still equals `val`, or until `abstime`
+ * (CLOCK_REALTIME) passes. Returns zero or an errno value. */
+int _sir_futexwait(int* addr, int val, const sir_wait* abstime);
+
+/** Wakes up to `count` threads sleeping on `addr`. */
+void _sir_futexwake(int* addr, int count);
+# endif
+
 #endif /* !_SIR_MUTEX_H_INCLUDED */
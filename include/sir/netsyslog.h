@@ -0,0 +1,76 @@
+/*
+ * netsyslog.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_NETSYSLOG_H_INCLUDED
+# define _SIR_NETSYSLOG_H_INCLUDED
+
+# include "sir/types.h"
+
+/**
+ * Validates a system logger address. Accepted forms are `unix:/path/to/socket`
+ * (a Unix domain datagram socket), `udp:host:port` (IPv6 hosts in brackets),
+ * and, on Linux, `journal:[/path/to/socket]` (the systemd journal).
+ */
+bool _sir_netsyslog_validaddr(const char* address);
+
+/**
+ * Checks whether the transport could be opened to `address`: it is shared by
+ * every context, and may not be moved while another context is using it.
+ * `owner` is whether the caller is currently one of its users.
+ */
+bool _sir_netsyslog_canopen(const char* address, bool owner);
+
+/** Opens a non-blocking socket to the address in `ctx`, or shares the one
+ * already open to the same address. Fails if another context has it open to a
+ * different address. */
+bool _sir_netsyslog_open(const sir_syslog_dest* ctx);
+
+/**
+ * Formats an RFC 5424 message and queues it, or sends a journal record
+ * immediately. The queue is sent with as few
+ * system calls as possible when it fills up, when `level` is in
+ * ::SIR_NETSYSLOG_FLUSH_LEVELS, or when the ticker thread calls
+ * ::_sir_netsyslog_flush.
+ */
+bool _sir_netsyslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest* ctx);
+
+/** Sends any queued messages. Messages which cannot be sent without blocking
+ * are dropped and counted. */
+bool _sir_netsyslog_flush(void);
+
+/** Sends any queued messages, then closes the socket. */
+bool _sir_netsyslog_close(void);
+
+/** Retrieves the message counters. */
+bool _sir_netsyslog_getstats(sir_syslog_stats* stats);
+
+#endif /* !_SIR_NETSYSLOG_H_INCLUDED */
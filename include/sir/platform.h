@@ -89,6 +89,14 @@
 #  define SANITIZE_SUPPRESS(str)
 # endif
 
+# undef SENTINEL_ATTR
+# if HAS_ATTRIBUTE(sentinel)
+#  define SENTINEL_ATTR __attribute__((sentinel))
+# endif
+# if !defined(SENTINEL_ATTR)
+#  define SENTINEL_ATTR
+# endif
+
 # if HAS_FEATURE(safe_stack) && !defined(SIR_NO_PLUGINS)
 #  error "linking DSOs with SafeStack is unsupported; disable SafeStack or enable SIR_NO_PLUGINS"
 # endif
@@ -450,6 +458,15 @@ _set_thread_local_invalid_parameter_handler(
 #  undef SIR_SYSLOG_ENABLED
 # endif
 
+# if !defined(SIR_NO_SYSTEM_LOGGERS) && !defined(__WIN__) && !defined(SIR_EMBEDDED)
+#  undef SIR_NETSYSLOG_ENABLED
+#  define SIR_NETSYSLOG_ENABLED
+#  if defined(__linux__)
+#   undef SIR_JOURNAL_ENABLED
+#   define SIR_JOURNAL_ENABLED
+#  endif
+# endif
+
 
 # if !defined(__WIN__)
 #  if !defined(SIR_NO_PLUGINS)
@@ -488,10 +505,21 @@ _set_thread_local_invalid_parameter_handler(
       !defined(__managarm__) && !defined(SIR_EMBEDDED)
 #   include <sys/syscall.h>
 #  endif
+#  if defined(__linux__)
+#   include <sys/resource.h>
+#  endif
+#  if defined(SIR_ADAPTIVE_MUTEX)
+#   if !defined(__linux__) || !(defined(__GNUC__) || defined(__clang__))
+#    undef SIR_ADAPTIVE_MUTEX
+#   else
+#    include <linux/futex.h>
+#   endif
+#  endif
 #  if defined(__QNX__)
 #   include <sys/syspage.h>
 #  endif
 #  include <sys/time.h>
+#  include <sys/uio.h>
 #  include <strings.h>
 #  include <termios.h>
 #  include <limits.h>
@@ -504,6 +532,14 @@ _set_thread_local_invalid_parameter_handler(
 #    include <syslog.h>
 #   endif
 #  endif
+#  if defined(SIR_NETSYSLOG_ENABLED)
+#   include <sys/socket.h>
+#   include <sys/un.h>
+#   include <netdb.h>
+#  endif
+#  if defined(SIR_JOURNAL_ENABLED)
+#   include <sys/mman.h>
+#  endif
 #  if defined(__CYGWIN__)
 #   undef SIR_NO_THREAD_NAMES
 #   define SIR_NO_THREAD_NAMES
@@ -590,6 +626,9 @@ _set_thread_local_invalid_parameter_handler(
 #   define SIR_WALLCLOCK CLOCK_REALTIME
 #  endif
 
+/** The clock used to obtain timestamps with more than millisecond precision. */
+#  define SIR_PRECISECLOCK CLOCK_REALTIME
+
 /** The clock used to measure intervals. */
 #  if defined(CLOCK_UPTIME)
 #   define SIR_INTERVALCLOCK CLOCK_UPTIME
@@ -610,14 +649,30 @@ typedef void* sir_pluginhandle;
 /** The plugin export address type. */
 typedef void (*sir_pluginexport)(void);
 
+#  if defined(SIR_ADAPTIVE_MUTEX)
+/** The mutex type: spins briefly, then waits on a futex (see sirmutex.c). */
+typedef struct {
+    int state;      /**< 0 = unlocked, 1 = locked, 2 = locked, with waiters. */
+    pid_t owner;    /**< Thread ID of the owner, if locked. */
+    unsigned depth; /**< The number of times the owner has locked it. */
+} sir_mutex;
+#  else
 /** The mutex type. */
 typedef pthread_mutex_t sir_mutex;
+#  endif
 
 /** The thread type. */
 typedef pthread_t sir_thread;
 
+#  if defined(SIR_ADAPTIVE_MUTEX)
+/** The condition variable type: a futex sequence counter. */
+typedef struct {
+    int seq; /**< Incremented by each signal/broadcast. */
+} sir_condition;
+#  else
 /** The condition variable type. */
 typedef pthread_cond_t sir_condition;
+#  endif
 
 /** The mutex/condition variable wait time type. */
 typedef struct timespec sir_wait;
@@ -632,7 +687,11 @@ typedef void (*sir_once_fn)(void);
 #  define SIR_ONCE_INIT PTHREAD_ONCE_INIT
 
 /** The mutex initializer. */
-#  define SIR_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#  if defined(SIR_ADAPTIVE_MUTEX)
+#   define SIR_MUTEX_INIT {0, 0, 0U}
+#  else
+#   define SIR_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#  endif
 
 # else /* __WIN__ */
 
@@ -643,6 +702,7 @@ typedef void (*sir_once_fn)(void);
 #  define SIR_MSEC_TIMER
 #  define SIR_MSEC_WIN32
 #  define SIR_WALLCLOCK 0
+#  define SIR_PRECISECLOCK 0
 #  define SIR_INTERVALCLOCK 1
 
 /** The plugin handle type. */
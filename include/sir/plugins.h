@@ -36,6 +36,25 @@
 
 typedef bool (*sir_plugin_pred)(const void*, const sir_plugin*);
 
+# if !defined(SIR_NO_PLUGINS) && defined(__HAVE_ATOMIC_H__)
+/**
+ * Plugins are dispatched to without taking the SIRMI_PLUGINCACHE mutex, so that
+ * a slow load or unload does not hold up logging. Dispatch registers in the
+ * current epoch, then uses the published list; when a new list is published,
+ * the epoch is advanced, and the publisher waits for those registered in the
+ * previous epoch to leave before the old list (and any plugins removed from it)
+ * may be reused or destroyed. Each context has one of these.
+ */
+typedef struct {
+    _Atomic(const sir_pluginlist*) current;
+    atomic_uint_fast32_t epoch;
+    atomic_size_t readers[2];
+} sir_plugin_dispatch;
+
+/** Returns the dispatch state of the plugin cache of the current context. */
+sir_plugin_dispatch* _sir_plugin_dispatchstate(void);
+# endif
+
 sirpluginid _sir_plugin_load(const char* path);
 sirpluginid _sir_plugin_probe(sir_plugin* plugin);
 sir_pluginexport _sir_plugin_getexport(sir_pluginhandle handle, const char* name);
@@ -45,14 +64,24 @@ sirpluginid _sir_plugin_add(sir_plugin* plugin);
 bool _sir_plugin_rem(sirpluginid id);
 void _sir_plugin_destroy(sir_plugin** plugin);
 
+/** Dispatches a message to the loaded plugins without taking the SIRMI_PLUGINCACHE
+ * mutex (if atomics are available). */
+bool _sir_plugin_dispatch(sir_level level, sirbuf* buf, size_t* dispatched, size_t* wanted);
+
+/** Sets the overflow policy of a loaded plugin's queue. */
+bool _sir_plugin_setpolicy(sirpluginid id, sir_plugin_overflow policy);
+
+/** Retrieves the counters of a loaded plugin's queue. */
+bool _sir_plugin_getstats(sirpluginid id, sir_plugin_stats* stats);
+
 bool _sir_plugin_cache_pred_id(const void* match, const sir_plugin* iter);
 
 sirpluginid _sir_plugin_cache_add(sir_plugincache* spc, sir_plugin* plugin);
 sir_plugin* _sir_plugin_cache_find_id(const sir_plugincache* spc, sirpluginid id);
 sir_plugin* _sir_plugin_cache_find(const sir_plugincache* spc, const void* match, sir_plugin_pred pred);
-bool _sir_plugin_cache_rem(sir_plugincache* spc, sirpluginid id);
+bool _sir_plugin_cache_rem(sir_plugincache* spc, sirpluginid id, sir_plugin** removed);
 bool _sir_plugin_cache_destroy(sir_plugincache* spc);
-bool _sir_plugin_cache_dispatch(const sir_plugincache* spc, sir_level level, sirbuf* buf,
+bool _sir_plugin_cache_dispatch(const sir_pluginlist* spl, sir_level level, sirbuf* buf,
     size_t* dispatched, size_t* wanted);
 
 #endif /* !_SIR_PLUGINS_H_INCLUDED */
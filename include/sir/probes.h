@@ -0,0 +1,78 @@
+/*
+ * probes.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_PROBES_H_INCLUDED
+# define _SIR_PROBES_H_INCLUDED
+
+/**
+ * USDT (SystemTap/DTrace-style) static probes in the logging pipeline, built
+ * when `SIR_USDT` is defined. Each probe compiles to a single nop and a note in
+ * the ELF file; tools like bpftrace or perf attach to them by name at runtime,
+ * e.g.:
+ *
+ *     bpftrace -e 'usdt:./libsir.so:libsir:write__done { @[arg0] = count(); }'
+ *
+ * The provider is `libsir`. `dest` is a ::sir_stats_dest, and `id` is the
+ * file or plugin ID for ::SIRSD_FILE and ::SIRSD_PLUGIN (zero otherwise).
+ *
+ * | Probe             | Arguments                      | Fired                           |
+ * | :---------------- | :----------------------------- | :------------------------------ |
+ * | `logv__entry`     | level, format                  | on entry to _sir_logv_at        |
+ * | `logv__formatted` | level, message                 | once the message is formatted   |
+ * | `write__start`    | dest, id, level                | before writing to a destination |
+ * | `write__done`     | dest, id, ok, bytes            | after writing to a destination  |
+ * | `roll__start`     | id, path                       | before a log file is rolled     |
+ * | `roll__done`      | id, path, ok                   | after a log file is rolled      |
+ *
+ * For plugins, the write probes surround queueing the message; delivery happens
+ * later on the plugin's own thread.
+ */
+# if defined(SIR_USDT)
+#  if defined(__has_include)
+#   if !__has_include(<sys/sdt.h>)
+#    error "SIR_USDT requires <sys/sdt.h> (e.g., systemtap-sdt-dev or systemtap-sdt-devel)"
+#   endif
+#  endif
+#  include <sys/sdt.h>
+#  define _SIR_PROBE2(name, a1, a2) \
+    DTRACE_PROBE2(libsir, name, a1, a2)
+#  define _SIR_PROBE3(name, a1, a2, a3) \
+    DTRACE_PROBE3(libsir, name, a1, a2, a3)
+#  define _SIR_PROBE4(name, a1, a2, a3, a4) \
+    DTRACE_PROBE4(libsir, name, a1, a2, a3, a4)
+# else
+#  define _SIR_PROBE2(name, a1, a2)
+#  define _SIR_PROBE3(name, a1, a2, a3)
+#  define _SIR_PROBE4(name, a1, a2, a3, a4)
+# endif
+
+#endif /* !_SIR_PROBES_H_INCLUDED */
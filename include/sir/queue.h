@@ -34,29 +34,29 @@
 
 # include "sir/types.h"
 
-/** Creates a sir_queue_node and sets its data property. */
-sir_queue_node* _sir_queue_node_create(void* data);
+/** Creates an empty sir_queue that can hold up to `capacity` items (rounded up
+ * to a power of two). */
+bool _sir_queue_create(sir_queue** q, size_t capacity);
 
-/** Deletes a previously created sir_queue_node and optionally returns its
- * data. */
-bool _sir_queue_node_destroy(sir_queue_node** node, void** data);
-
-/** Creates an empty sir_queue. */
-bool _sir_queue_create(sir_queue** q);
-
-/** Destroys a sir_queue (empty or otherwise). */
+/** Destroys a sir_queue (empty or otherwise), freeing the data of any items
+ * still in it. Must not be in use by any other thread. */
 bool _sir_queue_destroy(sir_queue** q);
 
-/** Returns the number of nodes in a queue. */
-size_t _sir_queue_size(sir_queue* q);
+/** Returns the number of items in a queue. If other threads are pushing or
+ * popping, this is only a snapshot. */
+size_t _sir_queue_size(const sir_queue* q);
+
+/** Returns the maximum number of items a queue can hold. */
+size_t _sir_queue_capacity(const sir_queue* q);
 
-/** `true` if the queue contains zero nodes, `false` otherwise. */
+/** `true` if the queue contains zero items, `false` otherwise. If other threads
+ * are pushing or popping, this is only a snapshot. */
 bool _sir_queue_isempty(const sir_queue* q);
 
-/** Pushes a new node onto the back of a queue. */
+/** Pushes an item onto the back of a queue. Fails if the queue is full. */
 bool _sir_queue_push(sir_queue* q, void* data);
 
-/** Pops a node off the front of a queue, if one is available. */
+/** Pops an item off the front of a queue, if one is available. */
 bool _sir_queue_pop(sir_queue* q, void** data);
 
 #endif /* !_SIR_QUEUE_H_INCLUDED */
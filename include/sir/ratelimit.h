@@ -0,0 +1,65 @@
+/*
+ * ratelimit.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_RATELIMIT_H_INCLUDED
+# define _SIR_RATELIMIT_H_INCLUDED
+
+# include "sir/types.h"
+
+/**
+ * Decides, without taking any locks, whether a call to `site` lets its message
+ * through: one in `site->sample` calls is chosen, then subjected to the rate
+ * limit.
+ */
+bool _sir_limit_admit(sir_limitsite* site);
+
+/**
+ * Counts a message that `site` did not let through, remembering its level and
+ * context for the summary. Returns true if this added `site` to the list of
+ * sites with messages to report.
+ */
+bool _sir_limit_suppress(sir_limitsite* site, sir_level level, sir_context* ctx);
+
+/**
+ * Returns (and resets) the number of messages suppressed by `site`, if it has
+ * not reported any in the last ::SIR_LIMIT_REPORT_INTERVAL msec, or `force` is
+ * true; otherwise, returns 0.
+ */
+uint64_t _sir_limit_collect(sir_limitsite* site, bool force);
+
+/** Returns the site after `site` in the list (or the first, if NULL). */
+sir_limitsite* _sir_limit_next(const sir_limitsite* site);
+
+/** Empties the list; only when no thread is logging. */
+void _sir_limit_forget(void);
+
+#endif /* !_SIR_RATELIMIT_H_INCLUDED */
@@ -0,0 +1,108 @@
+/*
+ * stats.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_STATS_H_INCLUDED
+# define _SIR_STATS_H_INCLUDED
+
+# include "sir/types.h"
+
+# if !defined(SIR_NO_STATS) && !defined(__HAVE_ATOMIC_H__)
+#  define SIR_NO_STATS
+# endif
+
+/** The destinations that ::sir_getstats keeps counters for. */
+typedef enum {
+    SIRSD_STDOUT = 0,
+    SIRSD_STDERR,
+    SIRSD_SYSLOG,
+    SIRSD_FILE,
+    SIRSD_PLUGIN
+} sir_stats_dest;
+
+# if !defined(SIR_NO_STATS) && defined(SIR_STATS_LATENCY)
+/** Returns a monotonic timestamp in nanoseconds, for measuring latency. */
+uint64_t _sir_stats_clock(void);
+
+/** Records how long (since `start`, from ::_sir_stats_clock) a message took
+ * to log. */
+void _sir_stats_logv(uint64_t start);
+# else
+/* the latency histograms cost two clock reads per message and per
+ * destination, so they are only kept when asked for. */
+#  define _sir_stats_clock() 0ULL
+#  define _sir_stats_logv(start) SIR_UNUSED(start)
+# endif
+
+# if !defined(SIR_NO_STATS)
+/** Zeroes every counter (called by sir_init). */
+void _sir_stats_reset(void);
+
+/** Counts a message logged at `level`. */
+void _sir_stats_message(sir_level level);
+
+/** Counts a message suppressed as a repeat. */
+void _sir_stats_squelched(void);
+
+/** Counts a message suppressed by a rate limit or sampling. */
+void _sir_stats_limited(void);
+
+/** Counts a message with no destination. */
+void _sir_stats_nodest(void);
+
+/** Starts keeping counters for a log file or plugin. Must hold the lock for
+ * the file or plugin cache. */
+void _sir_stats_add(sir_stats_dest dest, uint32_t id);
+
+/** Stops keeping counters for a log file or plugin. */
+void _sir_stats_rem(sir_stats_dest dest, uint32_t id);
+
+/** Records a write of `lines` lines and `bytes` bytes to a destination (`id`
+ * is that of the file or plugin, if either) that began at `start` (ignored
+ * unless `SIR_STATS_LATENCY` is defined). */
+void _sir_stats_write(sir_stats_dest dest, uint32_t id, bool ok, size_t lines,
+    size_t bytes, uint64_t start);
+
+/** Adds up the counters from every thread. */
+bool _sir_stats_get(sir_stats* stats);
+# else
+#  define _sir_stats_reset() (void)0
+#  define _sir_stats_message(level) SIR_UNUSED(level)
+#  define _sir_stats_squelched()
+#  define _sir_stats_limited() (void)0
+#  define _sir_stats_nodest()
+#  define _sir_stats_add(dest, id) SIR_UNUSED(id)
+#  define _sir_stats_rem(dest, id) SIR_UNUSED(id)
+#  define _sir_stats_write(dest, id, ok, lines, bytes, start) \
+    do { SIR_UNUSED(lines); SIR_UNUSED(bytes); SIR_UNUSED(start); } while (false)
+# endif
+
+#endif /* !_SIR_STATS_H_INCLUDED */
@@ -36,8 +36,11 @@
 
 extern sir_text_style_data sir_text_style_section;
 
-/**  Returns the final string form of the current ::sir_textstyle for a ::sir_level. */
-const char* _sir_gettextstyle(sir_level level);
+/**
+ * Copies the final string form of the current ::sir_textstyle for a ::sir_level
+ * into `buf`. Does not take the SIRMI_TEXTSTYLE mutex if atomics are available.
+ */
+bool _sir_gettextstyle(sir_level level, char buf[SIR_MAXSTYLE]);
 
 /** Sets the ::sir_textstyle for a ::sir_level. */
 bool _sir_settextstyle(sir_level level, const sir_textstyle* style);
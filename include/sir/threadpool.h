@@ -37,8 +37,31 @@
 
 # define SIR_THREADPOOL_MAX_THREADS 386
 
-bool _sir_threadpool_create(sir_threadpool** pool, size_t num_threads);
-bool _sir_threadpool_add_job(sir_threadpool* pool, sir_threadpool_job* job);
+/** The size of a pool thread's name, including the terminator. Most platforms
+ * allow no more than 15 characters. */
+# define SIR_THREADPOOL_MAXNAME 16
+
+/** The prefix of a pool thread's name if ::sir_threadpool_config doesn't have
+ * one. */
+# define SIR_THREADPOOL_NAME "sir_pool"
+
+/** Creates a thread pool as described by `config`; if NULL, or for any member
+ * that is zero, the defaults apply. Fails with _SIR_E_UNAVAIL if CPU affinity
+ * or niceness is requested and the platform doesn't support it. */
+bool _sir_threadpool_create(sir_threadpool** pool, const sir_threadpool_config* config);
+
+/** Returns the number of threads in `pool`. */
+size_t _sir_threadpool_numthreads(const sir_threadpool* pool);
+
+/** Queues `fn(data)` to run on one of the pool's threads. Fails with
+ * _SIR_E_NOROOM if SIR_THREADPOOL_QUEUE_SIZE jobs are already outstanding. */
+bool _sir_threadpool_add_job(sir_threadpool* pool, bool (*fn)(void*), void* data);
+
+/** Queues `count` jobs (copied from `jobs`) at once, waking no more threads
+ * than there are jobs. Either all of them are queued, or none are. */
+bool _sir_threadpool_add_jobs(sir_threadpool* pool, const sir_threadpool_job* jobs,
+    size_t count);
+
 bool _sir_threadpool_destroy(sir_threadpool** pool);
 
 #endif /* !_SIR_THREADPOOL_H_INCLUDED */
@@ -0,0 +1,53 @@
+/*
+ * ticker.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#ifndef _SIR_TICKER_H_INCLUDED
+# define _SIR_TICKER_H_INCLUDED
+
+# include "sir/types.h"
+
+/**
+ * Starts the background ticker thread, which wakes every ::SIR_TICKER_INTERVAL
+ * milliseconds to perform deferred work (e.g., flushing batched console output
+ * and recalibrating the time stamp counter), or every ::SIR_CLOCK_CACHE_INTERVAL
+ * milliseconds while publishing the time for ::SIRTS_CACHED.
+ * Does nothing if the ticker is already running.
+ */
+bool _sir_ticker_start(void);
+
+/** Stops the background ticker thread and waits for it to exit. */
+bool _sir_ticker_stop(void);
+
+/** Returns `true` if the background ticker thread is running. */
+bool _sir_ticker_running(void);
+
+#endif /* !_SIR_TICKER_H_INCLUDED */
@@ -79,13 +79,14 @@ typedef uint16_t sir_levels;
 
 # define SIRO_ALL     0x00000000U /**< Include all formatting and functionality. */
 # define SIRO_NOTIME  0x00000100U /**< Exclude time stamps (implies ::SIRO_NOMSEC). */
-# define SIRO_NOMSEC  0x00000200U /**< Exclude millisecond-resolution in time stamps. */
+# define SIRO_NOMSEC  0x00000200U /**< Exclude the fraction of a second in time stamps. */
 # define SIRO_NOHOST  0x00000400U /**< Exclude local hostname. */
 # define SIRO_NOLEVEL 0x00000800U /**< Exclude human-readable logging level. */
 # define SIRO_NONAME  0x00001000U /**< Exclude process/app name. */
 # define SIRO_NOPID   0x00002000U /**< Exclude process ID. */
 # define SIRO_NOTID   0x00004000U /**< Exclude thread ID/name. */
 # define SIRO_NOHDR   0x00010000U /**< Don't write header messages to log files. */
+# define SIRO_JSON    0x00020000U /**< Write each message as a JSON object, one per line (implies ::SIRO_NOHDR). */
 # define SIRO_MSGONLY 0x00007f00U /**< Sets all other options except ::SIRO_NOHDR. */
 # define SIRO_DEFAULT 0x00100000U /**< Default options for this type of destination. */
 
@@ -228,8 +229,171 @@ typedef struct {
      * @see ::sir_syslogcat
      */
     char category[SIR_MAX_SYSLOG_CAT];
+
+    /**
+     * If set, the address of a syslog receiver to send RFC 5424 messages to
+     * directly, instead of using the system logging facility.
+     * @see ::sir_syslogaddr
+     */
+    char address[SIR_MAX_SYSLOG_ADDR];
 } sir_syslog_dest;
 
+/**
+ * @struct sir_syslog_stats
+ * @brief Counters for messages sent to the system logger by the built-in
+ * (RFC 5424 or systemd journal) transport.
+ *
+ * @see ::sir_syslogstats
+ */
+typedef struct {
+    uint64_t sent;       /**< Messages successfully sent. */
+    uint64_t dropped;    /**< Messages dropped (e.g., the socket buffer was full). */
+    uint64_t batches;    /**< Number of batches sent. */
+    uint64_t reconnects; /**< Times the connection was reestablished after it was lost. */
+} sir_syslog_stats;
+
+/**
+ * @brief An independent instance of libsir, with its own configuration,
+ * destinations, plugins and locks.
+ *
+ * @see ::sir_ctx_init
+ */
+typedef struct sir_context sir_context;
+
+/**
+ * @struct sir_callsite
+ * @brief The source location of a logging call. Declared by ::SIR_LOGAT and
+ * passed to ::sir_logat.
+ */
+typedef struct {
+    const char* file; /**< Source file name (`__FILE__`). */
+    uint32_t line;    /**< Source line number (`__LINE__`). */
+    const char* func; /**< Function name (`__func__`). */
+} sir_callsite;
+
+/**
+ * @struct sir_catsite
+ * @brief A logging call in a named category. Declared by ::SIR_LOGCAT and
+ * passed to ::sir_logcat.
+ *
+ * Must have static storage duration: the decision of whether each level in the
+ * category is logged is cached in it, so that after the first call, the check
+ * is one comparison (until the rules are next changed by ::sir_setcategories).
+ */
+typedef struct {
+    const char* category;    /**< Category name (e.g., `"net.http"`). */
+    volatile uint32_t cache; /**< Cached decision (internal; initialize to 0). */
+} sir_catsite;
+
+/**
+ * @struct sir_limitsite
+ * @brief A rate-limited or sampled logging call. Declared by ::SIR_LOGLIMIT and
+ * ::SIR_LOGSAMPLE (or with ::SIR_LIMITSITE_INIT), and passed to ::sir_loglimit.
+ *
+ * Must have static storage duration: it holds the state of the limit for the
+ * call site, and once it has suppressed a message, libsir keeps track of it
+ * until cleaned up. Only the first five fields are meant to be set.
+ */
+typedef struct sir_limitsite {
+    uint32_t per_sec;             /**< Messages let through per second (0 for no limit). */
+    uint32_t burst;               /**< Messages that may be let through at once (0 for `per_sec`). */
+    uint32_t sample;              /**< Let through one in this many calls (0 or 1 for all). */
+    const char* file;             /**< Source file name, for the summary line. */
+    uint32_t line;                /**< Source line number, for the summary line. */
+    volatile int64_t tat;         /**< When the limit next lets a message through (internal). */
+    volatile int64_t reported;    /**< When suppressed messages were last reported (internal). */
+    volatile uint64_t calls;      /**< Calls, for sampling (internal). */
+    volatile uint64_t suppressed; /**< Messages suppressed since the last report (internal). */
+    volatile uint32_t level;      /**< Level of the last suppressed message (internal). */
+    volatile uint32_t listed;     /**< Whether the site is in the list to report (internal). */
+    sir_context* volatile ctx;    /**< Context of the last suppressed message (internal). */
+    struct sir_limitsite* volatile next; /**< Next site in the list to report (internal). */
+} sir_limitsite;
+
+/** The type of the value in a ::sir_kv field. */
+typedef enum {
+    SIRKV_STR = 1, /**< A NUL-terminated string (`const char*`). */
+    SIRKV_INT,     /**< A signed integer (`int64_t`). */
+    SIRKV_UINT,    /**< An unsigned integer (`uint64_t`). */
+    SIRKV_FLOAT,   /**< A floating-point number (`double`). */
+    SIRKV_BOOL     /**< A boolean (`bool`). */
+} sir_kv_type;
+
+/**
+ * @struct sir_kv_value
+ * @brief A typed value for a key/value field. Construct one with ::SIR_KV_STR,
+ * ::SIR_KV_INT, ::SIR_KV_UINT, ::SIR_KV_FLOAT, or ::SIR_KV_BOOL.
+ */
+typedef struct {
+    sir_kv_type type; /**< Which member of `v` is set. */
+    union {
+        const char* s;
+        int64_t i;
+        uint64_t u;
+        double f;
+        bool b;
+    } v;              /**< The value. */
+} sir_kv_value;
+
+/**
+ * @struct sir_kv
+ * @brief A key/value field attached to a message by ::sir_logkv.
+ */
+typedef struct {
+    const char* key;    /**< The name of the field. */
+    sir_kv_value value; /**< The value of the field. */
+} sir_kv;
+
+/** Time stamp formats. @see ::sir_settimeformat */
+typedef enum {
+    SIRTF_LOCAL = 0, /**< Local time, as ::SIR_TIMEFORMAT (e.g. `23:30:26.034`). */
+    SIRTF_UTC,       /**< UTC, as ::SIR_TIMEFORMAT. */
+    SIRTF_ISO8601,   /**< UTC date and time, as ISO 8601 (e.g. `2024-05-06T23:30:26.034Z`). */
+    SIRTF_EPOCH      /**< Seconds since the Unix epoch (e.g. `1715038226.034`). */
+} sir_time_format;
+
+/** The sub-second precision of time stamps. @see ::sir_settimeformat */
+typedef enum {
+    SIRTP_MSEC = 0, /**< Milliseconds (3 digits). */
+    SIRTP_USEC,     /**< Microseconds (6 digits). */
+    SIRTP_NSEC      /**< Nanoseconds (9 digits). */
+} sir_time_precision;
+
+/** Where time stamps come from. Only read by ::sir_init. */
+typedef enum {
+    SIRTS_DEFAULT = 0, /**< The coarse wall clock for milliseconds, otherwise the precise one. */
+    SIRTS_TSC,         /**< The CPU's time stamp counter, calibrated against the wall clock. */
+    SIRTS_PRECISE,     /**< The precise wall clock (e.g. `CLOCK_REALTIME`). */
+    SIRTS_COARSE,      /**< The coarse wall clock (e.g. `CLOCK_REALTIME_COARSE`). */
+    SIRTS_CACHED       /**< The time last published by the ticker thread. */
+} sir_time_source;
+
+/**
+ * @struct sir_time_opts
+ * @brief Time stamp settings, shared by all destinations.
+ *
+ * @see ::sir_settimeformat
+ */
+typedef struct {
+    sir_time_format format;       /**< The format of time stamps. */
+    sir_time_precision precision; /**< The precision of time stamps. */
+
+    /**
+     * The source of time stamps. ::SIRTS_TSC reads the CPU's time stamp counter
+     * (`rdtsc` on x86, `cntvct_el0` on ARM64) instead of calling into the OS,
+     * and converts it using a calibration that the ticker thread refreshes
+     * every ::SIR_TICKER_INTERVAL milliseconds. If the counter is unavailable
+     * or not invariant, the wall clock is used instead.
+     *
+     * ::SIRTS_COARSE is much cheaper than ::SIRTS_PRECISE, but only advances
+     * every few milliseconds. ::SIRTS_CACHED is cheaper still: the ticker thread
+     * reads the clock every ::SIR_CLOCK_CACHE_INTERVAL milliseconds, and loggers
+     * read an atomic variable. Neither is suitable for sub-millisecond time
+     * stamps.
+     */
+    sir_time_source source;
+} sir_time_opts;
+
 /**
  * @struct sirinit
  * @brief libsir initialization and configuration data.
@@ -251,6 +415,13 @@ typedef struct {
      * in a destination's options bitmask to suppress it.
      */
     char name[SIR_MAXNAME];
+
+    /**
+     * Time stamp format, precision and source. The defaults (all zeros) are
+     * local time with millisecond precision, from the wall clock. Set ::SIRO_NOTIME or ::SIRO_NOMSEC in a
+     * destination's options bitmask to suppress all or part of it.
+     */
+    sir_time_opts time;
 } sirinit;
 
 /**
@@ -269,6 +440,8 @@ typedef struct {
 # define SIRSL_IDENTITY 0x00000010U /**< Identity. */
 # define SIRSL_UPDATED  0x00000020U /**< Config has been updated. */
 # define SIRSL_IS_INIT  0x00000040U /**< Subsystem is initialized. */
+# define SIRSL_ADDRESS  0x00000080U /**< Address has been updated. */
+# define SIRSL_NATIVE   0x00000100U /**< Using the built-in RFC 5424 transport. */
 
 # if defined(__WIN__)
 /** Invalid parameter handler used when passing possibly invalid values to
@@ -287,6 +460,36 @@ typedef struct {
 # endif
 } sir_time;
 
+# if !defined(__WIN__)
+/** Internally-used state for batched output to stdout or stderr. */
+typedef struct {
+    FILE* file;       /**< The stdio stream (flushed before each write). */
+    int fd;           /**< The underlying file descriptor. */
+    bool tty;         /**< Whether or not `fd` is a terminal. */
+    size_t len;       /**< The number of bytes currently held in `buf`. */
+    sir_mutex mutex;  /**< Protects this structure. */
+    char buf[SIR_CONSOLE_BUFSIZE]; /**< Output awaiting the next flush. */
+} sir_console_stream;
+# endif
+
+/** Internally-used calibration of the CPU's time stamp counter. */
+typedef struct {
+    uint64_t ticks;       /**< Counter value when `sec` and `nsec` were read. */
+    time_t sec;           /**< Wall clock seconds at `ticks`. */
+    long nsec;            /**< Wall clock nanoseconds at `ticks`. */
+    uint64_t first_ticks; /**< Counter value at the first calibration. */
+    int64_t first_mono;   /**< Monotonic clock (nsec) at the first calibration. */
+    double nsec_per_tick; /**< Nanoseconds per counter tick. */
+    bool valid;           /**< Whether the counter is in use. */
+} sir_tsc_calib;
+
+/** Internally-used category rule (see ::sir_setcategories). An empty name is
+ * the default rule (`*`). */
+typedef struct {
+    char name[SIR_MAXCATEGORY];
+    sir_levels levels;
+} sir_category_rule;
+
 /** Internally-used global config container. */
 typedef struct {
     sirinit si;
@@ -295,7 +498,7 @@ typedef struct {
         time_t last_hname_chk;
         char pidbuf[SIR_MAXPID];
         pid_t pid;
-        char timestamp[SIR_MAXTIME];
+        sir_tsc_calib tsc;
 
         /** Spam squelch state data. */
         struct {
@@ -340,7 +543,14 @@ typedef struct {
 
 /** Plugin versioning. */
 # define SIR_PLUGIN_V1 1
-# define SIR_PLUGIN_VCURRENT SIR_PLUGIN_V1
+# define SIR_PLUGIN_V2 2
+# define SIR_PLUGIN_VCURRENT SIR_PLUGIN_V2
+
+/**
+ * Plugin capability (v2+): the plugin exports `sir_plugin_write_records`, and
+ * receives batches of ::sir_plugin_record instead of calls to `sir_plugin_write`.
+ */
+# define SIR_PLUGINCAP_RECORDS 0x0000000000000001ULL
 
 /** Plugin export names for v1. */
 # define SIR_PLUGIN_EXPORT_QUERY   "sir_plugin_query"
@@ -348,12 +558,59 @@ typedef struct {
 # define SIR_PLUGIN_EXPORT_WRITE   "sir_plugin_write"
 # define SIR_PLUGIN_EXPORT_CLEANUP "sir_plugin_cleanup"
 
+/** Plugin export names for v2. */
+# define SIR_PLUGIN_EXPORT_WRITERECS "sir_plugin_write_records"
+
+/**
+ * @struct sir_plugin_record
+ * @brief A structured log record, delivered to v2 plugins which have the
+ * ::SIR_PLUGINCAP_RECORDS capability.
+ *
+ * The strings are NUL-terminated, but their lengths are supplied so that they
+ * need not be measured. They are only valid for the duration of the call.
+ */
+typedef struct {
+    sir_level level;      /**< The level of the message. */
+    time_t time;          /**< Time of the call (seconds since the epoch). */
+    long msec;            /**< Milliseconds since `time`. */
+    pid_t tid;            /**< OS identifier of the calling thread. */
+    const char* message;  /**< The message, as formatted by the caller. */
+    size_t message_len;   /**< Length of `message`. */
+    const char* line;     /**< The full line, formatted using the plugin's options. */
+    size_t line_len;      /**< Length of `line`. */
+    const sir_kv* fields; /**< Key/value fields attached by ::sir_logkv, if any. */
+    size_t field_count;   /**< The number of entries in `fields`. */
+} sir_plugin_record;
+
 /** Plugin export typedefs for v1. */
 typedef bool (*sir_plugin_queryfn)(sir_plugininfo*);
 typedef bool (*sir_plugin_initfn)(void);
 typedef bool (*sir_plugin_writefn)(sir_level, const char*);
 typedef bool (*sir_plugin_cleanupfn)(void);
 
+/** Plugin queue overflow policies (see ::sir_pluginpolicy). */
+typedef enum {
+    SIRPO_DROP  = 0, /**< Discard the new message, and count it as dropped. */
+    SIRPO_BLOCK = 1  /**< Wait for the plugin's worker thread to make room. */
+} sir_plugin_overflow;
+
+/**
+ * @struct sir_plugin_stats
+ * @brief Counters for a plugin's queue (see ::sir_pluginstats).
+ */
+typedef struct {
+    uint64_t queued;            /**< Messages queued for the plugin. */
+    uint64_t delivered;         /**< Messages the plugin processed successfully. */
+    uint64_t failed;            /**< Messages the plugin failed to process. */
+    uint64_t dropped;           /**< Messages discarded because the queue was full. */
+    size_t depth;               /**< Messages currently waiting in the queue. */
+    double latency_avg_msec;    /**< Average time from queueing to delivery. */
+    double latency_max_msec;    /**< Longest time from queueing to delivery. */
+} sir_plugin_stats;
+
+/** Plugin export typedefs for v2. */
+typedef bool (*sir_plugin_writerecsfn)(const sir_plugin_record*, size_t);
+
 /** Plugin interface for v1. */
 typedef struct {
     sir_plugin_queryfn query;     /**< Address of sir_plugin_query. */
@@ -362,7 +619,46 @@ typedef struct {
     sir_plugin_cleanupfn cleanup; /**< Address of sir_plugin_cleanup. */
 } sir_pluginifacev1;
 
-typedef sir_pluginifacev1 sir_pluginiface;
+/** Plugin interface for v2 (a superset of v1). */
+typedef struct {
+    sir_plugin_queryfn query;     /**< Address of sir_plugin_query. */
+    sir_plugin_initfn init;       /**< Address of sir_plugin_init. */
+    sir_plugin_writefn write;     /**< Address of sir_plugin_write. */
+    sir_plugin_cleanupfn cleanup; /**< Address of sir_plugin_cleanup. */
+    sir_plugin_writerecsfn write_records; /**< Address of sir_plugin_write_records
+                                           * (only with ::SIR_PLUGINCAP_RECORDS). */
+} sir_pluginifacev2;
+
+typedef sir_pluginifacev2 sir_pluginiface;
+
+/** Records waiting to be delivered to a plugin, and the strings they point to. */
+typedef struct {
+    size_t count;
+    size_t used;
+    sir_plugin_record records[SIR_PLUGIN_QUEUE_SIZE];
+    sir_time queued[SIR_PLUGIN_QUEUE_SIZE];
+    size_t fields_used;
+    sir_kv fields[SIR_PLUGIN_QUEUE_FIELDS];
+    char data[SIR_PLUGIN_QUEUE_BYTES];
+} sir_plugin_batch;
+
+/**
+ * A plugin's bounded queue. Logging threads fill `front`; the plugin's worker
+ * thread swaps it with `back`, then delivers `back` without holding `mutex`.
+ */
+typedef struct {
+    sir_plugin_batch* front;
+    sir_plugin_batch* back;
+    sir_mutex mutex;
+    sir_condition ready; /**< Signaled when records are queued, or on shutdown. */
+    sir_condition room;  /**< Signaled when the worker takes the front batch. */
+    sir_thread thread;
+    sir_plugin_overflow policy;
+    bool busy;           /**< True while the worker is delivering `back`. */
+    bool cancel;
+    sir_plugin_stats stats;
+    double latency_total;
+} sir_plugin_queue;
 
 /** Internally-used plugin module data. */
 typedef struct {
@@ -373,46 +669,59 @@ typedef struct {
     bool valid;
     sir_pluginiface iface;
     sirpluginid id;
+    sir_plugin_queue* queue;
 } sir_plugin;
 
+/** An immutable snapshot of the loaded plugins, used by dispatch. */
+typedef struct {
+    sir_plugin* plugins[SIR_MAXPLUGINS];
+    size_t count;
+} sir_pluginlist;
+
 /** Plugin module cache. */
 typedef struct {
     sir_plugin* plugins[SIR_MAXPLUGINS];
     size_t count;
+    sir_pluginlist lists[2]; /**< The published snapshot and a spare. */
+    size_t current;          /**< Index of the published snapshot in `lists`. */
 } sir_plugincache;
 
-/** A node in a sir_queue. */
-typedef struct _sir_queue_node {
-    struct _sir_queue_node* next;
-    void* data;
-} sir_queue_node;
-
-/** FIFO queue. */
-typedef struct {
-    sir_queue_node* head; /**< The first node in the linked list. */
-} sir_queue;
+/** Bounded multi-producer, multi-consumer FIFO queue (see sirqueue.c). */
+typedef struct _sir_queue sir_queue;
 
-/** Job used by a job queue. */
+/** A job to be run by a thread pool. */
 typedef struct {
     bool (*fn)(void*); /**< Callback to be executed as part of the job. */
     void* data;        /**< Data to pass to the callback. */
 } sir_threadpool_job;
 
-/** Thread pool/job queue data container. */
+/** Thread pool configuration (see ::_sir_threadpool_create). */
 typedef struct {
-    sir_thread* threads; /**< A list of thread handles. */
-    size_t num_threads;  /**< The number of threads in the pool. */
-    sir_queue* jobs;     /**< A queue of jobs to run (FIFO). */
-    sir_condition cond;  /**< A condition which indicates that a job is ready. */
-    sir_mutex mutex;     /**< A mutex to be paired with the condition variable. */
-    bool cancel;         /**< Causes threads in the pool to exit when true. */
-} sir_threadpool;
+    size_t num_threads;   /**< Number of threads (0 = one per processor). */
+    const unsigned* cpus; /**< CPUs the threads may run on (NULL = any). */
+    size_t num_cpus;      /**< The number of entries in `cpus`. */
+    size_t stack_size;    /**< Stack size, in bytes (0 = the default). */
+    int nice;             /**< Added to each thread's niceness (> 0 = lower priority). */
+    const char* name;     /**< Threads are named "<name>.<index>" (NULL = "sir_pool"). */
+} sir_threadpool_config;
+
+/** Work-stealing thread pool (see sirthreadpool.c). */
+typedef struct _sir_threadpool sir_threadpool;
 
 /** Formatted output container. */
 typedef struct {
+    const sir_callsite* callsite; /**< Source location of the call, if known. */
+    time_t time;                  /**< Time of the call (seconds). */
+    long time_msec;               /**< Milliseconds since `time`. */
+    long time_nsec;               /**< Nanoseconds since `time`. */
+    pid_t tid_num;                /**< OS identifier of the calling thread. */
+    sir_level level_num;          /**< Level of the call. */
+    const sir_kv* fields;         /**< Key/value fields attached to the message. */
+    size_t field_count;           /**< The number of entries in `fields`. */
     char style[SIR_MAXSTYLE];
-    char* timestamp;
+    const char* timestamp;
     char msec[SIR_MAXMSEC];
+    const char* time_suffix;
     const char* hostname;
     const char* pid;
     const char* level;
@@ -450,8 +759,64 @@ typedef enum {
 # if !defined(SIR_NO_TEXT_STYLING)
     SIRMI_TEXTSTYLE,   /**< The ::sir_level_style_tuple section. */
 # endif
+    SIRMI_COUNT        /**< The number of sections. */
 } sir_mutex_id;
 
+/**
+ * @struct sir_histogram
+ * @brief A log2 latency histogram: `count[n]` is the number of samples that
+ * took at least 2^n but less than 2^(n + 1) nanoseconds (`count[0]` also
+ * includes zero, and the last bucket everything longer).
+ */
+typedef struct {
+    uint64_t count[SIR_STATS_BUCKETS]; /**< Samples in each bucket. */
+} sir_histogram;
+
+/**
+ * @struct sir_dest_stats
+ * @brief Counters for one destination (see ::sir_getstats).
+ */
+typedef struct {
+    uint64_t lines;        /**< Lines written successfully. */
+    uint64_t bytes;        /**< Bytes written successfully. */
+    uint64_t errors;       /**< Writes that failed. */
+    sir_histogram latency; /**< Time taken by each write. */
+} sir_dest_stats;
+
+/**
+ * @struct sir_stats
+ * @brief Counters for everything logged since libsir was initialized (see
+ * ::sir_getstats).
+ */
+typedef struct {
+    uint64_t messages[SIR_NUMLEVELS];       /**< Messages logged at each level (SIRL_EMERG first). */
+    uint64_t squelched;                     /**< Messages suppressed as repeats. */
+    uint64_t limited;                       /**< Messages suppressed by rate limits or sampling. */
+    uint64_t nodest;                        /**< Messages no destination was registered for. */
+    sir_histogram logv;                     /**< Time taken to log each message. */
+    sir_dest_stats d_stdout;                /**< stdout. */
+    sir_dest_stats d_stderr;                /**< stderr. */
+    sir_dest_stats d_syslog;                /**< The system logger. */
+    size_t num_files;                       /**< The number of entries in `files`. */
+    sirfileid file_ids[SIR_MAXFILES];       /**< The log file each entry in `files` is for. */
+    sir_dest_stats files[SIR_MAXFILES];     /**< Log files. */
+    size_t num_plugins;                     /**< The number of entries in `plugins`. */
+    sirpluginid plugin_ids[SIR_MAXPLUGINS]; /**< The plugin each entry in `plugins` is for. */
+    sir_dest_stats plugins[SIR_MAXPLUGINS]; /**< Plugins (written by their worker threads). */
+} sir_stats;
+
+/**
+ * @struct sir_lock_stats
+ * @brief Contention counters for one of libsir's locked sections (see
+ * ::sir_lockstats). Only collected by builds with `SIR_LOCK_PROFILE`.
+ */
+typedef struct {
+    uint64_t acquired;    /**< Times the section was entered. */
+    uint64_t contended;   /**< Times another thread was in it, so the caller waited. */
+    double wait_msec;     /**< Total time spent waiting to enter it. */
+    double hold_max_msec; /**< Longest time a thread stayed in it. */
+} sir_lock_stats;
+
 /** Per-thread error type. */
 typedef struct {
     uint32_t lasterror;
@@ -468,19 +833,23 @@ typedef struct {
 /** Bitmask defining which values are to be updated in the global config. */
 typedef uint32_t sir_config_data_field;
 
-# define SIRU_LEVELS     0x00000001U /**< Update level registrations. */
-# define SIRU_OPTIONS    0x00000002U /**< Update formatting options. */
-# define SIRU_SYSLOG_ID  0x00000004U /**< Update system logger identity. */
-# define SIRU_SYSLOG_CAT 0x00000008U /**< Update system logger category. */
-# define SIRU_ALL        0x0000000fU /**< Update all available fields. */
+# define SIRU_LEVELS      0x00000001U /**< Update level registrations. */
+# define SIRU_OPTIONS     0x00000002U /**< Update formatting options. */
+# define SIRU_SYSLOG_ID   0x00000004U /**< Update system logger identity. */
+# define SIRU_SYSLOG_CAT  0x00000008U /**< Update system logger category. */
+# define SIRU_SYSLOG_ADDR 0x00000010U /**< Update system logger address. */
+# define SIRU_TIME        0x00000020U /**< Update time stamp settings. */
+# define SIRU_ALL         0x0000003fU /**< Update all available fields. */
 
 /** Encapsulates dynamic updating of current configuration. */
 typedef struct {
-    uint32_t fields;         /**< ::sir_config_data_field bitmask. */
-    sir_levels* levels;      /**< Level registrations. */
-    sir_options* opts;       /**< Formatting options. */
-    const char* sl_identity; /**< System logger identity. */
-    const char* sl_category; /**< System logger category. */
+    uint32_t fields;           /**< ::sir_config_data_field bitmask. */
+    sir_levels* levels;        /**< Level registrations. */
+    sir_options* opts;         /**< Formatting options. */
+    const char* sl_identity;   /**< System logger identity. */
+    const char* sl_category;   /**< System logger category. */
+    const char* sl_address;    /**< System logger address. */
+    const sir_time_opts* time; /**< Time stamp settings. */
 } sir_update_config_data;
 
 #endif /* !_SIR_TYPES_H_INCLUDED */
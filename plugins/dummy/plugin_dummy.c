@@ -53,6 +53,12 @@
  * - PLUGINDUMMY_BADBEHAVIOR5: return false from 'sir_plugin_init'
  * - PLUGINDUMMY_BADBEHAVIOR6: return false from 'sir_plugin_write' and
  *   'sir_plugin_cleanup'
+ *
+ * When PLUGINDUMMY_RECORDS is defined, the plugin instead has the
+ * SIR_PLUGINCAP_RECORDS capability, checks each record it receives, and exports
+ * 'plugin_dummy_getcounts' so that the test suite can examine the results, and
+ * 'plugin_dummy_setdelay' and 'plugin_dummy_setinitdelay' so that it can
+ * simulate a plugin that is slow to write, or to load and unload.
  */
 
 #if defined(__WIN__)
@@ -71,7 +77,27 @@ static const sir_levels levels = SIRL_DEBUG | SIRL_INFO;
 static const sir_options opts  = SIRO_NOHOST | SIRO_NOTID;
 static const char* author      = "libsir contributors";
 static const char* desc        = "Logs messages and function calls to stdout.";
+#if defined(PLUGINDUMMY_RECORDS)
+static const uint64_t caps     = SIR_PLUGINCAP_RECORDS;
+static size_t num_records      = 0;
+static size_t num_batches      = 0;
+static bool records_valid      = true;
+static int delay_msec          = 0;
+static int init_delay_msec     = 0;
+
+static void delay(int msec) {
+    if (msec > 0) {
+# if !defined(__WIN__)
+        struct timespec ts = {msec / 1000, (long)(msec % 1000) * 1000000L};
+        (void)nanosleep(&ts, NULL);
+# else
+        Sleep((DWORD)msec);
+# endif
+    }
+}
+#else
 static const uint64_t caps     = 0ULL;
+#endif
 
 PLUGIN_EXPORT bool sir_plugin_query(sir_plugininfo* info) {
 #if defined(PLUGINDUMMY_BADBEHAVIOR2)
@@ -109,6 +135,10 @@ PLUGIN_EXPORT bool sir_plugin_query(sir_plugininfo* info) {
 #if !defined(PLUGINDUMMY_BADBEHAVIOR4)
 PLUGIN_EXPORT bool sir_plugin_init(void) {
     (void)printf("\t" SIR_DGRAY("" PLUGIN_NAME " ('%s')") SIR_EOL, __func__);
+# if defined(PLUGINDUMMY_RECORDS)
+    delay(init_delay_msec);
+# endif
+
 # if defined(PLUGINDUMMY_BADBEHAVIOR5)
     return false;
 # else
@@ -131,9 +161,55 @@ PLUGIN_EXPORT bool sir_plugin_write(sir_level level, const char* message) {
 
 PLUGIN_EXPORT bool sir_plugin_cleanup(void) { //-V524
     (void)printf("\t" SIR_DGRAY("" PLUGIN_NAME " ('%s')") SIR_EOL, __func__);
+#if defined(PLUGINDUMMY_RECORDS)
+    delay(init_delay_msec);
+#endif
+
 #if defined(PLUGINDUMMY_BADBEHAVIOR6)
     return false;
 #else
     return true;
 #endif
 }
+
+#if defined(PLUGINDUMMY_RECORDS)
+PLUGIN_EXPORT bool sir_plugin_write_records(const sir_plugin_record* records, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        const sir_plugin_record* rec = &records[n];
+        if (!_sir_bittest(levels, rec->level) || 0 == rec->time || rec->msec < 0 ||
+            rec->msec > 999 || strlen(rec->message) != rec->message_len ||
+            strlen(rec->line) != rec->line_len ||
+            NULL == strstr(rec->line, rec->message) || rec->field_count > SIR_MAXFIELDS ||
+            (rec->field_count > 0 && NULL == rec->fields))
+            records_valid = false;
+
+        for (size_t f = 0; f < rec->field_count; f++) {
+            if (NULL == rec->fields[f].key || NULL == strstr(rec->line, rec->fields[f].key))
+                records_valid = false;
+        }
+    }
+
+    (void)printf("\t" SIR_DGRAY("" PLUGIN_NAME " (%s): %zu record(s)") SIR_EOL,
+                 __func__, count);
+
+    delay(delay_msec);
+
+    num_records += count;
+    num_batches++;
+    return true;
+}
+
+PLUGIN_EXPORT void plugin_dummy_setdelay(int msec) {
+    delay_msec = msec;
+}
+
+PLUGIN_EXPORT void plugin_dummy_setinitdelay(int msec) {
+    init_delay_msec = msec;
+}
+
+PLUGIN_EXPORT void plugin_dummy_getcounts(size_t* records, size_t* batches, bool* valid) {
+    *records = num_records;
+    *batches = num_batches;
+    *valid   = records_valid;
+}
+#endif
@@ -47,4 +47,11 @@ PLUGIN_EXPORT bool sir_plugin_init(void);
 PLUGIN_EXPORT bool sir_plugin_write(sir_level level, const char* message);
 PLUGIN_EXPORT bool sir_plugin_cleanup(void);
 
+# if defined(PLUGINDUMMY_RECORDS)
+PLUGIN_EXPORT bool sir_plugin_write_records(const sir_plugin_record* records, size_t count);
+PLUGIN_EXPORT void plugin_dummy_getcounts(size_t* records, size_t* batches, bool* valid);
+PLUGIN_EXPORT void plugin_dummy_setdelay(int msec);
+PLUGIN_EXPORT void plugin_dummy_setinitdelay(int msec);
+# endif
+
 #endif /* !_SIR_PLUGIN_DUMMY_H_INCLUDED */
@@ -50,7 +50,7 @@ static const sir_levels levels = SIRL_DEBUG | SIRL_INFO;
 static const sir_options opts  = SIRO_NOHOST | SIRO_NOTID;
 static const char* author      = "libsir contributors";
 static const char* desc        = "Logs messages and function calls to stdout.";
-static const uint64_t caps     = 0ULL;
+static const uint64_t caps     = SIR_PLUGINCAP_RECORDS;
 
 PLUGIN_EXPORT bool sir_plugin_query(sir_plugininfo* info) {
     info->iface_ver = SIR_PLUGIN_VCURRENT;
@@ -78,6 +78,17 @@ PLUGIN_EXPORT bool sir_plugin_write(sir_level level, const char* message) {
     return true;
 }
 
+PLUGIN_EXPORT bool sir_plugin_write_records(const sir_plugin_record* records, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        (void)printf("\t" SIR_DGRAY("plugin_sample (%s): level: %04"PRIx16", time: %lld.%03ld,"
+                     " tid: %ld, message (%zu): %.*s, fields: %zu") SIR_EOL, __func__,
+                     records[n].level, (long long)records[n].time, records[n].msec,
+                     (long)records[n].tid, records[n].message_len, (int)records[n].message_len,
+                     records[n].message, records[n].field_count);
+    }
+    return true;
+}
+
 PLUGIN_EXPORT bool sir_plugin_cleanup(void) { //-V524
     (void)printf("\t" SIR_DGRAY("plugin_sample ('%s')") SIR_EOL, __func__);
     return true;
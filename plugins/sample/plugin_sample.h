@@ -104,6 +104,26 @@ PLUGIN_EXPORT bool sir_plugin_init(void);
  */
 PLUGIN_EXPORT bool sir_plugin_write(sir_level level, const char* message);
 
+/**
+ * @brief Called by libsir (interface v2+) with a batch of structured records,
+ * instead of ::sir_plugin_write, if ::SIR_PLUGINCAP_RECORDS is set in the `caps`
+ * bitmask of the ::sir_plugininfo structure.
+ *
+ * Records are queued by libsir and delivered by the plugin's worker thread, up
+ * to ::SIR_PLUGIN_BATCH at a time; anything still queued is delivered before the
+ * plugin is unloaded. Each record carries the level, time, and thread identifier, the
+ * caller's message, and the line pre-formatted according to `opts`, along with
+ * their lengths, so that the plugin can serialize them directly.
+ *
+ * @param   records Pointer to the first of `count` ::sir_plugin_record structures.
+ *                  They, and the strings they point to, are only valid for the
+ *                  duration of the call.
+ * @param   count   The number of records (at least one).
+ * @returns bool    `true` if the records were successfully processed, `false`
+ *                  otherwise.
+ */
+PLUGIN_EXPORT bool sir_plugin_write_records(const sir_plugin_record* records, size_t count);
+
 /**
  * @brief Called by libsir when the plugin is about to be unloaded.
  *
@@ -126,17 +146,19 @@ PLUGIN_EXPORT bool sir_plugin_cleanup(void);
  * to a REST API endpoint which results in a push notification being sent to a
  * mobile device.
  *
- * Use your imagination; essentially anything is possible. There are some caveats,
- * though: until the thread pool and job queue mechanisms implemented in
- * ([#121](https://github.com/aremmell/libsir/issues/121)) are utilized, plugins
- * must either only perform operations that are guaranteed to complete quickly,
- * or perform those operations asynchronously (*i.e., on another thread*).
+ * Use your imagination; essentially anything is possible. Each plugin is called
+ * on its own worker thread, so a slow plugin does not hold up the threads that
+ * log messages; if it falls too far behind, though, its queue fills up, and
+ * messages are dropped or logging threads wait (see ::sir_pluginpolicy). The
+ * bundled `plugin_shipper`, which sends messages to a log collector, is a more
+ * complete example.
  *
  * ## Versioning
  *
- * libsir's plugin interface will be versioned; the functions appearing on
- * this page comprise the plugin interface v1. If/when a new function export is
- * added (or one is modified), the version number will be bumped.
+ * libsir's plugin interface is versioned; the functions appearing on this page
+ * comprise the plugin interface v2. v1 consisted of all of them except
+ * ::sir_plugin_write_records. If/when a new function export is added (or one is
+ * modified), the version number will be bumped.
  *
  * When plugins are compiled, their interface version is hard-coded in. This means
  * that as libsir continues to evolve (and the version number increases), it can
@@ -0,0 +1,712 @@
+/*
+ * plugin_shipper.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+#include "plugin_shipper.h"
+#include "sir/helpers.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#if !defined(__WIN__)
+# include <sys/socket.h>
+# include <sys/un.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <netdb.h>
+# include <poll.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#if defined(__WIN__)
+BOOL APIENTRY DllMain(HMODULE module, DWORD ul_reason_for_call, LPVOID reserved) {
+    SIR_UNUSED(module);
+    SIR_UNUSED(ul_reason_for_call);
+    SIR_UNUSED(reserved);
+    return TRUE;
+}
+#endif
+
+static const uint8_t maj_ver   = 1U;
+static const uint8_t min_ver   = 0U;
+static const uint8_t bld_ver   = 0U;
+static const sir_levels levels = SIRL_ALL;
+static const sir_options opts  = SIRO_ALL;
+static const char* author      = "libsir contributors";
+static const char* desc        = "Ships messages to a log collector over a stream socket.";
+static const uint64_t caps     = SIR_PLUGINCAP_RECORDS;
+
+#if !defined(__WIN__)
+# if defined(MSG_NOSIGNAL)
+#  define SHIPPER_SENDFLAGS MSG_NOSIGNAL
+# else
+#  define SHIPPER_SENDFLAGS 0
+# endif
+
+/** The size of a frame's length prefix. */
+# define SHIPPER_PREFIX 4
+
+/** A buffer of frames. */
+typedef struct {
+    char* data;
+    size_t used;
+} shipper_buf;
+
+/** The plugin's state; protected by `mutex`. */
+static struct {
+    bool unix_sock;
+    char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    char host[256];
+    char port[8];
+    bool json;
+    size_t size;          /**< The size of each of `fill` and `out`. */
+    shipper_buf fill;     /**< Frames are added here by sir_plugin_write_records. */
+    shipper_buf out;      /**< Frames are sent from here by the sender thread. */
+    size_t out_off;       /**< Offset of the first frame in `out` not yet sent in full. */
+    size_t out_partial;   /**< How much of that frame has been sent. */
+    int fd;
+    uint64_t next_attempt;
+    uint32_t backoff;
+    bool running;
+    bool cancel;
+    plugin_shipper_stats stats;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} st = {
+    false, {0}, {0}, {0}, false, 0, {NULL, 0}, {NULL, 0}, 0, 0, -1, 0, 0, false,
+    false, {0}, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+/** Returns the value of a monotonic clock, in milliseconds. */
+static uint64_t shipper_now(void) {
+    struct timespec ts = {0};
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000ULL) + ((uint64_t)ts.tv_nsec / 1000000ULL);
+}
+
+/** Waits on `cond` for at most `msec` milliseconds. Must hold `mutex`. */
+static void shipper_wait(uint64_t msec) {
+    struct timespec ts = {0};
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec  += (time_t)(msec / 1000ULL);
+    ts.tv_nsec += (long)(msec % 1000ULL) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    (void)pthread_cond_timedwait(&st.cond, &st.mutex, &ts);
+}
+
+static bool shipper_parseaddr(const char* address) {
+    if (0 == strncmp(address, "unix:", 5)) {
+        size_t len = strnlen(address + 5, sizeof(st.path));
+        if (0 == len || len >= sizeof(st.path))
+            return false;
+        (void)memcpy(st.path, address + 5, len);
+        st.path[len]  = '\0';
+        st.unix_sock = true;
+        return true;
+    }
+
+    if (0 != strncmp(address, "tcp:", 4))
+        return false;
+
+    const char* host = address + 4;
+    const char* port = strrchr(host, ':');
+    if (NULL == port || port == host)
+        return false;
+
+    size_t host_len = (size_t)(port - host);
+    if ('[' == host[0]) { /* [IPv6]:port */
+        if (host_len < 3 || ']' != host[host_len - 1])
+            return false;
+        host++;
+        host_len -= 2;
+    }
+
+    port++;
+    size_t port_len = strnlen(port, sizeof(st.port));
+    if (0 == host_len || host_len >= sizeof(st.host) || 0 == port_len ||
+        port_len >= sizeof(st.port) || strspn(port, "0123456789") != port_len)
+        return false;
+
+    (void)memcpy(st.host, host, host_len);
+    st.host[host_len] = '\0';
+    (void)memcpy(st.port, port, port_len);
+    st.port[port_len] = '\0';
+    st.unix_sock      = false;
+    return true;
+}
+
+/** Connects a non-blocking stream socket, waiting at most SHIPPER_TIMEOUT_MSEC. */
+static int shipper_connectto(int family, const struct sockaddr* addr, socklen_t len) {
+    int fd = socket(family, SOCK_STREAM, 0);
+    if (-1 == fd)
+        return -1;
+
+    int flags = fcntl(fd, F_GETFL);
+    if (-1 == flags || -1 == fcntl(fd, F_SETFL, flags | O_NONBLOCK) ||
+        -1 == fcntl(fd, F_SETFD, FD_CLOEXEC)) {
+        (void)close(fd);
+        return -1;
+    }
+
+# if defined(SO_NOSIGPIPE)
+    int on = 1;
+    (void)setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+# endif
+
+    if (0 != connect(fd, addr, len)) {
+        if (EINPROGRESS != errno && EAGAIN != errno) {
+            (void)close(fd);
+            return -1;
+        }
+
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        int err           = 0;
+        socklen_t err_len = sizeof(err);
+        if (1 != poll(&pfd, 1, SHIPPER_TIMEOUT_MSEC) ||
+            0 != getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len) || 0 != err) {
+            (void)close(fd);
+            return -1;
+        }
+    }
+
+    if (AF_UNIX != family) {
+        int on = 1;
+        (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    return fd;
+}
+
+static int shipper_connect(void) {
+    if (st.unix_sock) {
+        struct sockaddr_un sun;
+        (void)memset(&sun, 0, sizeof(sun));
+        sun.sun_family = AF_UNIX;
+        (void)memcpy(sun.sun_path, st.path, strnlen(st.path, sizeof(sun.sun_path)));
+        return shipper_connectto(AF_UNIX, (struct sockaddr*)&sun, sizeof(sun));
+    }
+
+    struct addrinfo hints;
+    (void)memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = AI_NUMERICSERV;
+
+    struct addrinfo* res = NULL;
+    if (0 != getaddrinfo(st.host, st.port, &hints, &res))
+        return -1;
+
+    int fd = -1;
+    for (const struct addrinfo* ai = res; NULL != ai && -1 == fd; ai = ai->ai_next)
+        fd = shipper_connectto(ai->ai_family, ai->ai_addr, ai->ai_addrlen);
+
+    freeaddrinfo(res);
+    return fd;
+}
+
+/** Returns false if the collector has closed the connection. */
+static bool shipper_alive(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (1 != poll(&pfd, 1, 0))
+        return true;
+
+    char c = 0;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n > 0 || (-1 == n && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno));
+}
+
+/** Sends up to `len` bytes; returns how many were sent. Sets `failed` if the
+ * connection is no longer usable. */
+static size_t shipper_send(int fd, const char* data, size_t len, bool* failed) {
+    size_t off = 0;
+    while (off < len) {
+        ssize_t n = send(fd, data + off, len - off, SHIPPER_SENDFLAGS);
+        if (n > 0) {
+            off += (size_t)n;
+            continue;
+        }
+
+        if (-1 == n && EINTR == errno)
+            continue;
+
+        if (-1 == n && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+            /* the collector isn't keeping up; give it a while. */
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            int ready = poll(&pfd, 1, SHIPPER_TIMEOUT_MSEC);
+            if (ready > 0 || (-1 == ready && EINTR == errno))
+                continue;
+        }
+
+        *failed = true;
+        break;
+    }
+    return off;
+}
+
+static size_t shipper_framesize(const char* frame) {
+    const unsigned char* p = (const unsigned char*)frame;
+    return SHIPPER_PREFIX + (((size_t)p[0] << 24) | ((size_t)p[1] << 16) |
+        ((size_t)p[2] << 8) | (size_t)p[3]);
+}
+
+static uint64_t shipper_countframes(const shipper_buf* buf, size_t off) {
+    uint64_t count = 0;
+    for (; off < buf->used; off += shipper_framesize(buf->data + off))
+        count++;
+    return count;
+}
+
+static const char* shipper_levelstr(sir_level level) {
+    switch (level) {
+        case SIRL_EMERG:  return "emerg";
+        case SIRL_ALERT:  return "alert";
+        case SIRL_CRIT:   return "crit";
+        case SIRL_ERROR:  return "error";
+        case SIRL_WARN:   return "warn";
+        case SIRL_NOTICE: return "notice";
+        case SIRL_INFO:   return "info";
+        case SIRL_DEBUG:  return "debug";
+        default:          return "";
+    }
+}
+
+/** Appends `str` to `dst` as the contents of a JSON string. Returns the new
+ * offset, or 0 if it does not fit. */
+static size_t shipper_jsonstr(char* dst, size_t off, size_t max, const char* str, size_t len) {
+    for (size_t n = 0; n < len; n++) {
+        unsigned char c = (unsigned char)str[n];
+        char esc[8]     = {0};
+        size_t esc_len  = 2;
+
+        switch (c) {
+            case '"':  esc[0] = '\\'; esc[1] = '"';  break;
+            case '\\': esc[0] = '\\'; esc[1] = '\\'; break;
+            case '\n': esc[0] = '\\'; esc[1] = 'n';  break;
+            case '\r': esc[0] = '\\'; esc[1] = 'r';  break;
+            case '\t': esc[0] = '\\'; esc[1] = 't';  break;
+            default:
+                if (c < 0x20) {
+                    (void)snprintf(esc, sizeof(esc), "\\u%04x", (unsigned)c);
+                    esc_len = 6;
+                } else {
+                    esc[0]  = (char)c;
+                    esc_len = 1;
+                }
+            break;
+        }
+
+        if (off + esc_len >= max)
+            return 0;
+
+        (void)memcpy(dst + off, esc, esc_len);
+        off += esc_len;
+    }
+
+    return off;
+}
+
+/** Writes a record as JSON. Returns the length, or 0 if it does not fit. */
+static size_t shipper_json(char* dst, size_t max, const sir_plugin_record* rec) {
+    int len = snprintf(dst, max, "{\"time\":%lld,\"msec\":%ld,\"level\":\"%s\",\"tid\":%ld,"
+                       "\"message\":\"", (long long)rec->time, rec->msec,
+                       shipper_levelstr(rec->level), (long)rec->tid);
+    if (len < 0 || (size_t)len >= max)
+        return 0;
+
+    size_t off = shipper_jsonstr(dst, (size_t)len, max, rec->message, rec->message_len);
+    if (0 == off || off + 1 >= max)
+        return 0;
+
+    dst[off++] = '"';
+
+    /* key/value fields attached by sir_logkv become members of the object. */
+    for (size_t n = 0; n < rec->field_count; n++) {
+        const sir_kv* field = &rec->fields[n];
+
+        if (off + 2 >= max)
+            return 0;
+
+        dst[off++] = ',';
+        dst[off++] = '"';
+        off = shipper_jsonstr(dst, off, max, field->key, strlen(field->key));
+        if (0 == off || off + 3 >= max)
+            return 0;
+
+        dst[off++] = '"';
+        dst[off++] = ':';
+
+        int val = 0;
+        switch (field->value.type) {
+            case SIRKV_STR:
+                dst[off++] = '"';
+                off = shipper_jsonstr(dst, off, max, field->value.v.s, strlen(field->value.v.s));
+                if (0 == off || off + 1 >= max)
+                    return 0;
+                dst[off++] = '"';
+            break;
+            case SIRKV_INT:
+                val = snprintf(dst + off, max - off, "%lld", (long long)field->value.v.i);
+            break;
+            case SIRKV_UINT:
+                val = snprintf(dst + off, max - off, "%llu", (unsigned long long)field->value.v.u);
+            break;
+            case SIRKV_FLOAT:
+                val = isfinite(field->value.v.f)
+                    ? snprintf(dst + off, max - off, "%.*g", DBL_DIG, field->value.v.f)
+                    : snprintf(dst + off, max - off, "null");
+            break;
+            case SIRKV_BOOL:
+            default:
+                val = snprintf(dst + off, max - off, "%s", field->value.v.b ? "true" : "false");
+            break;
+        }
+
+        if (val < 0 || (size_t)val >= max - off)
+            return 0;
+        off += (size_t)val;
+    }
+
+    if (off + 1 > max)
+        return 0;
+
+    dst[off++] = '}';
+    return off;
+}
+
+/** Writes a record's formatted line, without its line ending. Returns the
+ * length, or 0 if it does not fit. */
+static size_t shipper_line(char* dst, size_t max, const sir_plugin_record* rec) {
+    size_t len = rec->line_len;
+    while (len > 0 && ('\n' == rec->line[len - 1] || '\r' == rec->line[len - 1]))
+        len--;
+
+    if (0 == len || len > max)
+        return 0;
+
+    (void)memcpy(dst, rec->line, len);
+    return len;
+}
+
+/** Adds a frame to `fill`, or counts it as dropped. Must hold `mutex`. */
+static bool shipper_addframe(const sir_plugin_record* rec) {
+    size_t avail = st.size - st.fill.used;
+    size_t len   = 0;
+    char* frame  = st.fill.data + st.fill.used;
+
+    if (avail > SHIPPER_PREFIX) {
+        len = st.json ? shipper_json(frame + SHIPPER_PREFIX, avail - SHIPPER_PREFIX, rec)
+                      : shipper_line(frame + SHIPPER_PREFIX, avail - SHIPPER_PREFIX, rec);
+    }
+
+    if (0 == len) {
+        st.stats.dropped++;
+        return false;
+    }
+
+    frame[0] = (char)((len >> 24) & 0xffU);
+    frame[1] = (char)((len >> 16) & 0xffU);
+    frame[2] = (char)((len >> 8) & 0xffU);
+    frame[3] = (char)(len & 0xffU);
+
+    st.fill.used += SHIPPER_PREFIX + len;
+    st.stats.frames++;
+    return true;
+}
+
+/** Notes the loss of the connection, or a failure to establish one. Must hold
+ * `mutex`. */
+static void shipper_disconnected(void) {
+    if (-1 != st.fd) {
+        (void)close(st.fd);
+        st.fd = -1;
+    }
+
+    st.stats.failures++;
+    st.stats.connected = false;
+    st.out_partial     = 0; /* a partial frame is sent again in full. */
+    st.next_attempt    = shipper_now() + st.backoff;
+    st.backoff         = st.backoff * 2U > (uint32_t)SHIPPER_BACKOFF_MAX_MSEC
+                       ? (uint32_t)SHIPPER_BACKOFF_MAX_MSEC : st.backoff * 2U;
+}
+
+static void* shipper_thread(void* arg) {
+    SIR_UNUSED(arg);
+
+    (void)pthread_mutex_lock(&st.mutex);
+
+    while (true) {
+        if (st.out_off == st.out.used && st.fill.used > 0) {
+            shipper_buf tmp = st.out;
+            st.out          = st.fill;
+            st.fill         = tmp;
+            st.fill.used    = 0;
+            st.out_off      = 0;
+            st.out_partial  = 0;
+        }
+
+        if (st.out_off == st.out.used) {
+            if (st.cancel)
+                break;
+            (void)pthread_cond_wait(&st.cond, &st.mutex);
+            continue;
+        }
+
+        if (-1 != st.fd && !shipper_alive(st.fd))
+            shipper_disconnected();
+
+        if (-1 == st.fd) {
+            uint64_t now = shipper_now();
+            if (now < st.next_attempt) {
+                if (st.cancel)
+                    break;
+                shipper_wait(st.next_attempt - now);
+                continue;
+            }
+
+            (void)pthread_mutex_unlock(&st.mutex);
+            int fd = shipper_connect();
+            (void)pthread_mutex_lock(&st.mutex);
+
+            if (-1 == fd) {
+                shipper_disconnected();
+                if (st.cancel)
+                    break;
+                continue;
+            }
+
+            st.fd              = fd;
+            st.backoff         = SHIPPER_BACKOFF_MIN_MSEC;
+            st.stats.connects++;
+            st.stats.connected = true;
+        }
+
+        /* frames are only added to `fill`, so `out` can be sent unlocked. */
+        int fd           = st.fd;
+        const char* data = st.out.data + st.out_off + st.out_partial;
+        size_t len       = st.out.used - st.out_off - st.out_partial;
+        bool failed      = false;
+
+        (void)pthread_mutex_unlock(&st.mutex);
+        size_t sent = shipper_send(fd, data, len, &failed);
+        (void)pthread_mutex_lock(&st.mutex);
+
+        if (sent > 0)
+            st.stats.batches++;
+
+        st.out_partial += sent;
+        while (st.out_off < st.out.used) {
+            size_t size = shipper_framesize(st.out.data + st.out_off);
+            if (st.out_partial < size)
+                break;
+            st.out_off     += size;
+            st.out_partial -= size;
+            st.stats.sent++;
+        }
+
+        if (st.out_off == st.out.used)
+            st.out.used = st.out_off = st.out_partial = 0;
+
+        if (failed) {
+            shipper_disconnected();
+            if (st.cancel)
+                break;
+        }
+    }
+
+    /* whatever could not be sent before unloading is lost. */
+    st.stats.dropped += shipper_countframes(&st.out, st.out_off) +
+        shipper_countframes(&st.fill, 0);
+
+    (void)pthread_mutex_unlock(&st.mutex);
+    return NULL;
+}
+#endif /* !__WIN__ */
+
+PLUGIN_EXPORT bool sir_plugin_query(sir_plugininfo* info) {
+    info->iface_ver = SIR_PLUGIN_VCURRENT;
+    info->maj_ver   = maj_ver;
+    info->min_ver   = min_ver;
+    info->bld_ver   = bld_ver;
+    info->levels    = levels;
+    info->opts      = opts;
+    info->author    = author;
+    info->desc      = desc;
+    info->caps      = caps;
+    return true;
+}
+
+PLUGIN_EXPORT bool sir_plugin_init(void) {
+#if !defined(__WIN__)
+    const char* address = getenv("SIR_SHIPPER_ADDR");
+    const char* format  = getenv("SIR_SHIPPER_FORMAT");
+    const char* spill   = getenv("SIR_SHIPPER_SPILL");
+    size_t size         = SHIPPER_SPILL_BYTES;
+
+    if (NULL == address || !shipper_parseaddr(address)) {
+        (void)fprintf(stderr, "plugin_shipper: SIR_SHIPPER_ADDR is not set, or invalid\n");
+        return false;
+    }
+
+    if (NULL != format && 0 != strcmp(format, "line") && 0 != strcmp(format, "json")) {
+        (void)fprintf(stderr, "plugin_shipper: SIR_SHIPPER_FORMAT is invalid\n");
+        return false;
+    }
+
+    if (NULL != spill) {
+        char* end = NULL;
+        unsigned long long val = strtoull(spill, &end, 10);
+        if (end == spill || '\0' != *end || val < 1024ULL || val > (unsigned long long)SIZE_MAX) {
+            (void)fprintf(stderr, "plugin_shipper: SIR_SHIPPER_SPILL is invalid\n");
+            return false;
+        }
+        size = (size_t)val;
+    }
+
+    /* the spill buffer is split between frames being sent and those waiting. */
+    char* data = (char*)calloc(1, size);
+    if (NULL == data)
+        return false;
+
+    (void)pthread_mutex_lock(&st.mutex);
+    st.json         = NULL != format && 0 == strcmp(format, "json");
+    st.size         = size / 2;
+    st.fill.data    = data;
+    st.fill.used    = 0;
+    st.out.data     = data + st.size;
+    st.out.used     = 0;
+    st.out_off      = 0;
+    st.out_partial  = 0;
+    st.fd           = -1;
+    st.next_attempt = 0;
+    st.backoff      = SHIPPER_BACKOFF_MIN_MSEC;
+    st.cancel       = false;
+    (void)memset(&st.stats, 0, sizeof(st.stats));
+
+    int create = pthread_create(&st.thread, NULL, &shipper_thread, NULL);
+    st.running = 0 == create;
+    if (!st.running) {
+        st.fill.data = st.out.data = NULL;
+        free(data);
+    }
+    (void)pthread_mutex_unlock(&st.mutex);
+
+    return 0 == create;
+#else
+    (void)fprintf(stderr, "plugin_shipper: not available on Windows\n");
+    return false;
+#endif
+}
+
+PLUGIN_EXPORT bool sir_plugin_write(sir_level level, const char* message) {
+    sir_plugin_record rec = {0};
+    rec.level       = level;
+    rec.time        = time(NULL);
+    rec.message     = message;
+    rec.message_len = strlen(message);
+    rec.line        = message;
+    rec.line_len    = rec.message_len;
+    return sir_plugin_write_records(&rec, 1);
+}
+
+PLUGIN_EXPORT bool sir_plugin_write_records(const sir_plugin_record* records, size_t count) {
+#if !defined(__WIN__)
+    bool retval = true;
+
+    (void)pthread_mutex_lock(&st.mutex);
+    if (st.running) {
+        for (size_t n = 0; n < count; n++)
+            retval &= shipper_addframe(&records[n]);
+        (void)pthread_cond_signal(&st.cond);
+    } else {
+        retval = false;
+    }
+    (void)pthread_mutex_unlock(&st.mutex);
+
+    return retval;
+#else
+    SIR_UNUSED(records);
+    SIR_UNUSED(count);
+    return false;
+#endif
+}
+
+PLUGIN_EXPORT bool sir_plugin_cleanup(void) { //-V524
+#if !defined(__WIN__)
+    (void)pthread_mutex_lock(&st.mutex);
+    bool running = st.running;
+    st.cancel    = true;
+    (void)pthread_cond_signal(&st.cond);
+    (void)pthread_mutex_unlock(&st.mutex);
+
+    if (!running)
+        return true;
+
+    /* the thread sends what it can before exiting. */
+    (void)pthread_join(st.thread, NULL);
+
+    (void)pthread_mutex_lock(&st.mutex);
+    if (-1 != st.fd) {
+        (void)close(st.fd);
+        st.fd = -1;
+    }
+
+    /* `fill` and `out` are swapped; the allocation starts at the lower one. */
+    free(st.fill.data < st.out.data ? st.fill.data : st.out.data);
+    st.fill.data = st.out.data = NULL;
+    st.running   = false;
+    (void)pthread_mutex_unlock(&st.mutex);
+#endif
+    return true;
+}
+
+PLUGIN_EXPORT bool plugin_shipper_getstats(plugin_shipper_stats* stats) {
+#if !defined(__WIN__)
+    if (NULL == stats)
+        return false;
+
+    (void)pthread_mutex_lock(&st.mutex);
+    bool running = st.running;
+    if (running) {
+        *stats         = st.stats;
+        stats->pending = st.fill.used + st.out.used - st.out_off - st.out_partial;
+    }
+    (void)pthread_mutex_unlock(&st.mutex);
+
+    return running;
+#else
+    SIR_UNUSED(stats);
+    return false;
+#endif
+}
@@ -0,0 +1,62 @@
+/*
+ * plugin_shipper.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _SIR_PLUGIN_SHIPPER_H_INCLUDED
+# define _SIR_PLUGIN_SHIPPER_H_INCLUDED
+
+# include "shipper.h"
+
+# if defined(__WIN__)
+BOOL APIENTRY DllMain(HMODULE module, DWORD ul_reason_for_call, LPVOID reserved);
+#  define PLUGIN_EXPORT __declspec(dllexport)
+# else
+#  define PLUGIN_EXPORT
+# endif
+
+PLUGIN_EXPORT bool sir_plugin_query(sir_plugininfo* info);
+PLUGIN_EXPORT bool sir_plugin_init(void);
+PLUGIN_EXPORT bool sir_plugin_write(sir_level level, const char* message);
+PLUGIN_EXPORT bool sir_plugin_write_records(const sir_plugin_record* records, size_t count);
+PLUGIN_EXPORT bool sir_plugin_cleanup(void);
+
+/**
+ * @brief Retrieves the counters of `plugin_shipper`.
+ *
+ * Resolve it with `dlsym` (or `GetProcAddress`) on the plugin's module.
+ *
+ * @param   stats Pointer to a ::plugin_shipper_stats structure to receive the
+ *                counters.
+ * @returns bool  `true` if the plugin is initialized and `stats` was filled in,
+ *                `false` otherwise.
+ */
+PLUGIN_EXPORT bool plugin_shipper_getstats(plugin_shipper_stats* stats);
+
+#endif /* !_SIR_PLUGIN_SHIPPER_H_INCLUDED */
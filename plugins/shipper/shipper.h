@@ -0,0 +1,108 @@
+/*
+ * shipper.h
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _SIR_SHIPPER_H_INCLUDED
+# define _SIR_SHIPPER_H_INCLUDED
+
+# include "sir/platform.h"
+# include "sir/types.h"
+
+/**
+ * @addtogroup plugins
+ * @{
+ *
+ * ## Shipping logs to a collector
+ *
+ * The bundled `plugin_shipper` sends every message it receives to a log
+ * collector over a TCP or Unix domain stream socket, so that a sidecar process
+ * does not have to tail log files. It is configured through environment
+ * variables, which are read when the plugin is loaded:
+ *
+ * - `SIR_SHIPPER_ADDR` (required): `tcp:host:port` (e.g., `tcp:127.0.0.1:5170`
+ *   or `tcp:[::1]:5170`) or `unix:/path/to/socket`.
+ * - `SIR_SHIPPER_FORMAT`: `line` (the default) sends each message as formatted
+ *   by libsir; `json` sends each as a JSON object with the members `time`,
+ *   `msec`, `level`, `tid`, and `message`.
+ * - `SIR_SHIPPER_SPILL`: the size, in bytes, of the buffer that holds frames
+ *   while they wait to be sent (default: ::SHIPPER_SPILL_BYTES).
+ *
+ * Each message is sent as one frame: its length in bytes, as a 32-bit unsigned
+ * big-endian integer, followed by the UTF-8 text, without a line ending.
+ *
+ * Frames are buffered and sent in batches by the plugin's own thread. If the
+ * collector can't be reached, or the connection is lost, the plugin reconnects
+ * with exponential backoff (from ::SHIPPER_BACKOFF_MIN_MSEC, up to
+ * ::SHIPPER_BACKOFF_MAX_MSEC), holding frames in the buffer in the meantime. A
+ * frame only partially sent when a connection is lost is sent again in full on
+ * the next one. When the buffer is full, new frames are dropped and counted;
+ * see ::plugin_shipper_getstats. Applications may include this header (rather
+ * than `plugin_shipper.h`) for the declaration of ::plugin_shipper_stats.
+ *
+ * The plugin is not available on Windows; its initialization fails there.
+ */
+
+/** The default size, in bytes, of the buffer holding unsent frames. */
+# if !defined(SHIPPER_SPILL_BYTES)
+#  define SHIPPER_SPILL_BYTES 1048576
+# endif
+
+/** The delay, in milliseconds, before the first attempt to reconnect. */
+# if !defined(SHIPPER_BACKOFF_MIN_MSEC)
+#  define SHIPPER_BACKOFF_MIN_MSEC 100
+# endif
+
+/** The longest delay, in milliseconds, between attempts to reconnect. */
+# if !defined(SHIPPER_BACKOFF_MAX_MSEC)
+#  define SHIPPER_BACKOFF_MAX_MSEC 30000
+# endif
+
+/** How long, in milliseconds, to wait for a connection, or for the collector
+ * to accept more data, before giving up on the connection. */
+# if !defined(SHIPPER_TIMEOUT_MSEC)
+#  define SHIPPER_TIMEOUT_MSEC 5000
+# endif
+
+/** Counters maintained by `plugin_shipper`. */
+typedef struct {
+    uint64_t frames;   /**< Frames accepted into the buffer. */
+    uint64_t sent;     /**< Frames sent in full. */
+    uint64_t batches;  /**< Successful sends (each of one or more frames). */
+    uint64_t dropped;  /**< Frames dropped: the buffer was full, or they were
+                            still unsent when the plugin was unloaded. */
+    uint64_t connects; /**< Connections established. */
+    uint64_t failures; /**< Failed connection attempts and lost connections. */
+    size_t pending;    /**< Bytes waiting to be sent. */
+    bool connected;    /**< Whether currently connected to the collector. */
+} plugin_shipper_stats;
+
+/** @} */
+
+#endif /* !_SIR_SHIPPER_H_INCLUDED */
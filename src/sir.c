@@ -39,7 +39,9 @@
 #include "sir/filecache.h"
 #include "sir/plugins.h"
 #include "sir/textstyle.h"
+#include "sir/netsyslog.h"
 #include "sir/defaults.h"
+#include "sir/stats.h"
 
 bool sir_makeinit(sirinit* si) {
     return _sir_makeinit(si);
@@ -129,6 +131,346 @@ bool sir_emerg(PRINTF_FORMAT const char* format, ...) {
     return ret;
 }
 
+PRINTF_FORMAT_ATTR(3, 4)
+bool sir_logat(const sir_callsite* cs, sir_level level, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_logv_at(cs, level, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(3, 4)
+bool sir_logcat(sir_catsite* site, sir_level level, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_logcatv(site, level, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(3, 4)
+bool sir_loglimit(sir_limitsite* site, sir_level level, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_loglimitv(site, level, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_setcategories(const char* spec) {
+    return _sir_setcategories(spec);
+}
+
+bool sir_logkv(sir_level level, const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, level, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_debug_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_DEBUG, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_info_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_INFO, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_notice_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_NOTICE, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_warn_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_WARN, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_error_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_ERROR, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_crit_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_CRIT, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_alert_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_ALERT, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_emerg_kv(const char* message, ...) {
+    _SIR_L_START(message);
+    ret = _sir_logkv(NULL, SIRL_EMERG, message, args);
+    _SIR_L_END();
+    return ret;
+}
+
+sir_context* sir_ctx_init(sirinit* si) {
+    return _sir_ctx_init(si);
+}
+
+bool sir_ctx_cleanup(sir_context* ctx) {
+    return _sir_ctx_cleanup(ctx);
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_debug(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_DEBUG, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_info(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_INFO, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_notice(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_NOTICE, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_warn(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_WARN, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_error(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_ERROR, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_crit(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_CRIT, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_alert(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_ALERT, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(2, 3)
+bool sir_ctx_emerg(sir_context* ctx, PRINTF_FORMAT const char* format, ...) {
+    _SIR_L_START(format);
+    ret = _sir_ctx_logv(ctx, SIRL_EMERG, format, args);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(4, 5)
+bool sir_ctx_logcat(sir_context* ctx, sir_catsite* site, sir_level level,
+    PRINTF_FORMAT const char* format, ...) {
+    if (!_sir_validptr(ctx))
+        return false;
+
+    _SIR_L_START(format);
+    sir_context* prev = _sir_ctx_use(ctx);
+    ret = _sir_logcatv(site, level, format, args);
+    (void)_sir_ctx_use(prev);
+    _SIR_L_END();
+    return ret;
+}
+
+PRINTF_FORMAT_ATTR(4, 5)
+bool sir_ctx_loglimit(sir_context* ctx, sir_limitsite* site, sir_level level,
+    PRINTF_FORMAT const char* format, ...) {
+    if (!_sir_validptr(ctx))
+        return false;
+
+    _SIR_L_START(format);
+    sir_context* prev = _sir_ctx_use(ctx);
+    ret = _sir_loglimitv(site, level, format, args);
+    (void)_sir_ctx_use(prev);
+    _SIR_L_END();
+    return ret;
+}
+
+bool sir_ctx_setcategories(sir_context* ctx, const char* spec) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_setcategories(spec);
+    _SIR_CTX_END();
+    return ret;
+}
+
+sirfileid sir_ctx_addfile(sir_context* ctx, const char* path, sir_levels levels,
+    sir_options opts) {
+    _SIR_CTX_START(ctx, 0U);
+    sirfileid ret = sir_addfile(path, levels, opts);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_remfile(sir_context* ctx, sirfileid id) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_remfile(id);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_filelevels(sir_context* ctx, sirfileid id, sir_levels levels) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_filelevels(id, levels);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_fileopts(sir_context* ctx, sirfileid id, sir_options opts) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_fileopts(id, opts);
+    _SIR_CTX_END();
+    return ret;
+}
+
+sirpluginid sir_ctx_loadplugin(sir_context* ctx, const char* path) {
+    _SIR_CTX_START(ctx, 0U);
+    sirpluginid ret = sir_loadplugin(path);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_unloadplugin(sir_context* ctx, sirpluginid id) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_unloadplugin(id);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_pluginpolicy(sir_context* ctx, sirpluginid id, sir_plugin_overflow policy) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_pluginpolicy(id, policy);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_pluginstats(sir_context* ctx, sirpluginid id, sir_plugin_stats* stats) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_pluginstats(id, stats);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_stdoutlevels(sir_context* ctx, sir_levels levels) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_stdoutlevels(levels);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_stdoutopts(sir_context* ctx, sir_options opts) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_stdoutopts(opts);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_stderrlevels(sir_context* ctx, sir_levels levels) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_stderrlevels(levels);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_stderropts(sir_context* ctx, sir_options opts) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_stderropts(opts);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_settimeformat(sir_context* ctx, sir_time_format format,
+    sir_time_precision precision) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_settimeformat(format, precision);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_sysloglevels(sir_context* ctx, sir_levels levels) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_sysloglevels(levels);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_syslogopts(sir_context* ctx, sir_options opts) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_syslogopts(opts);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_syslogid(sir_context* ctx, const char* identity) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_syslogid(identity);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_syslogcat(sir_context* ctx, const char* category) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_syslogcat(category);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_syslogaddr(sir_context* ctx, const char* address) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_syslogaddr(address);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_lockstats(sir_context* ctx, sir_mutex_id mid, sir_lock_stats* stats) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_lockstats(mid, stats);
+    _SIR_CTX_END();
+    return ret;
+}
+
+bool sir_ctx_resetlockstats(sir_context* ctx) {
+    _SIR_CTX_START(ctx, false);
+    bool ret = sir_resetlockstats();
+    _SIR_CTX_END();
+    return ret;
+}
+
 sirfileid sir_addfile(const char* path, sir_levels levels, sir_options opts) {
     return _sir_addfile(path, levels, opts);
 }
@@ -155,15 +497,23 @@ bool sir_unloadplugin(sirpluginid id) {
 #endif
 }
 
+bool sir_pluginpolicy(sirpluginid id, sir_plugin_overflow policy) {
+    return _sir_plugin_setpolicy(id, policy);
+}
+
+bool sir_pluginstats(sirpluginid id, sir_plugin_stats* stats) {
+    return _sir_plugin_getstats(id, stats);
+}
+
 bool sir_filelevels(sirfileid id, sir_levels levels) {
     _sir_defaultlevels(&levels, sir_file_def_lvls);
-    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL};
+    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL, NULL, NULL};
     return _sir_updatefile(id, &data);
 }
 
 bool sir_fileopts(sirfileid id, sir_options opts) {
     _sir_defaultopts(&opts, sir_file_def_opts);
-    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL};
+    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL, NULL, NULL};
     return _sir_updatefile(id, &data);
 }
 
@@ -192,32 +542,38 @@ bool sir_setcolormode(sir_colormode mode) {
 
 bool sir_stdoutlevels(sir_levels levels) {
     _sir_defaultlevels(&levels, sir_stdout_def_lvls);
-    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL};
+    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_stdoutlevels);
 }
 
 bool sir_stdoutopts(sir_options opts) {
     _sir_defaultopts(&opts, sir_stdout_def_opts);
-    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL};
+    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_stdoutopts);
 }
 
 bool sir_stderrlevels(sir_levels levels) {
     _sir_defaultlevels(&levels, sir_stderr_def_lvls);
-    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL};
+    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_stderrlevels);
 }
 
 bool sir_stderropts(sir_options opts) {
     _sir_defaultopts(&opts, sir_stderr_def_opts);
-    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL};
+    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_stderropts);
 }
 
+bool sir_settimeformat(sir_time_format format, sir_time_precision precision) {
+    sir_time_opts time = {format, precision, SIRTS_DEFAULT};
+    sir_update_config_data data = {SIRU_TIME, NULL, NULL, NULL, NULL, NULL, &time};
+    return _sir_writeinit(&data, _sir_settime);
+}
+
 bool sir_sysloglevels(sir_levels levels) {
 #if !defined(SIR_NO_SYSTEM_LOGGERS)
     _sir_defaultlevels(&levels, sir_syslog_def_lvls);
-    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL};
+    sir_update_config_data data = {SIRU_LEVELS, &levels, NULL, NULL, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_sysloglevels);
 #else
     SIR_UNUSED(levels);
@@ -228,7 +584,7 @@ bool sir_sysloglevels(sir_levels levels) {
 bool sir_syslogopts(sir_options opts) {
 #if !defined(SIR_NO_SYSTEM_LOGGERS)
     _sir_defaultopts(&opts, sir_syslog_def_opts);
-    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL};
+    sir_update_config_data data = {SIRU_OPTIONS, NULL, &opts, NULL, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_syslogopts);
 #else
     SIR_UNUSED(opts);
@@ -238,7 +594,7 @@ bool sir_syslogopts(sir_options opts) {
 
 bool sir_syslogid(const char* identity) {
 #if !defined(SIR_NO_SYSTEM_LOGGERS)
-    sir_update_config_data data = {SIRU_SYSLOG_ID, NULL, NULL, identity, NULL};
+    sir_update_config_data data = {SIRU_SYSLOG_ID, NULL, NULL, identity, NULL, NULL, NULL};
     return _sir_writeinit(&data, _sir_syslogid);
 #else
     SIR_UNUSED(identity);
@@ -248,7 +604,7 @@ bool sir_syslogid(const char* identity) {
 
 bool sir_syslogcat(const char* category) {
 #if !defined(SIR_NO_SYSTEM_LOGGERS)
-    sir_update_config_data data = {SIRU_SYSLOG_CAT, NULL, NULL, NULL, category};
+    sir_update_config_data data = {SIRU_SYSLOG_CAT, NULL, NULL, NULL, category, NULL, NULL};
     return _sir_writeinit(&data, _sir_syslogcat);
 #else
     SIR_UNUSED(category);
@@ -256,6 +612,62 @@ bool sir_syslogcat(const char* category) {
 #endif
 }
 
+bool sir_syslogaddr(const char* address) {
+#if !defined(SIR_NO_SYSTEM_LOGGERS)
+    sir_update_config_data data = {SIRU_SYSLOG_ADDR, NULL, NULL, NULL, NULL, address, NULL};
+    return _sir_writeinit(&data, _sir_syslogaddr);
+#else
+    SIR_UNUSED(address);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
+bool sir_syslogstats(sir_syslog_stats* stats) {
+#if defined(SIR_NETSYSLOG_ENABLED)
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity())
+        return false;
+
+    return _sir_netsyslog_getstats(stats);
+#else
+    SIR_UNUSED(stats);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
+bool sir_lockstats(sir_mutex_id mid, sir_lock_stats* stats) {
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity())
+        return false;
+
+    return _sir_getlockstats(mid, stats);
+}
+
+bool sir_resetlockstats(void) {
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity())
+        return false;
+
+    return _sir_resetlockstats();
+}
+
+bool sir_getstats(sir_stats* stats) {
+#if !defined(SIR_NO_STATS)
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity())
+        return false;
+
+    return _sir_stats_get(stats);
+#else
+    SIR_UNUSED(stats);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
 const char* sir_getversionstring(void) {
     return _SIR_MK_VER_STR(SIR_VERSION_MAJOR, SIR_VERSION_MINOR, SIR_VERSION_PATCH);
 }
@@ -0,0 +1,177 @@
+/*
+ * sircategory.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#include "sir/category.h"
+#include "sir/internal.h"
+
+/** The levels that pass for a level name: that level, and those more severe. */
+#define _SIR_CAT_THRESHOLD(level) ((sir_levels)(((level) << 1) - 1))
+
+/** Maps a level name in a category specification to the levels that pass. */
+static
+bool _sir_catlevels(const char* name, size_t len, sir_levels* levels) {
+    static const struct {
+        const char* name;
+        sir_levels levels;
+    } map[] = {
+        {"none",      SIRL_NONE},
+        {"emerg",     _SIR_CAT_THRESHOLD(SIRL_EMERG)},
+        {"emergency", _SIR_CAT_THRESHOLD(SIRL_EMERG)},
+        {"alert",     _SIR_CAT_THRESHOLD(SIRL_ALERT)},
+        {"crit",      _SIR_CAT_THRESHOLD(SIRL_CRIT)},
+        {"critical",  _SIR_CAT_THRESHOLD(SIRL_CRIT)},
+        {"error",     _SIR_CAT_THRESHOLD(SIRL_ERROR)},
+        {"warn",      _SIR_CAT_THRESHOLD(SIRL_WARN)},
+        {"warning",   _SIR_CAT_THRESHOLD(SIRL_WARN)},
+        {"notice",    _SIR_CAT_THRESHOLD(SIRL_NOTICE)},
+        {"info",      _SIR_CAT_THRESHOLD(SIRL_INFO)},
+        {"debug",     _SIR_CAT_THRESHOLD(SIRL_DEBUG)},
+        {"all",       SIRL_ALL}
+    };
+
+    for (size_t n = 0; n < _sir_countof(map); n++) {
+        if (len == strlen(map[n].name) && _sir_strsame(map[n].name, name, len)) {
+            *levels = map[n].levels;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Category names are made of letters, digits, '_' and '-', in components
+ * separated by single dots. */
+static
+bool _sir_validcatname(const char* name, size_t len) {
+    if (0 == len || len >= SIR_MAXCATEGORY || '.' == name[0] || '.' == name[len - 1])
+        return false;
+
+    for (size_t n = 0; n < len; n++) {
+        if ('.' == name[n] ? '.' == name[n + 1]
+            : !isalnum((unsigned char)name[n]) && '_' != name[n] && '-' != name[n])
+            return false;
+    }
+
+    return true;
+}
+
+/** Trims spaces from both ends of [*start, *end). */
+static inline
+void _sir_cattrim(const char** start, const char** end) {
+    while (*start < *end && isspace((unsigned char)**start))
+        (*start)++;
+    while (*end > *start && isspace((unsigned char)*(*end - 1)))
+        (*end)--;
+}
+
+bool _sir_parsecategories(const char* spec, sir_category_rule* rules, size_t* count) {
+    if (!_sir_validptr(rules) || !_sir_validptr(count))
+        return false;
+
+    *count = 0;
+    if (!spec)
+        return true;
+
+    for (const char* entry = spec; *entry;) {
+        const char* next = strchr(entry, ',');
+        const char* end  = next ? next : entry + strlen(entry);
+        const char* eq   = memchr(entry, '=', (size_t)(end - entry));
+
+        const char* name     = entry;
+        const char* name_end = eq ? eq : end;
+        _sir_cattrim(&name, &name_end);
+
+        /* tolerate empty entries (e.g., a trailing comma). */
+        if (eq || name != name_end) {
+            if (!eq)
+                return _sir_seterror(_SIR_E_INVALID);
+
+            const char* level     = eq + 1;
+            const char* level_end = end;
+            _sir_cattrim(&level, &level_end);
+
+            sir_levels levels = SIRL_NONE;
+            size_t name_len   = (size_t)(name_end - name);
+            bool wildcard     = 1 == name_len && '*' == *name;
+
+            if ((!wildcard && !_sir_validcatname(name, name_len)) ||
+                !_sir_catlevels(level, (size_t)(level_end - level), &levels))
+                return _sir_seterror(_SIR_E_INVALID);
+
+            if (wildcard)
+                name_len = 0;
+
+            /* a later rule for the same name replaces an earlier one. */
+            size_t idx = 0;
+            while (idx < *count && !(name_len == strlen(rules[idx].name) &&
+                _sir_strsame(rules[idx].name, name, name_len)))
+                idx++;
+
+            if (idx == *count) {
+                if (SIR_MAXCATEGORIES == *count)
+                    return _sir_seterror(_SIR_E_INVALID);
+
+                (void)memcpy(rules[idx].name, name, name_len);
+                rules[idx].name[name_len] = '\0';
+                (*count)++;
+            }
+
+            rules[idx].levels = levels;
+        }
+
+        entry = next ? next + 1 : end;
+    }
+
+    return true;
+}
+
+sir_levels _sir_matchcategory(const sir_category_rule* rules, size_t count,
+    const char* category) {
+    sir_levels levels = SIRL_ALL;
+    size_t best       = 0;
+    bool found        = false;
+
+    for (size_t n = 0; n < count; n++) {
+        size_t len = strnlen(rules[n].name, SIR_MAXCATEGORY);
+        if (found && len <= best)
+            continue;
+
+        if (0 == len || (NULL != category && _sir_strsame(rules[n].name, category, len) &&
+            ('\0' == category[len] || '.' == category[len]))) {
+            levels = rules[n].levels;
+            best   = len;
+            found  = true;
+        }
+    }
+
+    return levels;
+}
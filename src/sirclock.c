@@ -0,0 +1,213 @@
+/*
+ * sirclock.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#include "sir/clock.h"
+#include "sir/internal.h"
+
+#if defined(SIR_TSC_X86) && !defined(_MSC_VER)
+# include <cpuid.h>
+#endif
+
+/** The clock used to measure the counter's rate; unlike the wall clock, it is
+ * never stepped. */
+#if defined(CLOCK_MONOTONIC)
+# define SIR_TSC_RATECLOCK CLOCK_MONOTONIC
+#else
+# define SIR_TSC_RATECLOCK SIR_INTERVALCLOCK
+#endif
+
+#if defined(__HAVE_ATOMIC_H__)
+/** The time published by the ticker thread (nsec since the epoch; 0 if none). */
+static atomic_int_fast64_t _sir_clock_cache;
+static atomic_bool _sir_clock_cache_on;
+#endif
+
+/** A reading of the counter, the wall clock and the monotonic clock, taken as
+ * close together as possible. */
+typedef struct {
+    uint64_t ticks;
+    time_t sec;
+    long nsec;
+    int64_t mono;
+} sir_tsc_sample;
+
+/** Returns `true` if the counter ticks at a constant rate, in all power states,
+ * on all cores. */
+static
+bool _sir_tsc_invariant(void) {
+#if defined(SIR_TSC_X86)
+    /* CPUID.80000007H:EDX[8]. */
+# if defined(_MSC_VER)
+    int regs[4] = {0};
+    __cpuid(regs, (int)0x80000000);
+    if ((unsigned)regs[0] < 0x80000007U)
+        return false;
+    __cpuid(regs, (int)0x80000007);
+    return 0 != ((unsigned)regs[3] & (1U << 8));
+# else
+    unsigned eax = 0U, ebx = 0U, ecx = 0U, edx = 0U;
+    return 0 != __get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx) &&
+        0 != (edx & (1U << 8));
+# endif
+#elif defined(SIR_TSC_ARM64)
+    /* the generic timer's virtual count always ticks at a fixed rate. */
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool _sir_clock_setcached(bool enabled) {
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_store(&_sir_clock_cache, 0);
+    atomic_store(&_sir_clock_cache_on, enabled);
+    if (enabled)
+        _sir_clock_publish();
+    return true;
+#else
+    SIR_UNUSED(enabled);
+    return false;
+#endif
+}
+
+bool _sir_clock_cached(void) {
+#if defined(__HAVE_ATOMIC_H__)
+    return atomic_load_explicit(&_sir_clock_cache_on, memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+void _sir_clock_publish(void) {
+#if defined(__HAVE_ATOMIC_H__)
+    time_t sec = 0;
+    long nsec  = 0L;
+    if (_sir_clock_gettimens(SIR_PRECISECLOCK, &sec, &nsec))
+        atomic_store_explicit(&_sir_clock_cache, ((int_fast64_t)sec * 1000000000LL) + nsec,
+            memory_order_relaxed);
+#endif
+}
+
+bool _sir_clock_getcached(time_t* sec, long* nsec) {
+#if defined(__HAVE_ATOMIC_H__)
+    int_fast64_t now = atomic_load_explicit(&_sir_clock_cache, memory_order_relaxed);
+    if (now > 0) {
+        *sec  = (time_t)(now / 1000000000LL);
+        *nsec = (long)(now % 1000000000LL);
+        return true;
+    }
+#else
+    SIR_UNUSED(sec);
+    SIR_UNUSED(nsec);
+#endif
+    return false;
+}
+
+static
+bool _sir_tsc_sample(sir_tsc_sample* sample) {
+    uint64_t window = UINT64_MAX;
+
+    /* keep the reading that was least likely to have been interrupted. */
+    for (int n = 0; n < 3; n++) {
+        time_t sec      = 0;
+        time_t mono_sec = 0;
+        long nsec       = 0L;
+        long mono_nsec  = 0L;
+
+        uint64_t before = _sir_tsc_read();
+        bool ok = _sir_clock_gettimens(SIR_PRECISECLOCK, &sec, &nsec) &&
+            _sir_clock_gettimens(SIR_TSC_RATECLOCK, &mono_sec, &mono_nsec);
+        uint64_t after = _sir_tsc_read();
+
+        if (!ok)
+            return false;
+
+        if (after - before < window) {
+            window        = after - before;
+            sample->ticks = before + (window / 2);
+            sample->sec   = sec;
+            sample->nsec  = nsec;
+            sample->mono  = ((int64_t)mono_sec * 1000000000LL) + mono_nsec;
+        }
+    }
+
+    return true;
+}
+
+bool _sir_tsc_calibrate(sir_tsc_calib* cal) {
+    sir_tsc_sample now = {0};
+    bool start = !cal->valid;
+
+    /* if the counter has gone backwards (e.g., after a suspend), start over. */
+    if (!start && (!_sir_tsc_sample(&now) || now.ticks <= cal->first_ticks ||
+        now.mono <= cal->first_mono))
+        start = true;
+
+    if (start) {
+        cal->valid = false;
+
+        if (!_sir_tsc_invariant()) {
+            _sir_selflog("the time stamp counter is unavailable or not invariant");
+            return false;
+        }
+
+        sir_tsc_sample first = {0};
+        if (!_sir_tsc_sample(&first))
+            return false;
+
+        do {
+            if (!_sir_tsc_sample(&now))
+                return false;
+        } while (now.mono - first.mono < (int64_t)SIR_TSC_CALIBRATION_USEC * 1000LL);
+
+        if (now.ticks <= first.ticks) {
+            _sir_selflog("the time stamp counter isn't advancing");
+            return false;
+        }
+
+        cal->first_ticks = first.ticks;
+        cal->first_mono  = first.mono;
+    }
+
+    /* the longer the baseline, the more accurate the rate. */
+    cal->nsec_per_tick = (double)(now.mono - cal->first_mono) /
+        (double)(now.ticks - cal->first_ticks);
+    cal->ticks = now.ticks;
+    cal->sec   = now.sec;
+    cal->nsec  = now.nsec;
+    cal->valid = true;
+
+    if (start)
+        _sir_selflog("time stamp counter: %.6f nsec/tick", cal->nsec_per_tick);
+
+    return true;
+}
@@ -32,7 +32,85 @@
 #include "sir/condition.h"
 #include "sir/internal.h"
 #include "sir/platform.h"
+#include "sir/mutex.h"
 
+#if defined(SIR_ADAPTIVE_MUTEX) /* futex implementation */
+/**
+ * A waiter notes the sequence number, unlocks the mutex, and sleeps only if the
+ * number hasn't changed since; a signal or broadcast that comes in between
+ * therefore isn't lost. Spurious wakeups are possible, as with pthreads.
+ */
+bool _sir_condcreate(sir_condition* cond) {
+    if (_sir_validptr(cond)) {
+        cond->seq = 0;
+        return true;
+    }
+
+    return false;
+}
+
+bool _sir_condsignal(sir_condition* cond) {
+    if (_sir_validptr(cond)) {
+        (void)__atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+        _sir_futexwake(&cond->seq, 1);
+        return true;
+    }
+
+    return false;
+}
+
+bool _sir_condbroadcast(sir_condition* cond) {
+    if (_sir_validptr(cond)) {
+        (void)__atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+        _sir_futexwake(&cond->seq, INT_MAX);
+        return true;
+    }
+
+    return false;
+}
+
+bool _sir_conddestroy(sir_condition* cond) {
+    return _sir_validptr(cond);
+}
+
+static
+bool _sir_condwait_futex(sir_condition* cond, sir_mutex* mutex, const sir_wait* abstime) {
+    if (_sir_mutexself() != __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED))
+        return _sir_handleerr(EPERM);
+
+    /* a recursively locked mutex is released entirely while waiting. */
+    int seq        = __atomic_load_n(&cond->seq, __ATOMIC_RELAXED);
+    unsigned depth = mutex->depth;
+    mutex->depth   = 1U;
+
+    bool unlocked = _sir_mutexunlock(mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    int err = _sir_futexwait(&cond->seq, seq, abstime);
+
+    bool locked = _sir_mutexlock(mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+    mutex->depth = depth;
+
+    return ETIMEDOUT == err ? false : 0 == err || EAGAIN == err || EINTR == err
+        ? true : _sir_handleerr(err);
+}
+
+bool _sir_condwait(sir_condition* cond, sir_mutex* mutex) {
+    if (_sir_validptr(cond) && _sir_validptr(mutex))
+        return _sir_condwait_futex(cond, mutex, NULL);
+
+    return false;
+}
+
+bool _sir_condwait_timeout(sir_condition* cond, sir_mutex* mutex,
+    const sir_wait* howlong) {
+    if (_sir_validptr(cond) && _sir_validptr(mutex) && _sir_validptr(howlong))
+        return _sir_condwait_futex(cond, mutex, howlong);
+
+    return false;
+}
+#else /* !SIR_ADAPTIVE_MUTEX */
 bool _sir_condcreate(sir_condition* cond) {
     bool valid = _sir_validptr(cond);
 
@@ -48,7 +126,6 @@ bool _sir_condcreate(sir_condition* cond) {
     return valid;
 }
 
-#if 0
 bool _sir_condsignal(sir_condition* cond) {
     bool valid = _sir_validptr(cond);
 
@@ -63,7 +140,6 @@ bool _sir_condsignal(sir_condition* cond) {
 
     return valid;
 }
-#endif
 
 bool _sir_condbroadcast(sir_condition* cond) {
     bool valid = _sir_validptr(cond);
@@ -95,7 +171,6 @@ bool _sir_conddestroy(sir_condition* cond) {
     return valid;
 }
 
-#if 0
 bool _sir_condwait(sir_condition* cond, sir_mutex* mutex) {
     bool valid = _sir_validptr(cond) && _sir_validptr(mutex);
 
@@ -111,7 +186,6 @@ bool _sir_condwait(sir_condition* cond, sir_mutex* mutex) {
 
     return valid;
 }
-#endif
 
 bool _sir_condwait_timeout(sir_condition* cond, sir_mutex* mutex,
     const sir_wait* howlong) {
@@ -129,3 +203,4 @@ bool _sir_condwait_timeout(sir_condition* cond, sir_mutex* mutex,
 
     return valid;
 }
+#endif /* SIR_ADAPTIVE_MUTEX */
@@ -32,9 +32,146 @@
 #include "sir/console.h"
 #include "sir/internal.h"
 
+#include "sir/mutex.h"
+
 #if !defined(__WIN__)
-bool _sir_write_stdio(FILE* stream, const char* message) {
-    return (EOF != fputs(message, stream)) ? true : _sir_handleerr(errno);
+sir_console_stream __sir_stdout = {0};
+sir_console_stream __sir_stderr = {0};
+static sir_once config_once = SIR_ONCE_INIT;
+
+/** Writes all of the supplied buffers to a descriptor, resuming partial writes. */
+static
+bool _sir_write_iov(int fd, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t wrote = writev(fd, iov, iovcnt);
+        if (wrote < 0) {
+            if (EINTR == errno)
+                continue;
+            return _sir_handleerr(errno);
+        }
+
+        while (iovcnt > 0 && (size_t)wrote >= iov->iov_len) {
+            wrote -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + wrote;
+            iov->iov_len -= (size_t)wrote;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Writes anything buffered for the stream, followed by `message` (if any) in
+ * a single call. Must hold the stream's mutex.
+ */
+static
+bool _sir_flush_stream(sir_console_stream* stream, const char* message, size_t len) {
+    struct iovec iov[2];
+    int iovcnt = 0;
+
+    if (stream->len > 0) {
+        iov[iovcnt].iov_base = stream->buf;
+        iov[iovcnt++].iov_len = stream->len;
+    }
+
+    if (NULL != message && len > 0) {
+        iov[iovcnt].iov_base = (void*)message;
+        iov[iovcnt++].iov_len = len;
+    }
+
+    stream->len = 0;
+
+    if (0 == iovcnt)
+        return true;
+
+    /* keep ordering intact with anything written to the stream via stdio. */
+    (void)fflush(stream->file);
+
+    return _sir_write_iov(stream->fd, iov, iovcnt);
+}
+
+static
+void _sir_flush_stdio_atexit(void) {
+    sir_console_stream* streams[] = {&__sir_stdout, &__sir_stderr};
+    for (size_t n = 0; n < _sir_countof(streams); n++) {
+        if (_sir_mutextrylock(&streams[n]->mutex)) {
+            (void)_sir_flush_stream(streams[n], NULL, 0);
+            (void)_sir_mutexunlock(&streams[n]->mutex);
+        }
+    }
+}
+
+static
+void __sir_config_consoles_once(void) {
+    bool created = _sir_mutexcreate(&__sir_stdout.mutex);
+    _sir_eqland(created, _sir_mutexcreate(&__sir_stderr.mutex));
+    SIR_ASSERT_UNUSED(created, created);
+
+    if (0 != atexit(&_sir_flush_stdio_atexit))
+        _sir_selflog("warning: unable to register console flush at exit!");
+}
+
+static
+void _sir_config_console(sir_console_stream* stream, FILE* file) {
+    (void)_sir_mutexlock(&stream->mutex);
+    (void)_sir_flush_stream(stream, NULL, 0);
+
+    stream->file = file;
+    stream->fd   = fileno(file);
+    stream->tty  = 0 != isatty(stream->fd);
+
+    _sir_selflog("fd %d is %s", stream->fd, stream->tty ? "a terminal" : "batched");
+    (void)_sir_mutexunlock(&stream->mutex);
+}
+
+void _sir_initialize_stdio(void) {
+    if (!_sir_once(&config_once, __sir_config_consoles_once))
+        _sir_selflog("warning: unable to configure stdio consoles!");
+
+    _sir_config_console(&__sir_stdout, stdout);
+    _sir_config_console(&__sir_stderr, stderr);
+}
+
+bool _sir_write_stdio(sir_console_stream* stream, sir_level level,
+    const char* message, size_t len) {
+    if (!_sir_mutexlock(&stream->mutex))
+        return false;
+
+    bool retval = true;
+    if (stream->tty || _sir_bittest(SIR_CONSOLE_FLUSH_LEVELS, level) ||
+        stream->len + len > sizeof(stream->buf)) {
+        retval = _sir_flush_stream(stream, message, len);
+    } else {
+        (void)memcpy(stream->buf + stream->len, message, len);
+        stream->len += len;
+    }
+
+    bool unlocked = _sir_mutexunlock(&stream->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+
+bool _sir_flush_stdio(void) {
+    sir_console_stream* streams[] = {&__sir_stdout, &__sir_stderr};
+    bool retval = true;
+
+    for (size_t n = 0; n < _sir_countof(streams); n++) {
+        if (!_sir_mutexlock(&streams[n]->mutex))
+            return false;
+
+        _sir_eqland(retval, _sir_flush_stream(streams[n], NULL, 0));
+
+        bool unlocked = _sir_mutexunlock(&streams[n]->mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+    }
+
+    return retval;
 }
 #else /* __WIN__ */
 HANDLE __sir_stdout  = INVALID_HANDLE_VALUE;
@@ -90,4 +227,8 @@ bool _sir_write_stdio(HANDLE console, const char* message, size_t len) {
 
     return written == chars;
 }
+
+bool _sir_flush_stdio(void) {
+    return true;
+}
 #endif /* !__WIN__ */
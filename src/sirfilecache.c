@@ -35,6 +35,8 @@
 #include "sir/filesystem.h"
 #include "sir/internal.h"
 #include "sir/defaults.h"
+#include "sir/stats.h"
+#include "sir/probes.h"
 
 sirfileid _sir_addfile(const char* path, sir_levels levels, sir_options opts) {
     (void)_sir_seterror(_SIR_E_NOERROR);
@@ -157,6 +159,10 @@ bool _sirfile_write(sirfile* sf, const char* output) {
 bool _sirfile_writeheader(sirfile* sf, const char* msg) {
     bool retval = _sirfile_validate(sf) && _sir_validstr(msg);
 
+    /* a header line would not be valid JSON. */
+    if (retval && _sir_bittest(sf->opts, SIRO_JSON))
+        return true;
+
     if (retval) {
         time_t now = -1;
         (void)time(&now);
@@ -282,12 +288,16 @@ void _sirfile_rollifneeded(sirfile* sf) {
 
         _sir_fflush(sf->f);
 
+        _SIR_PROBE2(roll__start, sf->id, sf->path);
+
         if (_sirfile_roll(sf, &newpath)) {
             char header[SIR_MAXFHEADER] = {0};
             (void)snprintf(header, SIR_MAXFHEADER, SIR_FHROLLED, newpath);
             rolled = _sirfile_writeheader(sf, header);
         }
 
+        _SIR_PROBE3(roll__done, sf->id, sf->path, rolled);
+
         _sir_safefree(&newpath);
         if (!rolled) /* write anyway; don't want to lose data. */
             _sir_selflog("error: failed to roll file (path: '%s', id: %"PRIx32")!",
@@ -426,6 +436,7 @@ sirfileid _sir_fcache_add(sirfcache* sfc, const char* path, sir_levels levels,
             sf->path, sf->id, sfc->count + 1);
 
         sfc->files[sfc->count++] = sf;
+        _sir_stats_add(SIRSD_FILE, sf->id);
 
         if (!_sir_bittest(sf->opts, SIRO_NOHDR) && !_sirfile_writeheader(sf, SIR_FHBEGIN))
             _sir_selflog("warning: failed to write file header (path: '%s', id: %"PRIx32")",
@@ -462,6 +473,7 @@ bool _sir_fcache_rem(sirfcache* sfc, sirfileid id) {
                 _sir_selflog("removing file (path: '%s', id: %"PRIx32"); count = %zu",
                     sfc->files[n]->path, sfc->files[n]->id, sfc->count - 1);
 
+                _sir_stats_rem(SIRSD_FILE, id);
                 _sirfile_destroy(&sfc->files[n]);
                 _sir_fcache_shift(sfc, n);
 
@@ -582,6 +594,7 @@ bool _sir_fcache_destroy(sirfcache* sfc) {
         while (sfc->count > 0) {
             size_t idx = sfc->count - 1;
             SIR_ASSERT(_sirfile_validate(sfc->files[idx]));
+            _sir_stats_rem(SIRSD_FILE, sfc->files[idx]->id);
             _sirfile_destroy(&sfc->files[idx]);
             sfc->files[idx] = NULL;
             sfc->count--;
@@ -625,7 +638,13 @@ bool _sir_fcache_dispatch(const sirfcache* sfc, sir_level level, sirbuf* buf,
                 lastopts = sfc->files[n]->opts;
             }
 
-            if (wrote && _sirfile_write(sfc->files[n], wrote)) {
+            _SIR_PROBE3(write__start, SIRSD_FILE, sfc->files[n]->id, level);
+            uint64_t start = _sir_stats_clock();
+            bool ok        = wrote && _sirfile_write(sfc->files[n], wrote);
+            _sir_stats_write(SIRSD_FILE, sfc->files[n]->id, ok, 1, buf->output_len, start);
+            _SIR_PROBE4(write__done, SIRSD_FILE, sfc->files[n]->id, ok, buf->output_len);
+
+            if (ok) {
                 (*dispatched)++;
             } else {
                 _sir_selflog("error: write to file (path: '%s', id: %"PRIx32") failed!",
@@ -32,6 +32,7 @@
 
 #include "sir/helpers.h"
 #include "sir/errors.h"
+#include <float.h>
 
 void __sir_safefree(void** pp) {
     if (!pp || !*pp)
@@ -105,6 +106,12 @@ bool __sir_validupdatedata(const sir_update_config_data* data, const char* func,
     if (valid && _sir_bittest(data->fields, SIRU_SYSLOG_CAT))
         valid = _sir_validstrnofail(data->sl_category);
 
+    if (valid && _sir_bittest(data->fields, SIRU_SYSLOG_ADDR))
+        valid = _sir_validptrnofail(data->sl_address);
+
+    if (valid && _sir_bittest(data->fields, SIRU_TIME))
+        valid = _sir_validptrnofail(data->time);
+
     if (!valid) {
         SIR_ASSERT(valid);
         (void)__sir_seterror(_SIR_E_INVALID, func, file, line);
@@ -113,6 +120,23 @@ bool __sir_validupdatedata(const sir_update_config_data* data, const char* func,
     return valid;
 }
 
+bool _sir_validtimeopts(const sir_time_opts* opts) {
+    if (!_sir_validptr(opts))
+        return false;
+
+    int format    = (int)opts->format;
+    int precision = (int)opts->precision;
+    int source    = (int)opts->source;
+    if (format < SIRTF_LOCAL || format > SIRTF_EPOCH || precision < SIRTP_MSEC ||
+        precision > SIRTP_NSEC || source < SIRTS_DEFAULT || source > SIRTS_CACHED) {
+        _sir_selflog("invalid time stamp settings: format %d, precision %d, source %d",
+            format, precision, source);
+        return _sir_seterror(_SIR_E_INVALID);
+    }
+
+    return true;
+}
+
 bool __sir_validlevels(sir_levels levels, const char* func,
     const char* file, uint32_t line) {
     if ((SIRL_ALL == levels || SIRL_NONE == levels) ||
@@ -153,8 +177,9 @@ bool __sir_validopts(sir_options opts, const char* func, const char* file,
          _sir_bittest(opts, SIRO_NOMSEC)           ||
          _sir_bittest(opts, SIRO_NOPID)            ||
          _sir_bittest(opts, SIRO_NOTID)            ||
-         _sir_bittest(opts, SIRO_NOHDR))           &&
-         ((opts & ~(SIRO_MSGONLY | SIRO_NOHDR)) == 0U)))
+         _sir_bittest(opts, SIRO_NOHDR)            ||
+         _sir_bittest(opts, SIRO_JSON))            &&
+         ((opts & ~(SIRO_MSGONLY | SIRO_NOHDR | SIRO_JSON)) == 0U)))
          return true;
 
     _sir_selflog("invalid options: %08"PRIx32, opts);
@@ -423,3 +448,195 @@ size_t _sir_strcreplace(char *str, const char c, const char n, int32_t max) {
 
     return cnt;
 }
+
+/** For each byte: zero if it may appear as-is in a JSON string, otherwise the
+ * character that follows the backslash ('u' meaning \u00XX). */
+static const char _sir_json_esc[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['"'] = '"', ['\\'] = '\\', [0x7f] = 'u',
+};
+
+/** Returns how many bytes to drop from the end of `buf` (of `len` bytes) so
+ * that it doesn't end in the middle of a UTF-8 sequence. */
+static inline
+size_t _sir_utf8_partial(const char* buf, size_t len) {
+    size_t back = 0;
+    while (back < len && back < 4 && 0x80 == ((unsigned char)buf[len - back - 1] & 0xc0))
+        back++;
+
+    if (back == len)
+        return back;
+
+    unsigned char lead = (unsigned char)buf[len - back - 1];
+    size_t need = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 1;
+    return need > back + 1 ? back + 1 : 0;
+}
+
+size_t _sir_json_escape(char* restrict dst, size_t size, const char* restrict src,
+    size_t len) {
+    static const char hex[] = "0123456789abcdef";
+
+    if (!dst || 0 == size)
+        return 0;
+
+    size_t out   = 0;
+    size_t avail = size - 1;
+    size_t run   = 0; /* start of the current run of plain bytes. */
+
+    for (size_t n = 0; n <= len; n++) {
+        char esc = n < len ? _sir_json_esc[(unsigned char)src[n]] : '\0';
+        if (n < len && !esc)
+            continue;
+
+        /* copy the run of plain bytes preceding this one in one go. */
+        size_t plain = n - run;
+        if (plain > avail - out) {
+            plain = avail - out;
+            plain -= _sir_utf8_partial(src + run, plain);
+            (void)memcpy(dst + out, src + run, plain);
+            out += plain;
+            break;
+        }
+
+        (void)memcpy(dst + out, src + run, plain);
+        out += plain;
+        run  = n + 1;
+
+        if (n == len)
+            break;
+
+        size_t need = 'u' == esc ? 6 : 2;
+        if (need > avail - out)
+            break;
+
+        dst[out++] = '\\';
+        dst[out++] = esc;
+        if ('u' == esc) {
+            unsigned char ch = (unsigned char)src[n];
+            dst[out++] = '0';
+            dst[out++] = '0';
+            dst[out++] = hex[ch >> 4];
+            dst[out++] = hex[ch & 0x0f];
+        }
+    }
+
+    dst[out] = '\0';
+    return out;
+}
+
+const char* _sir_kv_tostr(const sir_kv_value* value, char num[SIR_MAXKVNUM], size_t* len) {
+    const char* str = num;
+    char* end       = num + SIR_MAXKVNUM - 1;
+    char* pos       = end;
+    uint64_t mag    = 0ULL;
+    bool neg        = false;
+
+    *end = '\0';
+
+    switch (value->type) {
+        case SIRKV_STR:
+            str  = NULL != value->v.s ? value->v.s : "";
+            *len = strlen(str);
+            return str;
+        case SIRKV_BOOL:
+            str  = value->v.b ? "true" : "false";
+            *len = value->v.b ? 4 : 5;
+            return str;
+        case SIRKV_FLOAT: {
+            int wrote = snprintf(num, SIR_MAXKVNUM, "%.*g", DBL_DIG, value->v.f);
+            *len = wrote > 0 ? (size_t)wrote : 0;
+            return num;
+        }
+        case SIRKV_INT:
+            neg = value->v.i < 0;
+            mag = neg ? 0ULL - (uint64_t)value->v.i : (uint64_t)value->v.i;
+            break;
+        case SIRKV_UINT:
+            mag = value->v.u;
+            break;
+        // GCOVR_EXCL_START
+        default: /* validated by _sir_logkv. */
+            SIR_ASSERT(false);
+            *len = 0;
+            return end;
+        // GCOVR_EXCL_STOP
+    }
+
+    /* integers don't need the generality of snprintf. */
+    do {
+        *--pos = (char)('0' + (mag % 10));
+        mag   /= 10;
+    } while (mag > 0);
+
+    if (neg)
+        *--pos = '-';
+
+    *len = (size_t)(end - pos);
+    return pos;
+}
+
+size_t _sir_logfmt_fields(char* restrict dst, size_t size, const sir_kv* restrict fields,
+    size_t count) {
+    if (!dst || 0 == size)
+        return 0;
+
+    size_t out = 0;
+    for (size_t n = 0; n < count; n++) {
+        size_t key_len = strlen(fields[n].key);
+
+        /* room for " key=" and a quoted value, at least. */
+        if (out + key_len + 5 >= size)
+            break;
+
+        dst[out++] = ' ';
+        for (size_t k = 0; k < key_len; k++) {
+            unsigned char ch = (unsigned char)fields[n].key[k];
+            dst[out++] = (ch <= ' ' || '=' == ch || '"' == ch || 0x7f == ch) ? '_' : (char)ch;
+        }
+        dst[out++] = '=';
+
+        char num[SIR_MAXKVNUM];
+        size_t val_len  = 0;
+        const char* val = _sir_kv_tostr(&fields[n].value, num, &val_len);
+
+        bool quote = 0 == val_len;
+        for (size_t v = 0; v < val_len && !quote; v++) {
+            unsigned char ch = (unsigned char)val[v];
+            quote = ch <= ' ' || '=' == ch || '"' == ch || '\\' == ch || 0x7f == ch;
+        }
+
+        if (quote) {
+            /* quoted values use the same escapes as JSON. */
+            dst[out++] = '"';
+            out += _sir_json_escape(dst + out, size - out - 1, val, val_len);
+            dst[out++] = '"';
+        } else {
+            if (val_len > size - out - 1) {
+                val_len = size - out - 1;
+                val_len -= _sir_utf8_partial(val, val_len);
+            }
+            (void)memcpy(dst + out, val, val_len);
+            out += val_len;
+        }
+    }
+
+    dst[out] = '\0';
+    return out;
+}
+
+uint64_t _sir_kv_hash(uint64_t hash, const sir_kv* fields, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        char num[SIR_MAXKVNUM];
+        size_t val_len  = 0;
+        const char* val = _sir_kv_tostr(&fields[n].value, num, &val_len);
+
+        /* the '=' keeps "ab"="c" and "a"="bc" apart. */
+        for (const char* c = fields[n].key; *c; c++)
+            hash = (hash ^ (uint64_t)(unsigned char)*c) * 1099511628211ULL;
+        hash = (hash ^ (uint64_t)'=') * 1099511628211ULL;
+        for (size_t v = 0; v < val_len; v++)
+            hash = (hash ^ (uint64_t)(unsigned char)val[v]) * 1099511628211ULL;
+    }
+    return hash;
+}
@@ -32,6 +32,9 @@
 
 //-V::522
 #include "sir/internal.h"
+#include "sir/clock.h"
+#include "sir/category.h"
+#include "sir/ratelimit.h"
 #include "sir/console.h"
 #include "sir/defaults.h"
 #include "sir/filecache.h"
@@ -39,6 +42,11 @@
 #include "sir/textstyle.h"
 #include "sir/filesystem.h"
 #include "sir/mutex.h"
+#include "sir/ticker.h"
+#include "sir/netsyslog.h"
+#include "sir/stats.h"
+#include "sir/probes.h"
+#include <math.h>
 
 #if defined(__WIN__)
 # if defined(SIR_EVENTLOG_ENABLED)
@@ -52,21 +60,71 @@
 # endif
 #endif
 
-static sirconfig _sir_cfg      = {0};
-static sirfcache _sir_fc       = {0};
-static sir_plugincache _sir_pc = {0};
+#if defined(SIR_LOCK_PROFILE)
+/** Contention counters for a section; only modified while it's locked. */
+typedef struct {
+    sir_lock_stats stats;
+    size_t depth;   /**< How many times the owner has entered the section. */
+    sir_time since; /**< When the owner entered it. */
+} sir_lockprof;
+#endif
+
+/**
+ * Everything that belongs to one instance of libsir: its configuration, file
+ * and plugin caches, and the mutexes that protect them. The stdio streams, the
+ * system logger, text styles and statistics belong to the process.
+ */
+struct sir_context {
+    sirconfig cfg;
+    sirfcache fc;
+    sir_plugincache pc;
+    sir_mutex cfg_mutex;
+    sir_mutex fc_mutex;
+    sir_mutex pc_mutex;
+    sir_category_rule cat_rules[SIR_MAXCATEGORIES]; /**< Protected by `cfg_mutex`. */
+    size_t cat_count;
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_uint_fast32_t magic;
+    atomic_uint_fast32_t cat_gen; /**< Generation of `cat_rules` (0 if none). */
+# if !defined(SIR_NO_PLUGINS)
+    sir_plugin_dispatch pd;
+# endif
+#else
+    volatile uint32_t magic;
+    volatile uint32_t cat_gen;
+#endif
+#if defined(SIR_LOCK_PROFILE)
+    sir_lockprof lockprof[SIRMI_COUNT]; /**< Each protected by its section's mutex. */
+#endif
+    sir_context* next; /**< The next initialized context. */
+};
+
+/** The context used by the sir_* functions, unless another is in use. */
+static sir_context _sir_default_ctx;
+
+/** The context in use by the calling thread (NULL for the default). */
+static _sir_thread_local sir_context* _sir_ctx_tls = NULL;
+
+/** The last generation of category rules handed out, to any context. Without
+ * atomics, it is only updated under the context's config lock. */
+#if defined(__HAVE_ATOMIC_H__)
+static atomic_uint_fast32_t _sir_cat_lastgen;
+#else
+static volatile uint32_t _sir_cat_lastgen;
+#endif
+
+/** The initialized contexts, which the ticker thread visits. */
+static struct {
+    sir_context* head;
+    size_t count;
+    sir_mutex mutex;
+} _sir_ctx_list = {0};
 
 #if !defined(__IMPORTC__)
-static sir_mutex cfg_mutex  = SIR_MUTEX_INIT;
-static sir_mutex fc_mutex   = SIR_MUTEX_INIT;
-static sir_mutex pc_mutex   = SIR_MUTEX_INIT;
 # if !defined(SIR_NO_TEXT_STYLING)
 static sir_mutex ts_mutex   = SIR_MUTEX_INIT;
 # endif
 #else
-static sir_mutex cfg_mutex  = {0};
-static sir_mutex fc_mutex   = {0};
-static sir_mutex pc_mutex   = {0};
 # if !defined(SIR_NO_TEXT_STYLING)
 static sir_mutex ts_mutex   = {0};
 # endif
@@ -77,15 +135,212 @@ static sir_once static_once = SIR_ONCE_INIT;
 static LARGE_INTEGER _sir_perfcntr_freq = {0};
 #endif
 
+static _sir_thread_local char _sir_tid[SIR_MAXPID]   = {0};
+static _sir_thread_local pid_t _sir_tid_num          = 0;
+static _sir_thread_local int64_t _sir_last_thrd_chk  = 0;
+
+/** Per-thread cache of the time stamp, to the second. */
+static _sir_thread_local struct {
+    time_t sec;
+    sir_time_format format;
+    char prefix[SIR_MAXTIME];
+} _sir_ts = {-1, SIRTF_LOCAL, {0}};
+
+/** Returns the context in use by the calling thread. */
+static inline
+sir_context* _sir_ctx(void) {
+    return _sir_ctx_tls ? _sir_ctx_tls : &_sir_default_ctx;
+}
+
+static inline
+bool _sir_ctx_initialized(sir_context* ctx) {
 #if defined(__HAVE_ATOMIC_H__)
-static atomic_uint_fast32_t _sir_magic;
+    return _SIR_MAGIC == atomic_load(&ctx->magic);
 #else
-static volatile uint32_t _sir_magic = 0U;
+    return _SIR_MAGIC == ctx->magic;
 #endif
+}
 
-static _sir_thread_local char _sir_tid[SIR_MAXPID]   = {0};
-static _sir_thread_local sir_time _sir_last_thrd_chk = {0};
-static _sir_thread_local time_t _sir_last_timestamp  = 0;
+static inline
+void _sir_ctx_setmagic(sir_context* ctx, uint32_t magic) {
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_store(&ctx->magic, magic);
+#else
+    ctx->magic = magic;
+#endif
+}
+
+static inline
+uint32_t _sir_ctx_catgen(sir_context* ctx) {
+#if defined(__HAVE_ATOMIC_H__)
+    return (uint32_t)atomic_load(&ctx->cat_gen);
+#else
+    return ctx->cat_gen;
+#endif
+}
+
+/** Replaces the category rules of a context, and gives them a generation no
+ * other rules have (until it wraps around), which invalidates the decisions
+ * cached in every ::sir_catsite. Call with the context's config lock held. */
+static
+void _sir_ctx_setcategories(sir_context* ctx, const sir_category_rule* rules,
+    size_t count) {
+    if (count > 0)
+        (void)memcpy(ctx->cat_rules, rules, count * sizeof(sir_category_rule));
+    ctx->cat_count = count;
+
+    uint32_t gen = 0U;
+    while (0U == gen) {
+#if defined(__HAVE_ATOMIC_H__)
+        gen = ((uint32_t)atomic_fetch_add(&_sir_cat_lastgen, 1) + 1U) & SIR_CATGEN_MASK;
+#else
+        gen = (_sir_cat_lastgen = _sir_cat_lastgen + 1U) & SIR_CATGEN_MASK;
+#endif
+    }
+
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_store(&ctx->cat_gen, gen);
+#else
+    ctx->cat_gen = gen;
+#endif
+}
+
+/**
+ * Locks the list of contexts until ::_sir_ctx_register is called; returns
+ * true if no context has been initialized yet.
+ */
+static
+bool _sir_ctx_lockregister(void) {
+    bool locked = _sir_mutexlock(&_sir_ctx_list.mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    return 0U == _sir_ctx_list.count;
+}
+
+/** Adds a context (if not NULL) to the list locked by ::_sir_ctx_lockregister. */
+static
+void _sir_ctx_register(sir_context* ctx) {
+    if (ctx) {
+        ctx->next          = _sir_ctx_list.head;
+        _sir_ctx_list.head = ctx;
+        _sir_ctx_list.count++;
+    }
+
+    bool unlocked = _sir_mutexunlock(&_sir_ctx_list.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+}
+
+/** Removes a context from the list; returns the number that remain. */
+static
+size_t _sir_ctx_unregister(sir_context* ctx) {
+    bool locked = _sir_mutexlock(&_sir_ctx_list.mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    for (sir_context** iter = &_sir_ctx_list.head; *iter; iter = &(*iter)->next) {
+        if (*iter == ctx) {
+            *iter     = ctx->next;
+            ctx->next = NULL;
+            _sir_ctx_list.count--;
+            break;
+        }
+    }
+
+    size_t count = _sir_ctx_list.count;
+
+    bool unlocked = _sir_mutexunlock(&_sir_ctx_list.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return count;
+}
+
+sir_context* _sir_ctx_use(sir_context* ctx) {
+    sir_context* prev = _sir_ctx_tls;
+    _sir_ctx_tls      = ctx == &_sir_default_ctx ? NULL : ctx;
+    return prev;
+}
+
+sir_context* _sir_ctx_init(sirinit* si) {
+    /* the list of contexts is created along with the default context. */
+    if (!_sir_once(&static_once, _sir_init_static_once))
+        return NULL;
+
+    sir_context* ctx = (sir_context*)calloc(1, sizeof(sir_context));
+    if (!ctx) {
+        (void)_sir_handleerr(errno);
+        return NULL;
+    }
+
+    bool created = _sir_mutexcreate(&ctx->cfg_mutex);
+    _sir_eqland(created, _sir_mutexcreate(&ctx->fc_mutex));
+    _sir_eqland(created, _sir_mutexcreate(&ctx->pc_mutex));
+
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_init(&ctx->magic, 0);
+# if !defined(SIR_NO_PLUGINS)
+    atomic_init(&ctx->pd.current, NULL);
+    atomic_init(&ctx->pd.epoch, 0);
+    atomic_init(&ctx->pd.readers[0], 0);
+    atomic_init(&ctx->pd.readers[1], 0);
+# endif
+#endif
+
+    if (created) {
+        sir_context* prev = _sir_ctx_use(ctx);
+        created = _sir_init(si);
+        if (!created && _sir_ctx_initialized(ctx))
+            (void)_sir_cleanup();
+        (void)_sir_ctx_use(prev);
+    }
+
+    if (!created) {
+        (void)_sir_mutexdestroy(&ctx->pc_mutex);
+        (void)_sir_mutexdestroy(&ctx->fc_mutex);
+        (void)_sir_mutexdestroy(&ctx->cfg_mutex);
+        _sir_safefree(&ctx);
+    }
+
+    return ctx;
+}
+
+bool _sir_ctx_cleanup(sir_context* ctx) {
+    if (!_sir_validptr(ctx))
+        return false;
+
+    if (ctx == &_sir_default_ctx)
+        return _sir_seterror(_SIR_E_INVALID);
+
+    sir_context* prev = _sir_ctx_use(ctx);
+    bool cleanup      = _sir_cleanup();
+    (void)_sir_ctx_use(prev == ctx ? NULL : prev);
+
+    if (cleanup) {
+        _sir_eqland(cleanup, _sir_mutexdestroy(&ctx->pc_mutex));
+        _sir_eqland(cleanup, _sir_mutexdestroy(&ctx->fc_mutex));
+        _sir_eqland(cleanup, _sir_mutexdestroy(&ctx->cfg_mutex));
+        _sir_safefree(&ctx);
+    }
+
+    return cleanup;
+}
+
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_ctx_logv(sir_context* ctx, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args) {
+    if (!_sir_validptr(ctx))
+        return false;
+
+    sir_context* prev = _sir_ctx_use(ctx);
+    bool retval       = _sir_logv(level, format, args);
+    (void)_sir_ctx_use(prev);
+
+    return retval;
+}
+
+#if !defined(SIR_NO_PLUGINS) && defined(__HAVE_ATOMIC_H__)
+sir_plugin_dispatch* _sir_plugin_dispatchstate(void) {
+    return &_sir_ctx()->pd;
+}
+#endif
 
 bool _sir_makeinit(sirinit* si) {
     bool retval = _sir_validptr(si);
@@ -128,11 +383,8 @@ bool _sir_init(sirinit* si) {
     if (!_sir_validptr(si))
         return false;
 
-#if defined(__HAVE_ATOMIC_H__)
-    if (_SIR_MAGIC == atomic_load(&_sir_magic))
-#else
-    if (_SIR_MAGIC == _sir_magic)
-#endif
+    sir_context* ctx = _sir_ctx();
+    if (_sir_ctx_initialized(ctx))
         return _sir_seterror(_SIR_E_ALREADY);
 
     _sir_defaultlevels(&si->d_stdout.levels, sir_stdout_def_lvls);
@@ -149,42 +401,72 @@ bool _sir_init(sirinit* si) {
     if (!_sir_init_sanity(si))
         return false;
 
-    _SIR_LOCK_SECTION(sirconfig, _cfg, SIRMI_CONFIG, false);
+    /* the first context to be initialized resets the process-wide state;
+     * the list stays locked until this one is registered, so that no other
+     * context can also decide it is the first. */
+    bool first = _sir_ctx_lockregister();
+
+    sirconfig* _cfg = _sir_locksection(SIRMI_CONFIG);
+    if (!_cfg) {
+        _sir_ctx_register(NULL);
+        return _sir_seterror(_SIR_E_INTERNAL);
+    }
 
     bool init = true;
 
-#if defined(__HAVE_ATOMIC_H__)
-    atomic_store(&_sir_magic, _SIR_MAGIC);
-#else
-    _sir_magic = _SIR_MAGIC;
-#endif
+    _sir_ctx_setmagic(ctx, _SIR_MAGIC);
+    _sir_ctx_setcategories(ctx, NULL, 0);
 
     _sir_reset_tls();
 
-#if defined(__WIN__)
     _sir_initialize_stdio();
-#else
+#if !defined(__WIN__)
     tzset();
 #endif
 
+    /* the ticker thread publishes the time for SIRTS_CACHED. */
+    bool cached = SIRTS_CACHED == si->time.source;
+    if (cached && !_sir_clock_setcached(true)) {
+        cached = false;
+        _sir_selflog("warning: atomics are unavailable; using the coarse wall clock");
+    }
+
+    if (cached || _sir_stdout_batched() || _sir_stderr_batched()) {
+        if (!_sir_ticker_start()) {
+            init = false;
+            (void)_sir_clock_setcached(false);
+            _sir_selflog("error: failed to start ticker thread!");
+        }
+    }
+
 #if !defined(SIR_NO_TEXT_STYLING)
-    if (!_sir_setcolormode(SIRCM_16)) {
+    if (first && !_sir_setcolormode(SIRCM_16)) {
         init = false;
         _sir_selflog("error: failed to set color mode!");
     }
 
-    if (!_sir_resettextstyles()) {
+    if (first && !_sir_resettextstyles()) {
         init = false;
         _sir_selflog("error: failed to reset text styles!");
     }
 #endif
 
+    if (first)
+        _sir_stats_reset();
+
     (void)memset(&_cfg->state, 0, sizeof(_cfg->state));
     (void)memcpy(&_cfg->si, si, sizeof(sirinit));
 
     /* forcibly null-terminate the process name. */
     _cfg->si.name[SIR_MAXNAME - 1] = '\0';
 
+    /* the ticker thread keeps the time stamp counter's calibration fresh. */
+    if (SIRTS_TSC == _cfg->si.time.source &&
+        (!_sir_tsc_calibrate(&_cfg->state.tsc) || !_sir_ticker_start())) {
+        _cfg->state.tsc.valid = false;
+        _sir_selflog("warning: using the wall clock instead of the time stamp counter");
+    }
+
     /* store PID. */
     _cfg->state.pid = _sir_getpid();
 
@@ -208,6 +490,8 @@ bool _sir_init(sirinit* si) {
 
     _SIR_UNLOCK_SECTION(SIRMI_CONFIG);
 
+    _sir_ctx_register(ctx);
+
     _sir_selflog("initialized %s", (init ? "successfully" : "with errors")); //-V547
 
     SIR_ASSERT(init);
@@ -218,8 +502,25 @@ bool _sir_cleanup(void) {
     if (!_sir_sanity())
         return false;
 
+    /* report what its rate limits have suppressed while it still can. */
+    sir_context* ctx = _sir_ctx();
+    _sir_limit_flush_ctx(ctx, true);
+
+    /* the last context to be cleaned up stops the ticker thread. */
+    bool last = 0U == _sir_ctx_unregister(ctx);
+    if (last)
+        _sir_limit_forget();
+
+    bool stopped = !last || _sir_ticker_stop();
+    SIR_ASSERT(stopped);
+    if (last)
+        (void)_sir_clock_setcached(false);
+
+    bool flushed = _sir_flush_stdio();
+    SIR_ASSERT(flushed);
+
     _SIR_LOCK_SECTION(sirfcache, sfc, SIRMI_FILECACHE, false);
-    bool cleanup   = true;
+    bool cleanup   = stopped && flushed;
     bool destroyfc = _sir_fcache_destroy(sfc);
     SIR_ASSERT(destroyfc);
 
@@ -246,16 +547,20 @@ bool _sir_cleanup(void) {
 #endif
 
 #if !defined(SIR_NO_TEXT_STYLING)
-    if (!_sir_resettextstyles()) {
+    if (last && !_sir_resettextstyles()) {
         cleanup = false;
         _sir_selflog("error: failed to reset text styles!");
     }
 #endif
 
+    _sir_ctx_setmagic(ctx, 0U);
+
+    /* the decisions cached in call sites no longer apply. */
+    ctx->cat_count = 0;
 #if defined(__HAVE_ATOMIC_H__)
-    atomic_store(&_sir_magic, 0);
+    atomic_store(&ctx->cat_gen, 0U);
 #else
-    _sir_magic = 0U;
+    ctx->cat_gen = 0U;
 #endif
 
     _sir_reset_tls();
@@ -270,14 +575,7 @@ bool _sir_cleanup(void) {
 }
 
 bool _sir_isinitialized(void) {
-#if defined(__HAVE_ATOMIC_H__)
-    if (_SIR_MAGIC == atomic_load(&_sir_magic))
-        return true;
-#else
-    if (_SIR_MAGIC == _sir_magic)
-        return true;
-#endif
-    return false;
+    return _sir_ctx_initialized(_sir_ctx());
 }
 
 bool _sir_sanity(void) {
@@ -314,13 +612,15 @@ bool _sir_init_sanity(const sirinit* si) {
     _sir_eqland(optscheck, _sir_validopts(si->d_syslog.opts));
 #endif
 
+    _sir_eqland(optscheck, _sir_validtimeopts(&si->time));
+
     return levelcheck && optscheck;
 }
 
 void _sir_reset_tls(void) {
     _sir_resetstr(_sir_tid);
-    (void)memset(&_sir_last_thrd_chk, 0, sizeof(sir_time));
-    _sir_last_timestamp = 0;
+    _sir_last_thrd_chk = 0;
+    _sir_ts.sec        = -1;
     _sir_reset_tls_error();
 }
 
@@ -432,6 +732,50 @@ bool _sir_syslogcat(sirinit* si, const sir_update_config_data* data) {
     return retval;
 }
 
+bool _sir_syslogaddr(sirinit* si, const sir_update_config_data* data) {
+    bool retval = _sir_validptr(si) && _sir_validptr(data);
+
+    if (retval) {
+        if (_sir_validstrnofail(data->sl_address) &&
+            (!_sir_netsyslog_validaddr(data->sl_address) ||
+             !_sir_netsyslog_canopen(data->sl_address,
+                 _sir_bittest(si->d_syslog._state.mask, SIRSL_NATIVE))))
+            return false;
+
+        if (0 != strncmp(si->d_syslog.address, data->sl_address, SIR_MAX_SYSLOG_ADDR)) {
+            _sir_selflog("updating %s address from '%s' to '%s'", SIR_DESTNAME_SYSLOG,
+                si->d_syslog.address, data->sl_address);
+            _sir_resetstr(si->d_syslog.address);
+            (void)_sir_strncpy(si->d_syslog.address, SIR_MAX_SYSLOG_ADDR, data->sl_address,
+                strnlen(data->sl_address, SIR_MAX_SYSLOG_ADDR));
+            _sir_setbitshigh(&si->d_syslog._state.mask, SIRSL_UPDATED | SIRSL_ADDRESS);
+            retval = _sir_syslog_updated(si, data);
+            _sir_setbitslow(&si->d_syslog._state.mask, SIRSL_UPDATED | SIRSL_ADDRESS);
+        } else {
+            _sir_selflog("skipped superfluous update of %s address: '%s'", SIR_DESTNAME_SYSLOG,
+                si->d_syslog.address);
+        }
+    }
+
+    return retval;
+}
+
+bool _sir_settime(sirinit* si, const sir_update_config_data* data) {
+    bool retval = _sir_validptr(si) && _sir_validptr(data) && _sir_validtimeopts(data->time);
+
+    if (retval) {
+        _sir_selflog("updating time stamp settings from (format: %d, precision: %d) to"
+                     " (format: %d, precision: %d)", (int)si->time.format,
+                     (int)si->time.precision, (int)data->time->format,
+                     (int)data->time->precision);
+        /* the source is only read by sir_init. */
+        si->time.format    = data->time->format;
+        si->time.precision = data->time->precision;
+    }
+
+    return retval;
+}
+
 bool _sir_writeinit(const sir_update_config_data* data, sirinit_update update) {
     (void)_sir_seterror(_SIR_E_NOERROR);
 
@@ -448,12 +792,52 @@ bool _sir_writeinit(const sir_update_config_data* data, sirinit_update update) {
     return updated;
 }
 
+#if defined(SIR_LOCK_PROFILE)
+# if !defined(SIR_NO_TEXT_STYLING)
+/** Contention counters for the text style section, which every context shares. */
+static sir_lockprof _sir_ts_lockprof;
+# endif
+
+/** Returns the contention counters for a section of the calling thread's
+ * context (see _sir_mapmutexid). */
+static inline
+sir_lockprof* _sir_lockprof(sir_mutex_id mid) {
+# if !defined(SIR_NO_TEXT_STYLING)
+    if (SIRMI_TEXTSTYLE == mid)
+        return &_sir_ts_lockprof;
+# endif
+    return &_sir_ctx()->lockprof[mid];
+}
+#endif
+
 void* _sir_locksection(sir_mutex_id mid) {
     sir_mutex* m = NULL;
     void* sec    = NULL;
 
+#if !defined(SIR_LOCK_PROFILE)
     bool enter = _sir_mapmutexid(mid, &m, &sec) && _sir_mutexlock(m);
     SIR_ASSERT(enter);
+#else
+    sir_time start = {0};
+    bool waited    = false;
+    (void)_sir_msec_since(NULL, &start);
+
+    bool enter = _sir_mapmutexid(mid, &m, &sec) && _sir_mutexlock_waited(m, &waited);
+    SIR_ASSERT(enter);
+
+    /* re-entry by the owner is neither an acquisition nor a wait, and must
+     * not move the start of the hold. */
+    sir_lockprof* prof = enter ? _sir_lockprof(mid) : NULL;
+    if (prof && 0 == prof->depth++) {
+        prof->stats.acquired++;
+        if (waited) {
+            prof->stats.contended++;
+            prof->stats.wait_msec += _sir_msec_since(&start, &prof->since);
+        } else {
+            prof->since = start;
+        }
+    }
+#endif
 
     return enter ? sec : NULL;
 }
@@ -462,26 +846,80 @@ void _sir_unlocksection(sir_mutex_id mid) {
     sir_mutex* m = NULL;
     void* sec    = NULL;
 
+#if defined(SIR_LOCK_PROFILE)
+    sir_lockprof* prof = _sir_mapmutexid(mid, &m, &sec) ? _sir_lockprof(mid) : NULL;
+    if (prof && prof->depth > 0 && 0 == --prof->depth) {
+        sir_time now;
+        double held = _sir_msec_since(&prof->since, &now);
+        if (held > prof->stats.hold_max_msec)
+            prof->stats.hold_max_msec = held;
+    }
+#endif
+
     bool leave = _sir_mapmutexid(mid, &m, &sec) && _sir_mutexunlock(m);
     SIR_ASSERT_UNUSED(leave, leave);
 }
 
+bool _sir_getlockstats(sir_mutex_id mid, sir_lock_stats* stats) {
+#if defined(SIR_LOCK_PROFILE)
+    sir_mutex* m = NULL;
+    if (!_sir_validptr(stats) || (unsigned)mid >= (unsigned)SIRMI_COUNT ||
+        !_sir_mapmutexid(mid, &m, NULL))
+        return _sir_seterror(_SIR_E_INVALID);
+
+    /* not via _sir_locksection, so that looking doesn't count. */
+    if (!_sir_mutexlock(m))
+        return false;
+
+    *stats = _sir_lockprof(mid)->stats;
+
+    bool unlocked = _sir_mutexunlock(m);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return true;
+#else
+    SIR_UNUSED(mid);
+    SIR_UNUSED(stats);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
+bool _sir_resetlockstats(void) {
+#if defined(SIR_LOCK_PROFILE)
+    for (int mid = 0; mid < SIRMI_COUNT; mid++) {
+        sir_mutex* m = NULL;
+        if (!_sir_mapmutexid((sir_mutex_id)mid, &m, NULL) || !_sir_mutexlock(m))
+            return false;
+
+        (void)memset(&_sir_lockprof((sir_mutex_id)mid)->stats, 0, sizeof(sir_lock_stats));
+
+        bool unlocked = _sir_mutexunlock(m);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+    }
+
+    return true;
+#else
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
 bool _sir_mapmutexid(sir_mutex_id mid, sir_mutex** m, void** section) {
-    sir_mutex* tmpm = NULL;
-    void* tmpsec = NULL;
+    sir_mutex* tmpm  = NULL;
+    void* tmpsec     = NULL;
+    sir_context* ctx = _sir_ctx();
 
     switch (mid) {
         case SIRMI_CONFIG:
-            tmpm   = &cfg_mutex;
-            tmpsec = &_sir_cfg;
+            tmpm   = &ctx->cfg_mutex;
+            tmpsec = &ctx->cfg;
             break;
         case SIRMI_FILECACHE:
-            tmpm   = &fc_mutex;
-            tmpsec = &_sir_fc;
+            tmpm   = &ctx->fc_mutex;
+            tmpsec = &ctx->fc;
             break;
         case SIRMI_PLUGINCACHE:
-            tmpm   = &pc_mutex;
-            tmpsec = &_sir_pc;
+            tmpm   = &ctx->pc_mutex;
+            tmpsec = &ctx->pc;
             break;
 #if !defined(SIR_NO_TEXT_STYLING)
         case SIRMI_TEXTSTYLE:
@@ -519,20 +957,23 @@ BOOL CALLBACK _sir_init_static_once(PINIT_ONCE ponce, PVOID param, PVOID* ctx) {
 
 bool _sir_init_common_static(void) {
 #if defined(__HAVE_ATOMIC_H__)
-    atomic_init(&_sir_magic, 0);
+    atomic_init(&_sir_default_ctx.magic, 0);
 #endif
 
 #if defined(__WIN__)
     (void)QueryPerformanceFrequency(&_sir_perfcntr_freq);
 #endif
 
-    bool created = _sir_mutexcreate(&cfg_mutex);
+    bool created = _sir_mutexcreate(&_sir_default_ctx.cfg_mutex);
     SIR_ASSERT(created);
 
-    _sir_eqland(created, _sir_mutexcreate(&fc_mutex));
+    _sir_eqland(created, _sir_mutexcreate(&_sir_default_ctx.fc_mutex));
     SIR_ASSERT(created);
 
-    _sir_eqland(created, _sir_mutexcreate(&pc_mutex));
+    _sir_eqland(created, _sir_mutexcreate(&_sir_default_ctx.pc_mutex));
+    SIR_ASSERT(created);
+
+    _sir_eqland(created, _sir_mutexcreate(&_sir_ctx_list.mutex));
     SIR_ASSERT(created);
 
 #if !defined(SIR_NO_TEXT_STYLING)
@@ -555,55 +996,140 @@ bool _sir_once(sir_once* once, sir_once_fn func) {
 
 PRINTF_FORMAT_ATTR(2, 0)
 bool _sir_logv(sir_level level, PRINTF_FORMAT const char* format, va_list args) {
+    return _sir_logv_at(NULL, level, format, args);
+}
+
+/** Returns the time stamp for `sec` in `format`, up to the second. It's only
+ * formatted when the second (or the format) changes. */
+static
+const char* _sir_timestamp(sir_time_format format, time_t sec) {
+    if (sec == _sir_ts.sec && format == _sir_ts.format)
+        return _sir_ts.prefix;
+
+    struct tm tmbuf;
+    bool fmt = false;
+
+    switch (format) {
+        case SIRTF_EPOCH:
+            fmt = snprintf(_sir_ts.prefix, SIR_MAXTIME, "%lld", (long long)sec) > 0;
+        break;
+        case SIRTF_ISO8601:
+            fmt = NULL != _sir_gmtime(&sec, &tmbuf) &&
+                0 != strftime(_sir_ts.prefix, SIR_MAXTIME, "%Y-%m-%dT%H:%M:%S", &tmbuf);
+        break;
+        case SIRTF_UTC:
+            fmt = NULL != _sir_gmtime(&sec, &tmbuf) &&
+                0 != strftime(_sir_ts.prefix, SIR_MAXTIME, SIR_TIMEFORMAT, &tmbuf);
+        break;
+        case SIRTF_LOCAL:
+        default:
+            fmt = _sir_formattime(sec, _sir_ts.prefix, SIR_TIMEFORMAT);
+        break;
+    }
+
+    SIR_ASSERT(fmt);
+    if (!fmt)
+        _sir_resetstr(_sir_ts.prefix);
+
+    _sir_ts.sec    = fmt ? sec : -1;
+    _sir_ts.format = format;
+    return _sir_ts.prefix;
+}
+
+/** Writes the fraction of a second in `nsec` to `out` (e.g. ".034"), to the
+ * given precision. Called for every message, so it avoids snprintf. */
+static inline
+void _sir_formatsubsec(char out[SIR_MAXMSEC], long nsec, sir_time_precision precision) {
+    static const int digits[]   = {3, 6, 9};
+    static const long divisor[] = {1000000L, 1000L, 1L};
+
+    size_t idx = (size_t)precision < _sir_countof(digits) ? (size_t)precision : 0;
+    long val   = nsec / divisor[idx];
+
+    out[0] = '.';
+    for (int n = digits[idx]; n > 0; n--) {
+        out[n] = (char)('0' + (val % 10));
+        val   /= 10;
+    }
+    out[digits[idx] + 1] = '\0';
+}
+
+/** Reads the time for a message from the configured source. Unless another
+ * source is chosen, the coarse clock will do if no more than millisecond
+ * precision is wanted. */
+static inline
+void _sir_gettime(const sirconfig* cfg, time_t* sec, long* nsec) {
+    int clock = SIRTP_MSEC == cfg->si.time.precision ? SIR_WALLCLOCK : SIR_PRECISECLOCK;
+
+    switch (cfg->si.time.source) {
+        case SIRTS_TSC:
+            if (cfg->state.tsc.valid) {
+                _sir_tsc_totime(&cfg->state.tsc, _sir_tsc_read(), sec, nsec);
+                return;
+            }
+        break;
+        case SIRTS_CACHED:
+            if (_sir_clock_getcached(sec, nsec))
+                return;
+            clock = SIR_WALLCLOCK;
+        break;
+        case SIRTS_PRECISE: clock = SIR_PRECISECLOCK; break;
+        case SIRTS_COARSE:  clock = SIR_WALLCLOCK;    break;
+        case SIRTS_DEFAULT:
+        default: break;
+    }
+
+    bool gettime = _sir_clock_gettimens(clock, sec, nsec);
+    SIR_ASSERT_UNUSED(gettime, gettime);
+}
+
+/** The common part of _sir_logv_at and _sir_logkv. If `args` is NULL, `format`
+ * is the message itself rather than a printf-style format string. */
+static
+bool _sir_log_common(const sir_callsite* cs, sir_level level, const char* format,
+    va_list* args, const sir_kv* fields, size_t field_count) {
     if (!_sir_sanity() || !_sir_validlevel(level) || !_sir_validstr(format))
         return false;
 
     (void)_sir_seterror(_SIR_E_NOERROR);
 
+    _SIR_PROBE2(logv__entry, level, format);
+
+    uint64_t stats_start = _sir_stats_clock();
+    _sir_stats_message(level);
+
     _SIR_LOCK_SECTION(sirconfig, _cfg, SIRMI_CONFIG, false);
 
     sirbuf buf = {0};
 
+    /* the clock is read once per message (and, if SIR_STATS_LATENCY is
+     * defined, around each write for the latency histograms). */
+    time_t now_sec = 0;
+    long now_nsec  = 0L;
+    _sir_gettime(_cfg, &now_sec, &now_nsec);
+
     /* from time to time, update the host name in the config, just in case. */
-    time_t now_sec = -1;
-    if (-1 != time(&now_sec)) {
 #if !defined(SIR_EMBEDDED)
-        if (now_sec - _cfg->state.last_hname_chk > SIR_HNAME_CHK_INTERVAL) {
-            _sir_selflog("updating hostname...");
-            if (!_sir_gethostname(_cfg->state.hostname)) {
-                _sir_selflog("error: failed to get hostname!");
-            } else {
-                _cfg->state.last_hname_chk = now_sec;
-                _sir_selflog("hostname: '%s'", _cfg->state.hostname);
-            }
+    if (now_sec - _cfg->state.last_hname_chk > SIR_HNAME_CHK_INTERVAL) {
+        _sir_selflog("updating hostname...");
+        if (!_sir_gethostname(_cfg->state.hostname)) {
+            _sir_selflog("error: failed to get hostname!");
+        } else {
+            _cfg->state.last_hname_chk = now_sec;
+            _sir_selflog("hostname: '%s'", _cfg->state.hostname);
         }
-#endif
-    }
-
-    /* format timestamp (h/m/s only if the integer time has changed). */
-    long now_msec = 0L;
-    bool gettime = _sir_clock_gettime(SIR_WALLCLOCK, &now_sec, &now_msec);
-    SIR_ASSERT_UNUSED(gettime, gettime);
-
-    /* milliseconds. */
-    _sir_snprintf_trunc(buf.msec, SIR_MAXMSEC, SIR_MSECFORMAT, now_msec);
-
-    /* hours/minutes/seconds. */
-    if (now_sec > _sir_last_timestamp || !*_cfg->state.timestamp) {
-        _sir_last_timestamp = now_sec;
-        bool fmt = _sir_formattime(now_sec, _cfg->state.timestamp, SIR_TIMEFORMAT);
-        SIR_ASSERT_UNUSED(fmt, fmt);
     }
+#endif
 
-    /* check elapsed time since updating thread identifier/name. */
-    sir_time thrd_chk;
-    double msec_since_thrd_chk = _sir_msec_since(&_sir_last_thrd_chk, &thrd_chk);
-
-    /* update the thread identifier/name if enough time has elapsed. */
-    if (msec_since_thrd_chk > SIR_THRD_CHK_INTERVAL) {
-        _sir_last_thrd_chk = thrd_chk;
+    /* update the thread identifier/name if enough time has elapsed (or the
+     * clock has gone backwards). */
+    int64_t now_msec = ((int64_t)now_sec * 1000) + (now_nsec / 1000000L);
+    if (now_msec - _sir_last_thrd_chk > SIR_THRD_CHK_INTERVAL ||
+        now_msec < _sir_last_thrd_chk) {
+        _sir_last_thrd_chk = now_msec;
 
         pid_t tid         = _sir_gettid();
+        _sir_tid_num      = tid;
         bool resolved_tid = false;
         bool valid_tid    = tid != -1 && tid != 0;
 
@@ -632,31 +1158,50 @@ bool _sir_logv(sir_level level, PRINTF_FORMAT const char* format, va_list args)
     (void)memcpy(&cfg, _cfg, sizeof(sirconfig));
     _SIR_UNLOCK_SECTION(SIRMI_CONFIG);
 
-    buf.timestamp = cfg.state.timestamp;
-    buf.hostname  = cfg.state.hostname;
-    buf.pid       = cfg.state.pidbuf;
-    buf.name      = cfg.si.name;
+    buf.callsite    = cs;
+    buf.time        = now_sec;
+    buf.time_msec   = now_nsec / 1000000L;
+    buf.time_nsec   = now_nsec;
+    buf.tid_num     = _sir_tid_num;
+    buf.timestamp   = _sir_timestamp(cfg.si.time.format, now_sec);
+    buf.time_suffix = SIRTF_ISO8601 == cfg.si.time.format ? "Z" : "";
+    buf.hostname    = cfg.state.hostname;
+    buf.pid         = cfg.state.pidbuf;
+    buf.name        = cfg.si.name;
 
-#if !defined(SIR_NO_TEXT_STYLING)
-    const char* style_str = _sir_gettextstyle(level);
+    _sir_formatsubsec(buf.msec, now_nsec, cfg.si.time.precision);
 
-    SIR_ASSERT(NULL != style_str);
-    if (NULL != style_str)
-        (void)_sir_strncpy(buf.style, SIR_MAXSTYLE, style_str,
-            strnlen(style_str, SIR_MAXSTYLE));
+#if !defined(SIR_NO_TEXT_STYLING)
+    /* styles are only emitted to terminals. */
+    if (!_sir_stdout_batched() || !_sir_stderr_batched()) {
+        bool got_style = _sir_gettextstyle(level, buf.style);
+        SIR_ASSERT_UNUSED(got_style, got_style);
+    }
 #endif
 
-    buf.level = _sir_formattedlevelstr(level);
+    buf.level     = _sir_formattedlevelstr(level);
+    buf.level_num = level;
 
     if (_sir_validstrnofail(_sir_tid))
         (void)_sir_strncpy(buf.tid, SIR_MAXPID, _sir_tid,
             strnlen(_sir_tid, SIR_MAXPID));
 
-    (void)vsnprintf(buf.message, SIR_MAXMESSAGE, format, args);
+    if (NULL != args) {
+        (void)vsnprintf(buf.message, SIR_MAXMESSAGE, format, *args);
+    } else {
+        size_t msg_len = strnlen(format, SIR_MAXMESSAGE - 1);
+        (void)memcpy(buf.message, format, msg_len);
+        buf.message[msg_len] = '\0';
+    }
+
+    buf.fields      = fields;
+    buf.field_count = field_count;
 
     if (!_sir_validstrnofail(buf.message))
         return _sir_seterror(_SIR_E_INTERNAL);
 
+    _SIR_PROBE2(logv__formatted, level, buf.message);
+
     bool match             = false;
     bool exit_early        = false;
     bool update_last_props = true;
@@ -665,7 +1210,7 @@ bool _sir_logv(sir_level level, PRINTF_FORMAT const char* format, va_list args)
     if (cfg.state.last.level == level &&
         cfg.state.last.prefix[0] == buf.message[0]  &&
         cfg.state.last.prefix[1] == buf.message[1]) {
-        hash  = FNV64_1a(buf.message);
+        hash  = _sir_kv_hash(FNV64_1a(buf.message), fields, field_count);
         match = cfg.state.last.hash == hash;
     }
 
@@ -712,13 +1257,181 @@ bool _sir_logv(sir_level level, PRINTF_FORMAT const char* format, va_list args)
 
     _SIR_UNLOCK_SECTION(SIRMI_CONFIG);
 
-    if (exit_early)
+    if (exit_early) {
+        _sir_stats_squelched();
         return false;
+    }
 
     bool dispatched = _sir_dispatch(&cfg.si, level, &buf);
+    _sir_stats_logv(stats_start);
     return update_last_props ? dispatched : false;
 }
 
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_logv_at(const sir_callsite* cs, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    bool ret = _sir_log_common(cs, level, format, &copy, NULL, 0);
+    va_end(copy);
+    return ret;
+}
+
+bool _sir_logkv(const sir_callsite* cs, sir_level level, const char* message, va_list args) {
+    sir_kv fields[SIR_MAXFIELDS];
+    size_t count = 0;
+
+    for (const char* key = va_arg(args, const char*); NULL != key;
+        key = va_arg(args, const char*)) {
+        sir_kv_value value = va_arg(args, sir_kv_value);
+
+        if (value.type < SIRKV_STR || value.type > SIRKV_BOOL || !*key) {
+            _sir_selflog("ignoring field '%s' with type %d", key, (int)value.type);
+            continue;
+        }
+
+        if (SIRKV_STR == value.type && NULL == value.v.s)
+            value.v.s = "";
+
+        if (count < SIR_MAXFIELDS) {
+            fields[count].key   = key;
+            fields[count].value = value;
+            count++;
+        }
+    }
+
+    return _sir_log_common(cs, level, message, NULL, fields, count);
+}
+
+bool _sir_setcategories(const char* spec) {
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity())
+        return false;
+
+    sir_category_rule rules[SIR_MAXCATEGORIES];
+    size_t count = 0;
+    if (!_sir_parsecategories(spec, rules, &count))
+        return false;
+
+    _SIR_LOCK_SECTION(sirconfig, _cfg, SIRMI_CONFIG, false);
+    _sir_ctx_setcategories(_sir_ctx(), rules, count);
+    _SIR_UNLOCK_SECTION(SIRMI_CONFIG);
+
+    _sir_selflog("set %zu category rule(s) from '%s'", count, spec ? spec : "");
+    return true;
+}
+
+/** Decides which levels are logged for the category of `site` under the
+ * current rules, and caches the decision in it. Returns 0 on failure. */
+static
+uint32_t _sir_catsite_resolve(sir_catsite* site) {
+    _SIR_LOCK_SECTION(sirconfig, _cfg, SIRMI_CONFIG, 0U);
+
+    sir_context* ctx = _sir_ctx();
+    uint32_t gen     = _sir_ctx_catgen(ctx);
+    uint32_t cache   = 0U;
+
+    if (0U != gen) {
+        cache = (gen << SIR_CATGEN_SHIFT) |
+            _sir_matchcategory(ctx->cat_rules, ctx->cat_count, site->category);
+        _sir_catsite_store(site, cache);
+    }
+
+    _SIR_UNLOCK_SECTION(SIRMI_CONFIG);
+    return cache;
+}
+
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_logcatv(sir_catsite* site, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args) {
+    if (!_sir_validptr(site))
+        return false;
+
+    /* only the first call after the rules change looks them up. */
+    uint32_t gen   = _sir_ctx_catgen(_sir_ctx());
+    uint32_t cache = _sir_catsite_load(site);
+    if (0U == gen || (cache >> SIR_CATGEN_SHIFT) != gen) {
+        if (!_sir_sanity())
+            return false;
+        cache = _sir_catsite_resolve(site);
+    }
+
+    /* filtered out before anything is formatted; like a squelched message,
+     * that's not an error, but the message wasn't dispatched either. */
+    if (!_sir_bittest(cache & SIRL_ALL, level)) {
+        if (_sir_validlevel(level))
+            (void)_sir_seterror(_SIR_E_NOERROR);
+        return false;
+    }
+
+    return _sir_logv(level, format, args);
+}
+
+/** Logs the summary of the messages suppressed by `site`. */
+static
+void _sir_limit_report(const sir_limitsite* site, sir_level level, uint64_t count) {
+    char summary[SIR_MAXMESSAGE];
+    (void)snprintf(summary, SIR_MAXMESSAGE, SIR_LIMIT_MSG_FORMAT, count,
+        _sir_validstrnofail(site->file) ? site->file : "?", site->line);
+    (void)_sir_log_common(NULL, level, summary, NULL, NULL, 0);
+}
+
+PRINTF_FORMAT_ATTR(3, 0)
+bool _sir_loglimitv(sir_limitsite* site, sir_level level, PRINTF_FORMAT const char* format,
+    va_list args) {
+    if (!_sir_validptr(site))
+        return false;
+
+    /* decided before anything is formatted. */
+    if (!_sir_limit_admit(site)) {
+        /* the ticker thread reports the site if no other call does. */
+        if (_sir_limit_suppress(site, level, _sir_ctx()) && _sir_isinitialized())
+            (void)_sir_ticker_start();
+        _sir_stats_limited();
+        (void)_sir_seterror(_SIR_E_NOERROR);
+        return false;
+    }
+
+    uint64_t report = _sir_limit_collect(site, false);
+    if (0ULL != report)
+        _sir_limit_report(site, level, report);
+
+    return _sir_logv(level, format, args);
+}
+
+void _sir_limit_flush_ctx(sir_context* ctx, bool force) {
+    for (sir_limitsite* site = _sir_limit_next(NULL); site; site = _sir_limit_next(site)) {
+        if (site->ctx != ctx)
+            continue;
+
+        uint64_t report = _sir_limit_collect(site, force);
+        if (0ULL != report)
+            _sir_limit_report(site, (sir_level)site->level, report);
+    }
+}
+
+bool _sir_limit_flush(void) {
+    /* like _sir_tsc_recalibrate, don't wait for the list; contexts can't be
+     * cleaned up while it's held. */
+    if (!_sir_mutextrylock(&_sir_ctx_list.mutex))
+        return true;
+
+    sir_context* prev = _sir_ctx_use(NULL);
+
+    for (sir_context* ctx = _sir_ctx_list.head; ctx; ctx = ctx->next) {
+        (void)_sir_ctx_use(ctx);
+        _sir_limit_flush_ctx(ctx, false);
+    }
+
+    (void)_sir_ctx_use(prev);
+
+    bool unlocked = _sir_mutexunlock(&_sir_ctx_list.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return true;
+}
+
 bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf) {
     bool retval       = true;
     size_t dispatched = 0;
@@ -731,10 +1444,15 @@ bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf) {
 #endif
 
     if (_sir_bittest(si->d_stdout.levels, level)) {
-        const char* writef = _sir_format(styling, si->d_stdout.opts, buf);
+        _SIR_PROBE3(write__start, SIRSD_STDOUT, 0U, level);
+        uint64_t start     = _sir_stats_clock();
+        const char* writef = _sir_format(styling && !_sir_stdout_batched(),
+            si->d_stdout.opts, buf);
         bool wrote         = _sir_validstrnofail(writef) &&
-            _sir_write_stdout(writef, buf->output_len);
+            _sir_write_stdout(level, writef, buf->output_len);
         _sir_eqland(retval, wrote);
+        _sir_stats_write(SIRSD_STDOUT, 0U, wrote, 1, buf->output_len, start);
+        _SIR_PROBE4(write__done, SIRSD_STDOUT, 0U, wrote, buf->output_len);
 
         if (wrote)
             dispatched++;
@@ -742,10 +1460,15 @@ bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf) {
     }
 
     if (_sir_bittest(si->d_stderr.levels, level)) {
-        const char* writef = _sir_format(styling, si->d_stderr.opts, buf);
+        _SIR_PROBE3(write__start, SIRSD_STDERR, 0U, level);
+        uint64_t start     = _sir_stats_clock();
+        const char* writef = _sir_format(styling && !_sir_stderr_batched(),
+            si->d_stderr.opts, buf);
         bool wrote         = _sir_validstrnofail(writef) &&
-            _sir_write_stderr(writef, buf->output_len);
+            _sir_write_stderr(level, writef, buf->output_len);
         _sir_eqland(retval, wrote);
+        _sir_stats_write(SIRSD_STDERR, 0U, wrote, 1, buf->output_len, start);
+        _SIR_PROBE4(write__done, SIRSD_STDERR, 0U, wrote, buf->output_len);
 
         if (wrote)
             dispatched++;
@@ -754,7 +1477,14 @@ bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf) {
 
 #if !defined(SIR_NO_SYSTEM_LOGGERS)
     if (_sir_bittest(si->d_syslog.levels, level)) {
-        if (_sir_syslog_write(level, buf, &si->d_syslog))
+        _SIR_PROBE3(write__start, SIRSD_SYSLOG, 0U, level);
+        uint64_t start = _sir_stats_clock();
+        bool wrote     = _sir_syslog_write(level, buf, &si->d_syslog);
+        size_t bytes   = strnlen(buf->message, SIR_MAXMESSAGE);
+        _sir_stats_write(SIRSD_SYSLOG, 0U, wrote, 1, bytes, start);
+        _SIR_PROBE4(write__done, SIRSD_SYSLOG, 0U, wrote, bytes);
+
+        if (wrote)
             dispatched++;
         wanted++;
     }
@@ -770,17 +1500,16 @@ bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf) {
     wanted += fwanted;
 
 #if !defined(SIR_NO_PLUGINS)
-    _SIR_LOCK_SECTION(const sir_plugincache, spc, SIRMI_PLUGINCACHE, false);
     size_t pdispatched = 0;
     size_t pwanted     = 0;
-    _sir_eqland(retval, _sir_plugin_cache_dispatch(spc, level, buf, &pdispatched, &pwanted));
-    _SIR_UNLOCK_SECTION(SIRMI_PLUGINCACHE);
+    _sir_eqland(retval, _sir_plugin_dispatch(level, buf, &pdispatched, &pwanted));
 
     dispatched += pdispatched;
     wanted += pwanted;
 #endif
 
     if (0 == wanted) {
+        _sir_stats_nodest();
         _sir_selflog("error: no destinations registered for level %04"PRIx16, level);
         return _sir_seterror(_SIR_E_NODEST);
     }
@@ -788,7 +1517,132 @@ bool _sir_dispatch(const sirinit* si, sir_level level, sirbuf* buf) {
     return retval && (dispatched == wanted);
 }
 
+/** Room kept at the end of JSON output to close the object: '}', EOL, NUL. */
+#define SIR_JSON_TAIL 4
+
+static _sir_thread_local time_t _sir_json_last_sec = -1;
+static _sir_thread_local char _sir_json_timestamp[SIR_MAXTIME] = {0};
+
+static const char* const _sir_json_levels[SIR_NUMLEVELS] = {
+    SIRL_S_EMERG, SIRL_S_ALERT, SIRL_S_CRIT, SIRL_S_ERROR,
+    SIRL_S_WARN, SIRL_S_NOTICE, SIRL_S_INFO, SIRL_S_DEBUG
+};
+
+static inline
+void _sir_json_put(char* out, size_t* len, const char* str, size_t n) {
+    if (*len + n <= SIR_MAXOUTPUT - SIR_JSON_TAIL) {
+        (void)memcpy(out + *len, str, n);
+        *len += n;
+    }
+}
+
+/** Appends `,"key":"value"` (or `,"key":value` if `quote` is false), escaping
+ * the value. The comma is omitted for the first field. */
+static
+void _sir_json_field(char* out, size_t* len, const char* key, const char* value,
+    size_t value_len, bool quote) {
+    /* leave the field out entirely unless its key (escaped) and the quotes
+     * around its value will fit; the value itself may be cut short. */
+    size_t key_len = strlen(key);
+    size_t limit   = SIR_MAXOUTPUT - SIR_JSON_TAIL;
+    if (*len + (key_len * 6) + 7 > limit)
+        return;
+
+    if (*len > 1)
+        _sir_json_put(out, len, ",", 1);
+    _sir_json_put(out, len, "\"", 1);
+    *len += _sir_json_escape(out + *len, limit - *len, key, key_len);
+    _sir_json_put(out, len, quote ? "\":\"" : "\":", quote ? 3 : 2);
+
+    /* leave room for the closing quote. */
+    if (*len + 1 < limit)
+        *len += _sir_json_escape(out + *len, limit - *len, value, value_len);
+
+    if (quote)
+        _sir_json_put(out, len, "\"", 1);
+}
+
+/** Formats a message as a JSON object on one line (see ::SIRO_JSON). */
+static
+const char* _sir_format_json(sir_options opts, sirbuf* buf) {
+    char* out  = buf->output;
+    size_t len = 0;
+
+    _sir_json_put(out, &len, "{", 1);
+
+    if (!_sir_bittest(opts, SIRO_NOTIME)) {
+        /* ISO 8601, in UTC; the date and time only change once a second. */
+        if (buf->time != _sir_json_last_sec) {
+            struct tm tmbuf;
+            if (NULL != _sir_gmtime(&buf->time, &tmbuf) &&
+                0 != strftime(_sir_json_timestamp, SIR_MAXTIME, "%Y-%m-%dT%H:%M:%S", &tmbuf))
+                _sir_json_last_sec = buf->time;
+        }
+
+        char iso[SIR_MAXTIME + SIR_MAXMSEC + 1] = {0};
+        size_t iso_len = strnlen(_sir_json_timestamp, SIR_MAXTIME);
+        (void)memcpy(iso, _sir_json_timestamp, iso_len);
+#if defined(SIR_MSEC_TIMER)
+        if (!_sir_bittest(opts, SIRO_NOMSEC)) {
+            size_t msec_len = strnlen(buf->msec, SIR_MAXMSEC);
+            (void)memcpy(iso + iso_len, buf->msec, msec_len);
+            iso_len += msec_len;
+        }
+#endif
+        iso[iso_len++] = 'Z';
+        _sir_json_field(out, &len, "time", iso, iso_len, true);
+    }
+
+    if (!_sir_bittest(opts, SIRO_NOLEVEL)) {
+        size_t idx        = _sir_levelidx(buf->level_num);
+        const char* level = idx < SIR_NUMLEVELS ? _sir_json_levels[idx] : SIR_UNKNOWN;
+        _sir_json_field(out, &len, "level", level, strlen(level), true);
+    }
+
+    if (!_sir_bittest(opts, SIRO_NONAME) && _sir_validstrnofail(buf->name))
+        _sir_json_field(out, &len, "name", buf->name, strnlen(buf->name, SIR_MAXNAME), true);
+
+    if (!_sir_bittest(opts, SIRO_NOPID) && _sir_validstrnofail(buf->pid))
+        _sir_json_field(out, &len, "pid", buf->pid, strnlen(buf->pid, SIR_MAXPID), false);
+
+    if (!_sir_bittest(opts, SIRO_NOTID) && _sir_validstrnofail(buf->tid))
+        _sir_json_field(out, &len, "tid", buf->tid, strnlen(buf->tid, SIR_MAXPID), true);
+
+    if (!_sir_bittest(opts, SIRO_NOHOST) && _sir_validstrnofail(buf->hostname))
+        _sir_json_field(out, &len, "host", buf->hostname, strnlen(buf->hostname, SIR_MAXHOST),
+            true);
+
+    _sir_json_field(out, &len, "msg", buf->message, strnlen(buf->message, SIR_MAXMESSAGE), true);
+
+    for (size_t n = 0; n < buf->field_count; n++) {
+        char num[SIR_MAXKVNUM];
+        size_t val_len      = 0;
+        const sir_kv* field = &buf->fields[n];
+        const char* val     = _sir_kv_tostr(&field->value, num, &val_len);
+        bool quote          = SIRKV_STR == field->value.type;
+
+        /* JSON has no representation of infinity or NaN. */
+        if (SIRKV_FLOAT == field->value.type && !isfinite(field->value.v.f)) {
+            val     = "null";
+            val_len = 4;
+        }
+
+        _sir_json_field(out, &len, field->key, val, val_len, quote);
+    }
+
+    out[len++] = '}';
+    (void)memcpy(out + len, SIR_EOL, sizeof(SIR_EOL) - 1);
+    len       += sizeof(SIR_EOL) - 1;
+    out[len]   = '\0';
+
+    buf->output_len = len;
+    return out;
+}
+
 const char* _sir_format(bool styling, sir_options opts, sirbuf* buf) {
+    if (_sir_validptr(buf) && _sir_bittest(opts, SIRO_JSON))
+        return _sir_format_json(opts, buf);
+
     if (_sir_validptr(buf)) {
         bool first = true;
 
@@ -805,6 +1659,9 @@ const char* _sir_format(bool styling, sir_options opts, sirbuf* buf) {
             if (!_sir_bittest(opts, SIRO_NOMSEC))
                 (void)_sir_strncat(buf->output, SIR_MAXOUTPUT, buf->msec, SIR_MAXMSEC);
 #endif
+
+            if (_sir_validstrnofail(buf->time_suffix))
+                (void)_sir_strncat(buf->output, SIR_MAXOUTPUT, buf->time_suffix, 1);
         }
 
         if (!_sir_bittest(opts, SIRO_NOHOST) && _sir_validstrnofail(buf->hostname)) {
@@ -859,6 +1716,15 @@ const char* _sir_format(bool styling, sir_options opts, sirbuf* buf) {
 
         (void)_sir_strncat(buf->output, SIR_MAXOUTPUT, buf->message, SIR_MAXMESSAGE);
 
+        if (buf->field_count > 0) {
+            /* leave room for the style reset and EOL. */
+            size_t len   = strnlen(buf->output, SIR_MAXOUTPUT);
+            size_t limit = SIR_MAXOUTPUT - SIR_MAXSTYLE - 3;
+            if (len < limit)
+                (void)_sir_logfmt_fields(buf->output + len, limit - len, buf->fields,
+                    buf->field_count);
+        }
+
         if (styling)
             (void)_sir_strncat(buf->output, SIR_MAXOUTPUT, SIR_ESC_RST, SIR_MAXSTYLE);
 
@@ -940,6 +1806,16 @@ bool _sir_syslog_open(sir_syslog_dest* ctx) {
     _sir_selflog("opening log (levels: %04"PRIx16", options: %08"PRIx32")", ctx->levels,
         ctx->opts);
 
+# if defined(SIR_NETSYSLOG_ENABLED)
+    if (_sir_validstrnofail(ctx->address)) {
+        if (!_sir_netsyslog_open(ctx))
+            return false;
+
+        _sir_setbitshigh(&ctx->_state.mask, SIRSL_IS_OPEN | SIRSL_NATIVE);
+        return true;
+    }
+# endif
+
 # if defined(SIR_OS_LOG_ENABLED)
     ctx->_state.logger = (void*)os_log_create(ctx->identity, ctx->category);
     _sir_selflog("opened os_log ('%s', '%s')", ctx->identity, ctx->category);
@@ -981,15 +1857,31 @@ bool _sir_syslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest
         return _sir_seterror(_SIR_E_INVALID);
     }
 
+# if defined(SIR_NETSYSLOG_ENABLED)
+    if (_sir_bittest(ctx->_state.mask, SIRSL_NATIVE))
+        return _sir_netsyslog_write(level, buf, ctx);
+# endif
+
+    /* the system logging facility only takes text, so fields go on the end. */
+    const char* message = buf->message;
+    char with_fields[SIR_MAXMESSAGE];
+    if (buf->field_count > 0) {
+        size_t msg_len = strnlen(buf->message, SIR_MAXMESSAGE - 1);
+        (void)memcpy(with_fields, buf->message, msg_len);
+        (void)_sir_logfmt_fields(with_fields + msg_len, SIR_MAXMESSAGE - msg_len,
+            buf->fields, buf->field_count);
+        message = with_fields;
+    }
+
 # if defined(SIR_OS_LOG_ENABLED)
     if (SIRL_DEBUG == level)
-        os_log_debug((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, buf->message);
+        os_log_debug((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, message);
     else if (SIRL_INFO == level || SIRL_NOTICE == level)
-        os_log_info((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, buf->message);
+        os_log_info((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, message);
     else if (SIRL_WARN == level || SIRL_ERROR == level)
-        os_log_error((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, buf->message);
+        os_log_error((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, message);
     else if (SIRL_CRIT == level || SIRL_ALERT == level || SIRL_EMERG == level)
-        os_log_fault((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, buf->message);
+        os_log_fault((os_log_t)ctx->_state.logger, SIR_OS_LOG_FORMAT, message);
 
     return true;
 # elif defined(SIR_SYSLOG_ENABLED)
@@ -1010,7 +1902,7 @@ bool _sir_syslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest
         // GCOVR_EXCL_STOP
     }
 
-    syslog(syslog_level, "%s", buf->message);
+    syslog(syslog_level, "%s", message);
     return true;
 # elif defined(SIR_EVENTLOG_ENABLED)
     const EVENT_DESCRIPTOR* edesc = NULL;
@@ -1030,18 +1922,18 @@ bool _sir_syslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest
         return _sir_seterror(_SIR_E_INTERNAL);
 
 #  if defined(__HAVE_STDC_SECURE_OR_EXT1__)
-    size_t msg_len = strnlen_s(buf->message, SIR_MAXMESSAGE) + 1;
+    size_t msg_len = strnlen_s(message, SIR_MAXMESSAGE) + 1;
 #  else
-    size_t msg_len = strnlen(buf->message, SIR_MAXMESSAGE) + 1;
+    size_t msg_len = strnlen(message, SIR_MAXMESSAGE) + 1;
 #  endif
-    int wlen = MultiByteToWideChar(CP_UTF8, 0UL, buf->message, (int)msg_len, NULL, 0);
+    int wlen = MultiByteToWideChar(CP_UTF8, 0UL, message, (int)msg_len, NULL, 0);
     if (wlen <= 0)
         return _sir_handlewin32err(GetLastError());
 
     DWORD write = 1UL;
     wchar_t* wmsg = calloc(wlen, sizeof(wchar_t));
     if (NULL != wmsg) {
-        int conv = MultiByteToWideChar(CP_UTF8, 0UL, buf->message, (int)msg_len, wmsg, wlen);
+        int conv = MultiByteToWideChar(CP_UTF8, 0UL, message, (int)msg_len, wmsg, wlen);
         if (conv > 0) {
             EVENT_DATA_DESCRIPTOR eddesc = {0};
             EventDataDescCreate(&eddesc, wmsg, (ULONG)(wlen * sizeof(wchar_t)));
@@ -1058,7 +1950,7 @@ bool _sir_syslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest
     return ERROR_SUCCESS == write;
 # else
     SIR_UNUSED(level);
-    SIR_UNUSED(buf);
+    SIR_UNUSED(message);
     SIR_UNUSED(ctx);
     return false;
 # endif
@@ -1100,6 +1992,17 @@ bool _sir_syslog_updated(sirinit* si, const sir_update_config_data* data) {
         /* for event log, if initialized and open already, only need to reconfigure
          * if identity changed. */
         must_init = (!is_init || !is_open) || identity;
+# endif
+# if defined(SIR_NETSYSLOG_ENABLED)
+        bool address = _sir_bittest(si->d_syslog._state.mask, SIRSL_ADDRESS);
+        bool native  = _sir_bittest(si->d_syslog._state.mask, SIRSL_NATIVE);
+
+        /* the native transport formats each message itself, so it only needs to
+         * reconnect if the address changed (or is being switched on or off). */
+        if (native || address) {
+            _sir_selflog("native: %u, address: %u", native, address);
+            must_init = (!is_init || !is_open) || address;
+        }
 # endif
         bool init = true;
         if (must_init) {
@@ -1134,6 +2037,14 @@ bool _sir_syslog_close(sir_syslog_dest* ctx) {
         return true;
     }
 
+# if defined(SIR_NETSYSLOG_ENABLED)
+    if (_sir_bittest(ctx->_state.mask, SIRSL_NATIVE)) {
+        _sir_setbitslow(&ctx->_state.mask, SIRSL_IS_OPEN | SIRSL_NATIVE);
+        _sir_selflog("closing native transport");
+        return _sir_netsyslog_close();
+    }
+# endif
+
 # if defined(SIR_OS_LOG_ENABLED)
     /* Evidently, you don't need to close the handle returned from os_log_create(), and
      * if you make that call again, you'll get the same cached value. so let's keep the
@@ -1179,26 +2090,60 @@ void _sir_syslog_reset(sir_syslog_dest* ctx) {
 }
 
 const char* _sir_formattedlevelstr(sir_level level) {
-    static const size_t low  = 0;
-    static const size_t high = SIR_NUMLEVELS - 1;
+    size_t idx = _sir_levelidx(level);
+    if (idx >= SIR_NUMLEVELS)
+        return SIR_UNKNOWN;
+
+    SIR_ASSERT(sir_level_to_str_map[idx].level == level);
+    return sir_level_to_str_map[idx].fmt;
+}
+
+bool _sir_clock_gettime(int clock, time_t* tbuf, long* msecbuf) {
+    long nsec   = 0L;
+    bool retval = _sir_clock_gettimens(clock, tbuf, &nsec);
+    if (msecbuf)
+        *msecbuf = nsec / 1000000L;
+    return retval;
+}
 
-    const char* retval = SIR_UNKNOWN;
+/** Refreshes the calibration of the time stamp counter in the current context. */
+static
+bool _sir_tsc_recalibrate_ctx(void) {
+    _SIR_LOCK_SECTION(sirconfig, _cfg, SIRMI_CONFIG, false);
 
-    _SIR_DECLARE_BIN_SEARCH(low, high);
-    _SIR_BEGIN_BIN_SEARCH()
+    bool retval = !_cfg->state.tsc.valid || _sir_tsc_calibrate(&_cfg->state.tsc);
+    if (!retval)
+        _sir_selflog("error: failed to calibrate the time stamp counter; using the"
+                     " wall clock instead");
 
-    if (sir_level_to_str_map[_mid].level == level) {
-        retval = sir_level_to_str_map[_mid].fmt;
-        break;
+    _SIR_UNLOCK_SECTION(SIRMI_CONFIG);
+    return retval;
+}
+
+bool _sir_tsc_recalibrate(void) {
+    /* _sir_init holds the list while it starts the ticker thread, and
+     * _sir_cleanup may be waiting for this thread to exit; try again on the
+     * next tick rather than wait. */
+    if (!_sir_mutextrylock(&_sir_ctx_list.mutex))
+        return true;
+
+    bool retval       = true;
+    sir_context* prev = _sir_ctx_use(NULL);
+
+    for (sir_context* ctx = _sir_ctx_list.head; ctx; ctx = ctx->next) {
+        (void)_sir_ctx_use(ctx);
+        _sir_eqland(retval, _sir_tsc_recalibrate_ctx());
     }
 
-    _SIR_ITERATE_BIN_SEARCH((sir_level_to_str_map[_mid].level < level ? 1 : -1));
-    _SIR_END_BIN_SEARCH();
+    (void)_sir_ctx_use(prev);
+
+    bool unlocked = _sir_mutexunlock(&_sir_ctx_list.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
 
     return retval;
 }
 
-bool _sir_clock_gettime(int clock, time_t* tbuf, long* msecbuf) {
+bool _sir_clock_gettimens(int clock, time_t* tbuf, long* nsecbuf) {
     if (tbuf) {
 #if defined(SIR_MSEC_POSIX)
         struct timespec ts = {0};
@@ -1207,11 +2152,11 @@ bool _sir_clock_gettime(int clock, time_t* tbuf, long* msecbuf) {
 
         if (0 == ret) {
             *tbuf = ts.tv_sec;
-            if (msecbuf)
-                *msecbuf = ts.tv_nsec / 1000000L;
+            if (nsecbuf)
+                *nsecbuf = ts.tv_nsec;
         } else {
-            if (msecbuf)
-                *msecbuf = 0L;
+            if (nsecbuf)
+                *nsecbuf = 0L;
             return _sir_handleerr(errno);
         }
 #elif defined(SIR_MSEC_WIN32)
@@ -1221,27 +2166,20 @@ bool _sir_clock_gettime(int clock, time_t* tbuf, long* msecbuf) {
         FILETIME ftutc = {0};
         GetSystemTimePreciseAsFileTime(&ftutc);
 
+        /* 100-nanosecond intervals since 1601-01-01. */
         ULARGE_INTEGER ftnow = {0};
         ftnow.HighPart = ftutc.dwHighDateTime;
         ftnow.LowPart  = ftutc.dwLowDateTime;
-        ftnow.QuadPart = (ULONGLONG)((ftnow.QuadPart - uepoch) / 10000000ULL);
+        ftnow.QuadPart = ftnow.QuadPart - uepoch;
 
-        *tbuf = (time_t)ftnow.QuadPart;
-
-        SYSTEMTIME st = {0};
-        if (FileTimeToSystemTime(&ftutc, &st)) {
-            if (msecbuf)
-                *msecbuf = (long)st.wMilliseconds;
-        } else {
-            if (msecbuf)
-                *msecbuf = 0L;
-            return _sir_handlewin32err(GetLastError());
-        }
+        *tbuf = (time_t)(ftnow.QuadPart / 10000000ULL);
+        if (nsecbuf)
+            *nsecbuf = (long)((ftnow.QuadPart % 10000000ULL) * 100ULL);
 #else
         SIR_UNUSED(clock);
         (void)time(tbuf);
-        if (msecbuf)
-            *msecbuf = 0L;
+        if (nsecbuf)
+            *nsecbuf = 0L;
 #endif
         return true;
     }
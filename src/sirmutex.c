@@ -34,7 +34,136 @@
 #include "sir/internal.h"
 #include "sir/platform.h"
 
-#if !defined(__WIN__) /* pthread implementation */
+#if defined(SIR_ADAPTIVE_MUTEX) /* spin, then futex implementation */
+/**
+ * Uncontended, locking and unlocking are each one atomic instruction. A thread
+ * that finds the mutex locked spins for a while, since libsir holds its locks
+ * very briefly, and only then sleeps in the kernel; `state` records whether
+ * anyone is asleep, so that unlocking only makes a system call if so (U.
+ * Drepper, "Futexes Are Tricky"). Like the pthread implementation, the mutex
+ * is recursive.
+ */
+static _sir_thread_local pid_t _sir_mutex_tid;
+
+pid_t _sir_mutexself(void) {
+    if (0 == _sir_mutex_tid)
+        _sir_mutex_tid = _sir_gettid();
+    return _sir_mutex_tid;
+}
+
+static inline
+void _sir_cpu_relax(void) {
+# if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+# elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+# endif
+}
+
+int _sir_futexwait(int* addr, int val, const sir_wait* abstime) {
+    long ret = abstime
+        ? syscall(SYS_futex, addr, FUTEX_WAIT_BITSET_PRIVATE | FUTEX_CLOCK_REALTIME,
+                  val, abstime, NULL, FUTEX_BITSET_MATCH_ANY)
+        : syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+    return 0 == ret ? 0 : errno;
+}
+
+void _sir_futexwake(int* addr, int count) {
+    (void)syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+bool _sir_mutexcreate(sir_mutex* mutex) {
+    if (_sir_validptr(mutex)) {
+        mutex->state = 0;
+        mutex->owner = 0;
+        mutex->depth = 0U;
+        return true;
+    }
+
+    return false;
+}
+
+bool _sir_mutexlock(sir_mutex* mutex) {
+    if (!_sir_validptr(mutex))
+        return false;
+
+    pid_t self = _sir_mutexself();
+    if (self == __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED)) {
+        mutex->depth++;
+        return true;
+    }
+
+    int expected = 0;
+    bool locked  = false;
+    for (unsigned spin = 0U; !locked && spin < SIR_MUTEX_SPIN; spin++) {
+        expected = __atomic_load_n(&mutex->state, __ATOMIC_RELAXED);
+        if (0 == expected) {
+            locked = __atomic_compare_exchange_n(&mutex->state, &expected, 1, false,
+                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        } else if (2 == expected) {
+            break; /* others are already asleep; queue up behind them. */
+        } else {
+            _sir_cpu_relax();
+        }
+    }
+
+    if (!locked) {
+        while (0 != __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE))
+            (void)_sir_futexwait(&mutex->state, 2, NULL);
+    }
+
+    __atomic_store_n(&mutex->owner, self, __ATOMIC_RELAXED);
+    mutex->depth = 1U;
+
+    return true;
+}
+
+bool _sir_mutextrylock(sir_mutex* mutex) {
+    if (!_sir_validptr(mutex))
+        return false;
+
+    pid_t self = _sir_mutexself();
+    if (self == __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED)) {
+        mutex->depth++;
+        return true;
+    }
+
+    int expected = 0;
+    if (!__atomic_compare_exchange_n(&mutex->state, &expected, 1, false,
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return _sir_handleerr(EBUSY);
+
+    __atomic_store_n(&mutex->owner, self, __ATOMIC_RELAXED);
+    mutex->depth = 1U;
+
+    return true;
+}
+
+bool _sir_mutexunlock(sir_mutex* mutex) {
+    if (!_sir_validptr(mutex))
+        return false;
+
+    if (_sir_mutexself() != __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED))
+        return _sir_handleerr(EPERM);
+
+    if (--mutex->depth > 0U)
+        return true;
+
+    __atomic_store_n(&mutex->owner, 0, __ATOMIC_RELAXED);
+    if (2 == __atomic_exchange_n(&mutex->state, 0, __ATOMIC_RELEASE))
+        _sir_futexwake(&mutex->state, 1);
+
+    return true;
+}
+
+bool _sir_mutexdestroy(sir_mutex* mutex) {
+    if (_sir_validptr(mutex))
+        return 0 == __atomic_load_n(&mutex->state, __ATOMIC_RELAXED)
+            ? true : _sir_handleerr(EBUSY);
+
+    return false;
+}
+#elif !defined(__WIN__) /* pthread implementation */
 bool _sir_mutexcreate(sir_mutex* mutex) {
     if (_sir_validptr(mutex)) {
         pthread_mutexattr_t attr;
@@ -132,4 +261,33 @@ bool _sir_mutexdestroy(sir_mutex* mutex) {
 
     return false;
 }
-#endif /* !__WIN__ */
+#endif /* SIR_ADAPTIVE_MUTEX */
+
+bool _sir_mutexlock_waited(sir_mutex* mutex, bool* waited) {
+    if (!_sir_validptr(mutex) || !_sir_validptr(waited))
+        return false;
+
+#if defined(SIR_ADAPTIVE_MUTEX)
+    pid_t self   = _sir_mutexself();
+    int expected = 0;
+    *waited      = self != __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED) &&
+        !__atomic_compare_exchange_n(&mutex->state, &expected, 1, false,
+            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    if (*waited)
+        return _sir_mutexlock(mutex);
+
+    if (0U == mutex->depth)
+        __atomic_store_n(&mutex->owner, self, __ATOMIC_RELAXED);
+    mutex->depth++;
+    return true;
+#elif !defined(__WIN__)
+    int op  = pthread_mutex_trylock(mutex);
+    *waited = EBUSY == op;
+    if (0 == op)
+        return true;
+    return *waited ? _sir_mutexlock(mutex) : _sir_handleerr(op);
+#else /* __WIN__ */
+    *waited = FALSE == TryEnterCriticalSection(mutex);
+    return *waited ? _sir_mutexlock(mutex) : true;
+#endif
+}
@@ -0,0 +1,897 @@
+/*
+ * sirnetsyslog.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#include "sir/netsyslog.h"
+#include "sir/internal.h"
+#include "sir/mutex.h"
+#include "sir/ticker.h"
+
+#if defined(SIR_NETSYSLOG_ENABLED)
+# if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__)
+#  define SIR_HAVE_SENDMMSG
+# endif
+
+/* the header and structured data can take up to ~800 bytes. */
+# if SIR_NETSYSLOG_MAXFRAME < 1024
+#  error "SIR_NETSYSLOG_MAXFRAME must be at least 1024"
+# endif
+
+/** The URI schemes accepted by ::_sir_netsyslog_validaddr. */
+# define SIR_NETSYSLOG_UNIX    "unix:"
+# define SIR_NETSYSLOG_UDP     "udp:"
+# define SIR_NETSYSLOG_JOURNAL "journal:"
+
+/** Kinds of system logger address. */
+typedef enum {
+    SIR_NSL_UNIX = 0, /**< RFC 5424 over a Unix domain datagram socket. */
+    SIR_NSL_UDP,      /**< RFC 5424 over UDP. */
+    SIR_NSL_JOURNAL   /**< systemd journal native protocol. */
+} sir_netsyslog_kind;
+
+/** A parsed system logger address. */
+typedef struct {
+    sir_netsyslog_kind kind;
+    char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    char host[SIR_MAX_SYSLOG_ADDR];
+    char port[8];
+} sir_netsyslog_addr;
+
+/** State of the RFC 5424 transport, which is shared by every context that has
+ * the native transport open; protected by `mutex`. */
+static struct {
+    int fd;
+    size_t users;            /**< Opens not yet matched by a close. */
+    size_t count;
+    size_t lens[SIR_NETSYSLOG_BATCH];
+    char frames[SIR_NETSYSLOG_BATCH][SIR_NETSYSLOG_MAXFRAME];
+    sir_syslog_stats stats;
+    sir_netsyslog_addr addr; /**< Where `fd` is (or was) connected. */
+    bool lost;               /**< `fd` was closed because the receiver went away. */
+    int64_t next_attempt;    /**< When to try reconnecting (msec; interval clock). */
+    uint32_t backoff;        /**< The wait after the next failed attempt (msec). */
+    uint32_t epoch;          /**< Incremented whenever the transport is opened or closed. */
+    sir_mutex mutex;
+} _sir_nsl = {-1, 0, 0, {0}, {{0}}, {0}, {SIR_NSL_UNIX, {0}, {0}, {0}}, false, 0, 0U, 0U,
+    SIR_MUTEX_INIT};
+
+/** Per-thread cache of the formatted date and time (to the second), in UTC. */
+static _sir_thread_local time_t _sir_nsl_last_sec = -1;
+static _sir_thread_local char _sir_nsl_timestamp[24] = {0};
+
+static
+bool _sir_netsyslog_setpath(sir_netsyslog_addr* out, sir_netsyslog_kind kind,
+    const char* path) {
+    size_t len = strnlen(path, sizeof(out->path));
+    if (0 == len || len >= sizeof(out->path))
+        return false;
+
+    out->kind = kind;
+    (void)memcpy(out->path, path, len);
+    return true;
+}
+
+static
+bool _sir_netsyslog_parseaddr(const char* address, sir_netsyslog_addr* out) {
+    (void)memset(out, 0, sizeof(sir_netsyslog_addr));
+
+    if (0 == strncmp(address, SIR_NETSYSLOG_UNIX, strlen(SIR_NETSYSLOG_UNIX)))
+        return _sir_netsyslog_setpath(out, SIR_NSL_UNIX,
+            address + strlen(SIR_NETSYSLOG_UNIX));
+
+# if defined(SIR_JOURNAL_ENABLED)
+    if (0 == strncmp(address, SIR_NETSYSLOG_JOURNAL, strlen(SIR_NETSYSLOG_JOURNAL))) {
+        const char* path = address + strlen(SIR_NETSYSLOG_JOURNAL);
+        return _sir_netsyslog_setpath(out, SIR_NSL_JOURNAL,
+            '\0' != *path ? path : SIR_JOURNAL_SOCKET);
+    }
+# endif
+
+    if (0 == strncmp(address, SIR_NETSYSLOG_UDP, strlen(SIR_NETSYSLOG_UDP))) {
+        const char* host = address + strlen(SIR_NETSYSLOG_UDP);
+        const char* port = strrchr(host, ':');
+        if (NULL == port || port == host)
+            return false;
+
+        size_t host_len = (size_t)(port - host);
+        if ('[' == host[0]) { /* [IPv6]:port */
+            if (host_len < 3 || ']' != host[host_len - 1])
+                return false;
+            host++;
+            host_len -= 2;
+        }
+
+        port++;
+        size_t port_len = strnlen(port, sizeof(out->port));
+        if (0 == host_len || host_len >= sizeof(out->host) || 0 == port_len ||
+            port_len >= sizeof(out->port) || strspn(port, "0123456789") != port_len)
+            return false;
+
+        (void)memcpy(out->host, host, host_len);
+        (void)memcpy(out->port, port, port_len);
+        out->kind = SIR_NSL_UDP;
+        return true;
+    }
+
+    return false;
+}
+
+bool _sir_netsyslog_validaddr(const char* address) {
+    sir_netsyslog_addr addr;
+    if (!_sir_validstrnofail(address) || !_sir_netsyslog_parseaddr(address, &addr))
+        return _sir_seterror(_SIR_E_INVALID);
+    return true;
+}
+
+/** Whether the transport is in use by another context, connected somewhere other
+ * than `addr`. `owner` is whether the caller is one of its users. Must hold the
+ * transport mutex. */
+static inline
+bool _sir_netsyslog_conflicts(const sir_netsyslog_addr* addr, bool owner) {
+    size_t others = _sir_nsl.users - (owner && _sir_nsl.users > 0 ? 1 : 0);
+    return others > 0 && 0 != memcmp(addr, &_sir_nsl.addr, sizeof(*addr));
+}
+
+bool _sir_netsyslog_canopen(const char* address, bool owner) {
+    sir_netsyslog_addr addr;
+    if (!_sir_validstrnofail(address) || !_sir_netsyslog_parseaddr(address, &addr))
+        return _sir_seterror(_SIR_E_INVALID);
+
+    if (!_sir_mutexlock(&_sir_nsl.mutex))
+        return false;
+
+    bool conflicts = _sir_netsyslog_conflicts(&addr, owner);
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    if (conflicts) {
+        _sir_selflog("error: the native transport is in use by another context; not"
+                     " switching to '%s'", address);
+        return _sir_seterror(_SIR_E_INVALID);
+    }
+
+    return true;
+}
+
+/** Connects a new non-blocking datagram socket to the parsed address. */
+static
+int _sir_netsyslog_connect(const sir_netsyslog_addr* addr) {
+    int fd = -1;
+
+    if (SIR_NSL_UDP != addr->kind) {
+        struct sockaddr_un sun;
+        (void)memset(&sun, 0, sizeof(sun));
+        sun.sun_family = AF_UNIX;
+        (void)memcpy(sun.sun_path, addr->path, strnlen(addr->path, sizeof(sun.sun_path)));
+
+        fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (-1 == fd) {
+            (void)_sir_handleerr(errno);
+            return -1;
+        }
+
+        if (0 != connect(fd, (struct sockaddr*)&sun, sizeof(sun))) {
+            (void)_sir_handleerr(errno);
+            _sir_safeclose(&fd);
+            return -1;
+        }
+    } else {
+        struct addrinfo hints;
+        (void)memset(&hints, 0, sizeof(hints));
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags    = AI_NUMERICSERV;
+
+        struct addrinfo* res = NULL;
+        int gai = getaddrinfo(addr->host, addr->port, &hints, &res);
+        if (0 != gai) {
+            _sir_selflog("error: getaddrinfo('%s', '%s') failed: %s", addr->host,
+                addr->port, gai_strerror(gai));
+            (void)_sir_seterror(_SIR_E_INVALID);
+            return -1;
+        }
+
+        int err = 0;
+        for (const struct addrinfo* ai = res; NULL != ai; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (-1 == fd) {
+                err = errno;
+                continue;
+            }
+
+            if (0 == connect(fd, ai->ai_addr, ai->ai_addrlen))
+                break;
+
+            err = errno;
+            _sir_safeclose(&fd);
+        }
+
+        freeaddrinfo(res);
+
+        if (-1 == fd) {
+            (void)_sir_handleerr(err);
+            return -1;
+        }
+    }
+
+    int flags = fcntl(fd, F_GETFL);
+    if (-1 == flags || -1 == fcntl(fd, F_SETFL, flags | O_NONBLOCK) ||
+        -1 == fcntl(fd, F_SETFD, FD_CLOEXEC)) {
+        (void)_sir_handleerr(errno);
+        _sir_safeclose(&fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/** Returns the interval clock, in milliseconds. */
+static inline
+int64_t _sir_netsyslog_now(void) {
+    time_t sec = 0;
+    long nsec  = 0L;
+    (void)_sir_clock_gettimens(SIR_INTERVALCLOCK, &sec, &nsec);
+    return ((int64_t)sec * 1000) + (nsec / 1000000L);
+}
+
+/** Whether a send error means that the receiver has gone away (e.g., it was
+ * restarted), so the socket must be reconnected. */
+static inline
+bool _sir_netsyslog_gone(int err) {
+    return ECONNREFUSED == err || ENOTCONN == err || ENOENT == err ||
+        ECONNRESET == err || EPIPE == err;
+}
+
+/** Closes the socket after the receiver went away; the ticker thread tries to
+ * reconnect, with exponential backoff. Must hold the transport mutex. */
+static
+void _sir_netsyslog_lost(int err) {
+    _sir_selflog("error: lost the system logger (%s); retrying in %"PRIu32" msec",
+        strerror(err), _sir_nsl.backoff);
+
+    _sir_safeclose(&_sir_nsl.fd);
+    _sir_nsl.lost         = true;
+    _sir_nsl.next_attempt = _sir_netsyslog_now() + _sir_nsl.backoff;
+    _sir_nsl.backoff      = _sir_nsl.backoff * 2U > (uint32_t)SIR_NETSYSLOG_BACKOFF_MAX
+                          ? (uint32_t)SIR_NETSYSLOG_BACKOFF_MAX : _sir_nsl.backoff * 2U;
+}
+
+/** Reconnects the socket if the receiver went away, and it's time to try. The
+ * transport mutex is released while connecting, since that may resolve a host. */
+static
+void _sir_netsyslog_reconnect(void) {
+    if (!_sir_nsl.lost || _sir_netsyslog_now() < _sir_nsl.next_attempt)
+        return;
+
+    sir_netsyslog_addr addr = _sir_nsl.addr;
+    uint32_t epoch          = _sir_nsl.epoch;
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    int fd  = _sir_netsyslog_connect(&addr);
+    int err = errno;
+
+    bool locked = _sir_mutexlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    /* the transport may have been closed or reopened meanwhile. */
+    if (!_sir_nsl.lost || epoch != _sir_nsl.epoch) {
+        if (-1 != fd)
+            _sir_safeclose(&fd);
+        return;
+    }
+
+    if (-1 == fd) {
+        _sir_netsyslog_lost(err);
+        return;
+    }
+
+    _sir_selflog("reconnected to the system logger (fd: %d)", fd);
+    _sir_nsl.fd      = fd;
+    _sir_nsl.lost    = false;
+    _sir_nsl.backoff = SIR_NETSYSLOG_BACKOFF_MIN;
+    _sir_nsl.stats.reconnects++;
+}
+
+/** Sends everything queued. Must hold the transport mutex. */
+static
+bool _sir_netsyslog_send(void) {
+    size_t count = _sir_nsl.count;
+    size_t off   = 0;
+
+    _sir_nsl.count = 0;
+    if (0 == count || -1 == _sir_nsl.fd)
+        return true;
+
+    _sir_nsl.stats.batches++;
+
+# if defined(SIR_HAVE_SENDMMSG)
+    struct mmsghdr msgs[SIR_NETSYSLOG_BATCH];
+    struct iovec iov[SIR_NETSYSLOG_BATCH];
+
+    (void)memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (size_t n = 0; n < count; n++) {
+        iov[n].iov_base = _sir_nsl.frames[n];
+        iov[n].iov_len  = _sir_nsl.lens[n];
+        msgs[n].msg_hdr.msg_iov    = &iov[n];
+        msgs[n].msg_hdr.msg_iovlen = 1;
+    }
+# endif
+
+    while (off < count) {
+# if defined(SIR_HAVE_SENDMMSG)
+        int sent = sendmmsg(_sir_nsl.fd, &msgs[off], (unsigned int)(count - off),
+            MSG_DONTWAIT);
+# else
+        int sent = -1 == send(_sir_nsl.fd, _sir_nsl.frames[off], _sir_nsl.lens[off],
+            MSG_DONTWAIT) ? -1 : 1;
+# endif
+        if (sent > 0) {
+            _sir_nsl.stats.sent += (uint64_t)sent;
+            off += (size_t)sent;
+            continue;
+        }
+
+        if (EINTR == errno)
+            continue;
+
+        if (EAGAIN == errno || EWOULDBLOCK == errno || ENOBUFS == errno) {
+            /* the receiver can't keep up; don't block the caller. */
+            _sir_nsl.stats.dropped += count - off;
+            _sir_selflog("dropped %zu message(s): %s", count - off, strerror(errno));
+            return true;
+        }
+
+        if (_sir_netsyslog_gone(errno)) {
+            _sir_nsl.stats.dropped += count - off;
+            _sir_netsyslog_lost(errno);
+            return true;
+        }
+
+        /* some other error with this message (e.g., EMSGSIZE). */
+        _sir_selflog("error: failed to send message: %s", strerror(errno));
+        _sir_nsl.stats.dropped++;
+        off++;
+    }
+
+    return true;
+}
+
+bool _sir_netsyslog_open(const sir_syslog_dest* ctx) {
+    sir_netsyslog_addr addr;
+    if (!_sir_netsyslog_parseaddr(ctx->address, &addr))
+        return _sir_seterror(_SIR_E_INVALID);
+
+    int fd = _sir_netsyslog_connect(&addr);
+    if (-1 == fd)
+        return false;
+
+    if (!_sir_mutexlock(&_sir_nsl.mutex)) {
+        _sir_safeclose(&fd);
+        return false;
+    }
+
+    /* another context already has it open; if it's to the same address, keep
+     * the connection (and the counters). moving it elsewhere would silently take
+     * the other contexts' messages along, so that's refused. */
+    if (_sir_netsyslog_conflicts(&addr, false)) {
+        bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+        _sir_safeclose(&fd);
+
+        _sir_selflog("error: the native transport is in use by another context; not"
+                     " opening '%s'", ctx->address);
+        return _sir_seterror(_SIR_E_INVALID);
+    }
+
+    bool same = _sir_nsl.users > 0;
+    _sir_nsl.users++;
+
+    if (same) {
+        _sir_safeclose(&fd);
+    } else {
+        (void)_sir_netsyslog_send();
+        _sir_safeclose(&_sir_nsl.fd);
+
+        _sir_nsl.fd      = fd;
+        _sir_nsl.count   = 0;
+        _sir_nsl.addr    = addr;
+        _sir_nsl.lost    = false;
+        _sir_nsl.backoff = SIR_NETSYSLOG_BACKOFF_MIN;
+        _sir_nsl.epoch++;
+        (void)memset(&_sir_nsl.stats, 0, sizeof(_sir_nsl.stats));
+    }
+
+    size_t users  = _sir_nsl.users;
+    fd            = _sir_nsl.fd;
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    _sir_selflog("%s %s (fd: %d, users: %zu)", same ? "sharing" : "opened", ctx->address,
+        fd, users);
+
+    /* queued messages are sent periodically by the ticker thread, which also
+     * reconnects if the receiver goes away. */
+    return _sir_ticker_start();
+}
+
+/** Copies `src` into `dst` as an RFC 5424 header field (printable ASCII, no
+ * spaces), or "-" if `src` is empty. Returns the number of characters written. */
+static
+size_t _sir_netsyslog_field(char* dst, const char* src, size_t max) {
+    size_t len = 0;
+    for (; NULL != src && '\0' != src[len] && len < max; len++)
+        dst[len] = (src[len] > ' ' && src[len] < 0x7f) ? src[len] : '_';
+
+    if (0 == len)
+        dst[len++] = '-';
+
+    return len;
+}
+
+/** Copies `src` into `dst` as a structured data parameter value, escaping as
+ * required. Returns the number of characters written. */
+static
+size_t _sir_netsyslog_param(char* dst, const char* src, size_t max) {
+    size_t len = 0;
+    for (; '\0' != *src && len + 2 < max; src++) {
+        if ('"' == *src || '\\' == *src || ']' == *src)
+            dst[len++] = '\\';
+        dst[len++] = *src;
+    }
+    return len;
+}
+
+/** Formats an RFC 5424 message. Returns its length. */
+static
+size_t _sir_netsyslog_format(sir_level level, const sirbuf* buf,
+    const sir_syslog_dest* ctx, char frame[SIR_NETSYSLOG_MAXFRAME]) {
+    /* the time the message was logged; RFC 5424 allows up to six digits for the
+     * fraction of a second, but milliseconds are enough here. */
+    time_t now = buf->time;
+    long msec  = buf->time_msec;
+
+    if (now != _sir_nsl_last_sec) {
+        struct tm tmbuf;
+        if (NULL != gmtime_r(&now, &tmbuf) &&
+            0 != strftime(_sir_nsl_timestamp, sizeof(_sir_nsl_timestamp),
+                "%Y-%m-%dT%H:%M:%S", &tmbuf))
+            _sir_nsl_last_sec = now;
+    }
+
+    size_t idx = _sir_levelidx(level);
+    int pri    = (SIR_NETSYSLOG_FACILITY * 8) + (int)(idx < SIR_NUMLEVELS ? idx : 7);
+
+    /* <PRI>VERSION TIMESTAMP */
+    int hdr = snprintf(frame, SIR_NETSYSLOG_MAXFRAME, "<%d>1 %s.%03ldZ ", pri,
+        _sir_nsl_timestamp, msec);
+    if (hdr < 0)
+        return 0;
+
+    /* HOSTNAME APP-NAME PROCID MSGID; RFC 5424 limits are 255, 48, 128, 32. */
+    size_t len = (size_t)hdr;
+    len += _sir_netsyslog_field(frame + len, _sir_bittest(ctx->opts, SIRO_NOHOST)
+        ? NULL : buf->hostname, 255);
+    frame[len++] = ' ';
+    len += _sir_netsyslog_field(frame + len, ctx->identity, 48);
+    frame[len++] = ' ';
+    len += _sir_netsyslog_field(frame + len, _sir_bittest(ctx->opts, SIRO_NOPID)
+        ? NULL : buf->pid, 128);
+    frame[len++] = ' ';
+    len += _sir_netsyslog_field(frame + len, NULL, 32);
+    frame[len++] = ' ';
+
+    /* [SD-ID category="..." tid="..."] */
+    len += (size_t)snprintf(frame + len, SIR_NETSYSLOG_MAXFRAME - len,
+        "[" SIR_NETSYSLOG_SDID " category=\"");
+    len += _sir_netsyslog_param(frame + len, ctx->category, SIR_MAX_SYSLOG_CAT * 2);
+    frame[len++] = '"';
+
+    if (!_sir_bittest(ctx->opts, SIRO_NOTID) && _sir_validstrnofail(buf->tid)) {
+        len += (size_t)snprintf(frame + len, SIR_NETSYSLOG_MAXFRAME - len, " tid=\"");
+        len += _sir_netsyslog_param(frame + len, buf->tid, SIR_MAXPID * 2);
+        frame[len++] = '"';
+    }
+
+    /* key/value fields become parameters: PARAM-NAME is 1-32 printable ASCII
+     * characters, excluding '=', ' ', ']' and '"'. leave room for the MSG. */
+    for (size_t n = 0; n < buf->field_count; n++) {
+        char num[SIR_MAXKVNUM];
+        size_t val_len  = 0;
+        const char* val = _sir_kv_tostr(&buf->fields[n].value, num, &val_len);
+        if (len + 32 + (val_len * 2) + 4 > SIR_NETSYSLOG_MAXFRAME - 256)
+            continue;
+
+        frame[len++] = ' ';
+        size_t name = _sir_netsyslog_field(frame + len, buf->fields[n].key, 32);
+        for (size_t c = len; c < len + name; c++) {
+            if ('=' == frame[c] || ']' == frame[c] || '"' == frame[c])
+                frame[c] = '_';
+        }
+        len += name;
+        frame[len++] = '=';
+        frame[len++] = '"';
+        len += _sir_netsyslog_param(frame + len, val, (val_len * 2) + 2);
+        frame[len++] = '"';
+    }
+
+    frame[len++] = ']';
+    frame[len++] = ' ';
+
+    /* MSG */
+    size_t msg_len = strnlen(buf->message, SIR_MAXMESSAGE);
+    if (msg_len > SIR_NETSYSLOG_MAXFRAME - len)
+        msg_len = SIR_NETSYSLOG_MAXFRAME - len;
+
+    (void)memcpy(frame + len, buf->message, msg_len);
+    return len + msg_len;
+}
+
+# if defined(SIR_JOURNAL_ENABLED)
+/** Appends `KEY=value\n` to `dst`, cutting `val` short at `max` characters or
+ * the first newline. Returns the new length of `dst`, which is unchanged if
+ * the field doesn't fit. */
+static
+size_t _sir_journal_field(char* dst, size_t len, size_t size, const char* key,
+    const char* val, size_t max) {
+    size_t key_len = strlen(key);
+    size_t val_len = NULL != val ? strnlen(val, max) : 0;
+    if (val_len > 0) {
+        const char* nl = memchr(val, '\n', val_len);
+        if (NULL != nl)
+            val_len = (size_t)(nl - val);
+    }
+
+    if (len + key_len + val_len + 2 > size)
+        return len;
+
+    (void)memcpy(dst + len, key, key_len);
+    len += key_len;
+    dst[len++] = '=';
+    (void)memcpy(dst + len, val, val_len);
+    len += val_len;
+    dst[len++] = '\n';
+    return len;
+}
+
+/** Passes a record which is too large for a datagram to the journal in a
+ * sealed memfd, as sd_journal_sendv does. Must hold the transport mutex. */
+static
+bool _sir_journal_sendmemfd(const struct iovec* iov, size_t iovcnt) {
+#  if defined(MFD_CLOEXEC) && defined(F_ADD_SEALS)
+    int mfd = memfd_create("sir-journal", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (-1 == mfd)
+        return _sir_handleerr(errno);
+
+    for (size_t n = 0; n < iovcnt; n++) {
+        const char* ptr = iov[n].iov_base;
+        size_t left     = iov[n].iov_len;
+        while (left > 0) {
+            ssize_t wrote = write(mfd, ptr, left);
+            if (-1 == wrote) {
+                if (EINTR == errno)
+                    continue;
+                (void)_sir_handleerr(errno);
+                _sir_safeclose(&mfd);
+                return false;
+            }
+            ptr  += wrote;
+            left -= (size_t)wrote;
+        }
+    }
+
+    if (-1 == fcntl(mfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE |
+        F_SEAL_SEAL)) {
+        (void)_sir_handleerr(errno);
+        _sir_safeclose(&mfd);
+        return false;
+    }
+
+    union {
+        struct cmsghdr hdr;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    (void)memset(&control, 0, sizeof(control));
+
+    struct msghdr msg;
+    (void)memset(&msg, 0, sizeof(msg));
+    msg.msg_control    = &control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level     = SOL_SOCKET;
+    cmsg->cmsg_type      = SCM_RIGHTS;
+    cmsg->cmsg_len       = CMSG_LEN(sizeof(int));
+    (void)memcpy(CMSG_DATA(cmsg), &mfd, sizeof(int));
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(_sir_nsl.fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (-1 == sent && EINTR == errno);
+
+    int err = errno;
+    _sir_safeclose(&mfd);
+
+    return -1 != sent ? true : _sir_handleerr(err);
+#  else
+    SIR_UNUSED(iov);
+    SIR_UNUSED(iovcnt);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#  endif
+}
+
+/** Sends a record to the journal using its native protocol. */
+static
+bool _sir_journal_write(sir_level level, const sirbuf* buf, const sir_syslog_dest* ctx) {
+    char fields[1024 + SIR_MAX_SYSLOG_ID + SIR_MAX_SYSLOG_CAT + SIR_MAXMESSAGE];
+    char num[32];
+    size_t len = 0;
+
+    size_t idx = _sir_levelidx(level);
+    (void)snprintf(num, sizeof(num), "%d", (int)(idx < SIR_NUMLEVELS ? idx : 7));
+    len = _sir_journal_field(fields, len, sizeof(fields), "PRIORITY", num, sizeof(num));
+
+    (void)snprintf(num, sizeof(num), "%d", SIR_NETSYSLOG_FACILITY);
+    len = _sir_journal_field(fields, len, sizeof(fields), "SYSLOG_FACILITY", num, sizeof(num));
+    len = _sir_journal_field(fields, len, sizeof(fields), "SYSLOG_IDENTIFIER",
+        ctx->identity, SIR_MAX_SYSLOG_ID);
+    len = _sir_journal_field(fields, len, sizeof(fields), "SIR_CATEGORY",
+        ctx->category, SIR_MAX_SYSLOG_CAT);
+
+    if (!_sir_bittest(ctx->opts, SIRO_NOPID))
+        len = _sir_journal_field(fields, len, sizeof(fields), "SYSLOG_PID",
+            buf->pid, SIR_MAXPID);
+
+    if (!_sir_bittest(ctx->opts, SIRO_NOTID)) {
+        (void)snprintf(num, sizeof(num), "%ld", (long)_sir_gettid());
+        len = _sir_journal_field(fields, len, sizeof(fields), "TID", num, sizeof(num));
+    }
+
+    /* key/value fields, with names as the journal requires: upper-case
+     * letters, digits and underscores, starting with a letter. */
+    for (size_t n = 0; n < buf->field_count; n++) {
+        char key[64];
+        size_t key_len = 0;
+        for (const char* c = buf->fields[n].key; *c && key_len < sizeof(key) - 1; c++) {
+            if (0 == key_len && !isalpha((unsigned char)*c))
+                continue;
+            key[key_len++] = isalnum((unsigned char)*c)
+                ? (char)toupper((unsigned char)*c) : '_';
+        }
+        key[key_len] = '\0';
+
+        if (0 == key_len)
+            continue;
+
+        char val_num[SIR_MAXKVNUM];
+        size_t val_len  = 0;
+        const char* val = _sir_kv_tostr(&buf->fields[n].value, val_num, &val_len);
+        len = _sir_journal_field(fields, len, sizeof(fields), key, val, val_len);
+    }
+
+    if (NULL != buf->callsite) {
+        (void)snprintf(num, sizeof(num), "%"PRIu32, buf->callsite->line);
+        len = _sir_journal_field(fields, len, sizeof(fields), "CODE_FILE",
+            buf->callsite->file, 512);
+        len = _sir_journal_field(fields, len, sizeof(fields), "CODE_LINE", num, sizeof(num));
+        len = _sir_journal_field(fields, len, sizeof(fields), "CODE_FUNC",
+            buf->callsite->func, 256);
+    }
+
+    /* MESSAGE goes last, in the binary-safe form if it spans multiple lines. */
+    size_t msg_len = strnlen(buf->message, SIR_MAXMESSAGE);
+    uint8_t size_le[sizeof(uint64_t)];
+    for (size_t n = 0; n < sizeof(size_le); n++)
+        size_le[n] = (uint8_t)(((uint64_t)msg_len >> (n * 8)) & 0xff);
+
+    bool binary = NULL != memchr(buf->message, '\n', msg_len);
+    struct iovec iov[5];
+    size_t iovcnt = 0;
+    iov[iovcnt].iov_base   = fields;
+    iov[iovcnt++].iov_len  = len;
+    iov[iovcnt].iov_base   = binary ? "MESSAGE\n" : "MESSAGE=";
+    iov[iovcnt++].iov_len  = 8;
+    if (binary) {
+        iov[iovcnt].iov_base  = size_le;
+        iov[iovcnt++].iov_len = sizeof(size_le);
+    }
+    iov[iovcnt].iov_base   = (void*)buf->message;
+    iov[iovcnt++].iov_len  = msg_len;
+    iov[iovcnt].iov_base   = "\n";
+    iov[iovcnt++].iov_len  = 1;
+
+    struct msghdr msg;
+    (void)memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = iovcnt;
+
+    if (!_sir_mutexlock(&_sir_nsl.mutex))
+        return false;
+
+    /* while reconnecting, records are dropped (and counted). */
+    bool retval = -1 != _sir_nsl.fd || _sir_nsl.lost;
+    if (-1 == _sir_nsl.fd && _sir_nsl.lost) {
+        _sir_nsl.stats.dropped++;
+    } else if (retval) {
+        ssize_t sent;
+        do {
+            sent = sendmsg(_sir_nsl.fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        } while (-1 == sent && EINTR == errno);
+
+        if (-1 == sent && EMSGSIZE == errno) {
+            _sir_selflog("record too large for a datagram; using a memfd");
+            sent = _sir_journal_sendmemfd(iov, iovcnt) ? 0 : -1;
+        }
+
+        if (-1 != sent) {
+            _sir_nsl.stats.sent++;
+            _sir_nsl.stats.batches++;
+        } else {
+            /* don't block the caller, or fail the call, if journald is busy. */
+            int err = errno;
+            _sir_selflog("error: failed to send record: %s", strerror(err));
+            _sir_nsl.stats.dropped++;
+            if (_sir_netsyslog_gone(err))
+                _sir_netsyslog_lost(err);
+        }
+    } else {
+        (void)_sir_seterror(_SIR_E_INVALID);
+    }
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+# endif
+
+bool _sir_netsyslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest* ctx) {
+# if defined(SIR_JOURNAL_ENABLED)
+    if (0 == strncmp(ctx->address, SIR_NETSYSLOG_JOURNAL, strlen(SIR_NETSYSLOG_JOURNAL)))
+        return _sir_journal_write(level, buf, ctx);
+# endif
+
+    char frame[SIR_NETSYSLOG_MAXFRAME];
+    size_t len = _sir_netsyslog_format(level, buf, ctx, frame);
+    if (0 == len)
+        return _sir_seterror(_SIR_E_INTERNAL);
+
+    if (!_sir_mutexlock(&_sir_nsl.mutex))
+        return false;
+
+    /* while reconnecting, messages are dropped (and counted). */
+    bool retval = -1 != _sir_nsl.fd || _sir_nsl.lost;
+    if (-1 == _sir_nsl.fd && _sir_nsl.lost) {
+        _sir_nsl.stats.dropped++;
+    } else if (retval) {
+        (void)memcpy(_sir_nsl.frames[_sir_nsl.count], frame, len);
+        _sir_nsl.lens[_sir_nsl.count++] = len;
+
+        if (SIR_NETSYSLOG_BATCH == _sir_nsl.count ||
+            _sir_bittest(SIR_NETSYSLOG_FLUSH_LEVELS, level))
+            retval = _sir_netsyslog_send();
+    } else {
+        (void)_sir_seterror(_SIR_E_INVALID);
+    }
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+
+bool _sir_netsyslog_flush(void) {
+    if (!_sir_mutexlock(&_sir_nsl.mutex))
+        return false;
+
+    _sir_netsyslog_reconnect();
+    bool retval = _sir_netsyslog_send();
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+
+bool _sir_netsyslog_close(void) {
+    if (!_sir_mutexlock(&_sir_nsl.mutex))
+        return false;
+
+    bool retval = _sir_netsyslog_send();
+
+    /* only the last context to close it actually closes the socket. */
+    if (_sir_nsl.users > 0 && 0 == --_sir_nsl.users) {
+        if (-1 != _sir_nsl.fd) {
+            _sir_selflog("closing fd %d (sent: %"PRIu64", dropped: %"PRIu64")",
+                _sir_nsl.fd, _sir_nsl.stats.sent, _sir_nsl.stats.dropped);
+            _sir_safeclose(&_sir_nsl.fd);
+        }
+
+        _sir_nsl.lost = false;
+        _sir_nsl.epoch++;
+    }
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+
+bool _sir_netsyslog_getstats(sir_syslog_stats* stats) {
+    if (!_sir_validptr(stats) || !_sir_mutexlock(&_sir_nsl.mutex))
+        return false;
+
+    (void)memcpy(stats, &_sir_nsl.stats, sizeof(sir_syslog_stats));
+
+    bool unlocked = _sir_mutexunlock(&_sir_nsl.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return true;
+}
+#else /* !SIR_NETSYSLOG_ENABLED */
+bool _sir_netsyslog_validaddr(const char* address) {
+    SIR_UNUSED(address);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+}
+
+bool _sir_netsyslog_canopen(const char* address, bool owner) {
+    SIR_UNUSED(address);
+    SIR_UNUSED(owner);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+}
+
+bool _sir_netsyslog_open(const sir_syslog_dest* ctx) {
+    SIR_UNUSED(ctx);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+}
+
+bool _sir_netsyslog_write(sir_level level, const sirbuf* buf, const sir_syslog_dest* ctx) {
+    SIR_UNUSED(level);
+    SIR_UNUSED(buf);
+    SIR_UNUSED(ctx);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+}
+
+bool _sir_netsyslog_flush(void) {
+    return true;
+}
+
+bool _sir_netsyslog_close(void) {
+    return true;
+}
+
+bool _sir_netsyslog_getstats(sir_syslog_stats* stats) {
+    SIR_UNUSED(stats);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+}
+#endif /* SIR_NETSYSLOG_ENABLED */
@@ -31,6 +31,35 @@
 
 #include "sir/plugins.h"
 #include "sir/internal.h"
+#include "sir/mutex.h"
+#include "sir/condition.h"
+#include "sir/stats.h"
+#include "sir/probes.h"
+
+#if !defined(SIR_NO_PLUGINS)
+# if SIR_PLUGIN_QUEUE_BYTES < SIR_MAXMESSAGE + SIR_MAXOUTPUT + 2
+#  error "SIR_PLUGIN_QUEUE_BYTES must hold at least one message and line"
+# endif
+# if SIR_PLUGIN_QUEUE_BYTES < SIR_MAXMESSAGE + SIR_MAXOUTPUT + 2 + \
+    (SIR_MAXFIELDS * 2 * (SIR_MAXMESSAGE + 1))
+#  error "SIR_PLUGIN_QUEUE_BYTES must hold at least one message with all its fields"
+# endif
+# if SIR_PLUGIN_QUEUE_FIELDS < SIR_MAXFIELDS
+#  error "SIR_PLUGIN_QUEUE_FIELDS must be at least SIR_MAXFIELDS"
+# endif
+
+/** Creates a plugin's queue and starts its worker thread. */
+static bool _sir_plugin_queue_create(sir_plugin* plugin);
+
+/** Stops a plugin's worker thread after it delivers everything queued, and
+ * destroys its queue. */
+static void _sir_plugin_queue_destroy(sir_plugin* plugin);
+
+/** Publishes a copy of the cache's plugins for dispatch, then waits until no
+ * dispatch can still be using the previous copy. Must hold SIRMI_PLUGINCACHE. */
+static void _sir_plugin_cache_publish(sir_plugincache* spc);
+
+#endif
 
 sirpluginid _sir_plugin_load(const char* path) {
 #if !defined(SIR_NO_PLUGINS)
@@ -85,16 +114,8 @@ sirpluginid _sir_plugin_probe(sir_plugin* plugin) {
 #if !defined(SIR_NO_PLUGINS)
     sirpluginid retval = 0U;
     if (plugin) {
-# if SIR_PLUGIN_VCURRENT == SIR_PLUGIN_V1
-       /* if/when new versions of plugin interfaces are introduced, we will need to
-        * modify/extend the following code:
-        *
-        * - remove the enclosing #if
-        * - get the v1 exports (all versions will have v1 exports), resolve them,
-        * and call sir_plugin_query.
-        * - switch on version returned to resolve additional exports. this will
-        * necessitate additional versioned interface structures as members of the
-        * sir_plugin struct, e.g. ifacev1, ifacev2). */
+        /* all versions have the v1 exports; resolve them, call sir_plugin_query,
+         * then resolve any additional exports for the version it returns. */
         plugin->iface.query   = (sir_plugin_queryfn)
             _sir_plugin_getexport(plugin->handle, SIR_PLUGIN_EXPORT_QUERY);
         plugin->iface.init    = (sir_plugin_initfn)
@@ -115,9 +136,7 @@ sirpluginid _sir_plugin_probe(sir_plugin* plugin) {
             _sir_plugin_destroy(&plugin);
             return _sir_seterror(_SIR_E_PLUGINBAD);
         }
-# else
-#  error "plugin version not implemented"
-# endif
+
         /* query the plugin for information. */
         if (!plugin->iface.query(&plugin->info)) {
             _sir_selflog("error: plugin (path: '%s', addr: %p) returned false from"
@@ -137,6 +156,20 @@ sirpluginid _sir_plugin_probe(sir_plugin* plugin) {
             return 0U;
         }
 
+        /* v2: structured record batches. */
+        if (plugin->info.iface_ver >= SIR_PLUGIN_V2 &&
+            _sir_bittest(plugin->info.caps, SIR_PLUGINCAP_RECORDS)) {
+            plugin->iface.write_records = (sir_plugin_writerecsfn)
+                _sir_plugin_getexport(plugin->handle, SIR_PLUGIN_EXPORT_WRITERECS);
+            if (!plugin->iface.write_records) {
+                _sir_selflog("error: plugin (path: '%s', addr: %p) has the records"
+                             " capability, but no %s export!", plugin->path,
+                             plugin->handle, SIR_PLUGIN_EXPORT_WRITERECS);
+                _sir_plugin_destroy(&plugin);
+                return _sir_seterror(_SIR_E_PLUGINBAD);
+            }
+        }
+
         bool data_valid = true;
 
         /* verify level registration bitmask. */
@@ -181,6 +214,14 @@ sirpluginid _sir_plugin_probe(sir_plugin* plugin) {
         plugin->id    = FNV32_1a((const uint8_t*)&plugin->iface, sizeof(sir_pluginiface));
         plugin->valid = true;
 
+        /* messages are delivered to the plugin by its own worker thread. */
+        if (!_sir_plugin_queue_create(plugin)) {
+            _sir_selflog("error: failed to create queue for plugin (path: '%s', addr: %p)!",
+                plugin->path, plugin->handle);
+            _sir_plugin_destroy(&plugin);
+            return 0U;
+        }
+
         _sir_selflog("successfully validated plugin (path: '%s', id: %08"PRIx32"); properties:"
                      SIR_EOL "{"
                      SIR_EOL "\tversion = %"PRIu8".%"PRIu8".%"PRIu8
@@ -309,9 +350,17 @@ bool _sir_plugin_rem(sirpluginid id) {
         return false;
 
     _SIR_LOCK_SECTION(sir_plugincache, spc, SIRMI_PLUGINCACHE, false);
-    bool retval = _sir_plugin_cache_rem(spc, id);
+    sir_plugin* removed = NULL;
+    bool retval         = _sir_plugin_cache_rem(spc, id, &removed);
     _SIR_UNLOCK_SECTION(SIRMI_PLUGINCACHE);
 
+    /* nothing can be dispatching to it anymore; deliver what's queued, clean
+     * up, and unload without holding the lock. */
+    if (removed) {
+        _sir_plugin_destroy(&removed);
+        _sir_stats_rem(SIRSD_PLUGIN, id);
+    }
+
     return retval;
 #else
     SIR_UNUSED(id);
@@ -322,6 +371,9 @@ bool _sir_plugin_rem(sirpluginid id) {
 void _sir_plugin_destroy(sir_plugin** plugin) {
 #if !defined(SIR_NO_PLUGINS)
     if (_sir_validptrptr(plugin) && _sir_validptr(*plugin)) {
+        /* deliver anything still queued before the plugin goes away. */
+        _sir_plugin_queue_destroy(*plugin);
+
         bool unloaded = _sir_plugin_unload(*plugin);
         SIR_ASSERT_UNUSED(unloaded, unloaded);
 
@@ -333,6 +385,370 @@ void _sir_plugin_destroy(sir_plugin** plugin) {
 #endif
 }
 
+#if !defined(SIR_NO_PLUGINS)
+# if !defined(__WIN__)
+static void* _sir_plugin_worker(void* arg);
+# else
+static unsigned __stdcall _sir_plugin_worker(void* arg);
+# endif
+
+static
+bool _sir_plugin_queue_create(sir_plugin* plugin) {
+    sir_plugin_queue* queue = (sir_plugin_queue*)calloc(1, sizeof(sir_plugin_queue));
+    if (!queue)
+        return _sir_handleerr(errno);
+
+    queue->front  = (sir_plugin_batch*)calloc(1, sizeof(sir_plugin_batch));
+    queue->back   = (sir_plugin_batch*)calloc(1, sizeof(sir_plugin_batch));
+    queue->policy = SIR_PLUGIN_OVERFLOW_DEFAULT;
+
+    if (!queue->front || !queue->back) {
+        (void)_sir_handleerr(errno);
+        _sir_safefree(&queue->front);
+        _sir_safefree(&queue->back);
+        _sir_safefree(&queue);
+        return false;
+    }
+
+    bool created = _sir_mutexcreate(&queue->mutex);
+    _sir_eqland(created, _sir_condcreate(&queue->ready));
+    _sir_eqland(created, _sir_condcreate(&queue->room));
+
+    plugin->queue = queue;
+
+    if (created) {
+# if !defined(__WIN__)
+        int op  = pthread_create(&queue->thread, NULL, &_sir_plugin_worker, plugin);
+        created = 0 == op ? true : _sir_handleerr(op);
+# else /* __WIN__ */
+        queue->thread = (HANDLE)_beginthreadex(NULL, 0, &_sir_plugin_worker, plugin, 0, NULL);
+        created = NULL != queue->thread ? true : _sir_handleerr(errno);
+# endif
+    }
+
+    if (!created) {
+        (void)_sir_conddestroy(&queue->room);
+        (void)_sir_conddestroy(&queue->ready);
+        (void)_sir_mutexdestroy(&queue->mutex);
+        _sir_safefree(&queue->front);
+        _sir_safefree(&queue->back);
+        _sir_safefree(&plugin->queue);
+        return false;
+    }
+
+    return true;
+}
+
+static
+void _sir_plugin_queue_destroy(sir_plugin* plugin) {
+    sir_plugin_queue* queue = plugin->queue;
+    if (!queue)
+        return;
+
+    bool locked = _sir_mutexlock(&queue->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    queue->cancel = true;
+    (void)_sir_condbroadcast(&queue->ready);
+    (void)_sir_condbroadcast(&queue->room);
+
+    bool unlocked = _sir_mutexunlock(&queue->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+# if !defined(__WIN__)
+    int join = pthread_join(queue->thread, NULL);
+    SIR_ASSERT_UNUSED(0 == join, join);
+# else /* __WIN__ */
+    DWORD wait = WaitForSingleObject(queue->thread, INFINITE);
+    SIR_ASSERT_UNUSED(WAIT_OBJECT_0 == wait, wait);
+    (void)CloseHandle(queue->thread);
+# endif
+
+    _sir_selflog("plugin (path: '%s', id: %08"PRIx32") queue stats: queued: %"PRIu64
+                 ", delivered: %"PRIu64", failed: %"PRIu64", dropped: %"PRIu64,
+                 plugin->path, plugin->id, queue->stats.queued, queue->stats.delivered,
+                 queue->stats.failed, queue->stats.dropped);
+
+    bool destroyed = _sir_conddestroy(&queue->room);
+    _sir_eqland(destroyed, _sir_conddestroy(&queue->ready));
+    _sir_eqland(destroyed, _sir_mutexdestroy(&queue->mutex));
+    SIR_ASSERT_UNUSED(destroyed, destroyed);
+
+    _sir_safefree(&queue->front);
+    _sir_safefree(&queue->back);
+    _sir_safefree(&plugin->queue);
+}
+
+/** The length of a field's key or string value once copied into a queue;
+ * anything past ::SIR_MAXMESSAGE characters is cut off, so that one message
+ * always fits in an empty queue. */
+static inline
+size_t _sir_plugin_strlen(const char* str) {
+    return strnlen(str, SIR_MAXMESSAGE);
+}
+
+/** Copies the string at `*str` (truncated, see _sir_plugin_strlen) to `data`,
+ * and points `*str` at the copy. Returns the byte following the copy's
+ * terminator. */
+static inline
+char* _sir_plugin_copystr(char* data, const char** str) {
+    size_t len = _sir_plugin_strlen(*str);
+    (void)memcpy(data, *str, len);
+    data[len] = '\0';
+    *str = data;
+    return data + len + 1;
+}
+
+/** Copies a message into a plugin's queue, applying the overflow policy if it
+ * is full. */
+static
+bool _sir_plugin_enqueue(sir_plugin* plugin, sir_level level, const sirbuf* buf,
+    size_t msg_len, const char* line, size_t line_len) {
+    sir_plugin_queue* queue = plugin->queue;
+    size_t need = msg_len + line_len + 2;
+
+    /* the fields' keys and string values are copied along with the text. */
+    for (size_t n = 0; n < buf->field_count; n++) {
+        need += _sir_plugin_strlen(buf->fields[n].key) + 1;
+        if (SIRKV_STR == buf->fields[n].value.type)
+            need += _sir_plugin_strlen(buf->fields[n].value.v.s) + 1;
+    }
+
+    if (!_sir_mutexlock(&queue->mutex))
+        return false;
+
+    sir_plugin_batch* batch = queue->front;
+    while (SIR_PLUGIN_QUEUE_SIZE == batch->count || batch->used + need > SIR_PLUGIN_QUEUE_BYTES ||
+        batch->fields_used + buf->field_count > SIR_PLUGIN_QUEUE_FIELDS) {
+        if (SIRPO_BLOCK != queue->policy || queue->cancel) {
+            queue->stats.dropped++;
+            bool unlocked = _sir_mutexunlock(&queue->mutex);
+            SIR_ASSERT_UNUSED(unlocked, unlocked);
+            return false;
+        }
+
+        (void)_sir_condwait(&queue->room, &queue->mutex);
+        batch = queue->front;
+    }
+
+    char* data = batch->data + batch->used;
+    (void)memcpy(data, buf->message, msg_len);
+    data[msg_len] = '\0';
+    (void)memcpy(data + msg_len + 1, line, line_len);
+    data[msg_len + 1 + line_len] = '\0';
+
+    char* strs     = data + msg_len + line_len + 2;
+    sir_kv* fields = &batch->fields[batch->fields_used];
+    for (size_t n = 0; n < buf->field_count; n++) {
+        fields[n] = buf->fields[n];
+        strs      = _sir_plugin_copystr(strs, &fields[n].key);
+        if (SIRKV_STR == fields[n].value.type)
+            strs = _sir_plugin_copystr(strs, &fields[n].value.v.s);
+    }
+
+    batch->used        += need;
+    batch->fields_used += buf->field_count;
+
+    sir_plugin_record* rec = &batch->records[batch->count];
+    rec->level       = level;
+    rec->time        = buf->time;
+    rec->msec        = buf->time_msec;
+    rec->tid         = buf->tid_num;
+    rec->message     = data;
+    rec->message_len = msg_len;
+    rec->line        = data + msg_len + 1;
+    rec->line_len    = line_len;
+    rec->fields      = buf->field_count > 0 ? fields : NULL;
+    rec->field_count = buf->field_count;
+
+    (void)_sir_msec_since(NULL, &batch->queued[batch->count]);
+    queue->stats.queued++;
+
+    /* the worker only waits when the queue is empty. */
+    if (1 == ++batch->count)
+        (void)_sir_condsignal(&queue->ready);
+
+    bool unlocked = _sir_mutexunlock(&queue->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return true;
+}
+
+/** Delivers a batch to a plugin, then accumulates the results in `stats`. */
+static
+void _sir_plugin_deliver(const sir_plugin* plugin, const sir_plugin_batch* batch,
+    sir_plugin_stats* stats, double* latency_total) {
+    for (size_t off = 0; off < batch->count;) {
+        size_t count   = 1;
+        bool ok        = false;
+        uint64_t start = _sir_stats_clock();
+
+        if (plugin->iface.write_records) {
+            count = batch->count - off;
+            if (count > SIR_PLUGIN_BATCH)
+                count = SIR_PLUGIN_BATCH;
+            ok    = plugin->iface.write_records(&batch->records[off], count);
+        } else {
+            ok = plugin->iface.write(batch->records[off].level, batch->records[off].line);
+        }
+
+        size_t bytes = 0;
+        for (size_t n = off; n < off + count; n++)
+            bytes += batch->records[n].line_len;
+        _sir_stats_write(SIRSD_PLUGIN, plugin->id, ok, count, bytes, start);
+
+        if (ok) {
+            stats->delivered += count;
+        } else {
+            stats->failed += count;
+            _sir_selflog("error: write of %zu message(s) to plugin (path: '%s', id: %08"
+                         PRIx32") failed!", count, plugin->path, plugin->id);
+        }
+
+        sir_time now;
+        for (size_t n = off; n < off + count; n++) {
+            double latency = _sir_msec_since(&batch->queued[n], &now);
+            *latency_total += latency;
+            if (latency > stats->latency_max_msec)
+                stats->latency_max_msec = latency;
+        }
+
+        off += count;
+    }
+}
+
+# if !defined(__WIN__)
+static void* _sir_plugin_worker(void* arg)
+# else
+static unsigned __stdcall _sir_plugin_worker(void* arg)
+# endif
+{
+    sir_plugin* plugin      = (sir_plugin*)arg;
+    sir_plugin_queue* queue = plugin->queue;
+
+    (void)_sir_setthreadname("sir_plugin");
+
+    bool locked = _sir_mutexlock(&queue->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    while (true) {
+        while (!queue->cancel && 0 == queue->front->count)
+            (void)_sir_condwait(&queue->ready, &queue->mutex);
+
+        /* on shutdown, deliver what's left before exiting. */
+        if (0 == queue->front->count)
+            break;
+
+        sir_plugin_batch* batch = queue->front;
+        queue->front = queue->back;
+        queue->back  = batch;
+        queue->busy  = true;
+        (void)_sir_condbroadcast(&queue->room);
+
+        sir_plugin_stats stats = {0};
+        double latency_total   = 0.0;
+        stats.latency_max_msec = queue->stats.latency_max_msec;
+
+        bool unlocked = _sir_mutexunlock(&queue->mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+        _sir_plugin_deliver(plugin, batch, &stats, &latency_total);
+
+        locked = _sir_mutexlock(&queue->mutex);
+        SIR_ASSERT_UNUSED(locked, locked);
+
+        batch->count       = 0;
+        batch->used        = 0;
+        batch->fields_used = 0;
+
+        queue->busy                    = false;
+        queue->stats.delivered        += stats.delivered;
+        queue->stats.failed           += stats.failed;
+        queue->stats.latency_max_msec  = stats.latency_max_msec;
+        queue->latency_total          += latency_total;
+    }
+
+    bool unlocked = _sir_mutexunlock(&queue->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+# if !defined(__WIN__)
+    return NULL;
+# else /* __WIN__ */
+    return 0U;
+# endif
+}
+
+/** Locates a loaded plugin and locks its queue. On success, the caller holds
+ * both the plugin cache and the queue mutex. */
+static
+sir_plugin_queue* _sir_plugin_lockqueue(sir_plugincache* spc, sirpluginid id) {
+    sir_plugin* plugin = _sir_plugin_cache_find_id(spc, id);
+    if (!plugin || !plugin->queue) {
+        (void)_sir_seterror(_SIR_E_NOITEM);
+        return NULL;
+    }
+
+    return _sir_mutexlock(&plugin->queue->mutex) ? plugin->queue : NULL;
+}
+#endif
+
+bool _sir_plugin_setpolicy(sirpluginid id, sir_plugin_overflow policy) {
+#if !defined(SIR_NO_PLUGINS)
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity())
+        return false;
+
+    if (SIRPO_DROP != policy && SIRPO_BLOCK != policy)
+        return _sir_seterror(_SIR_E_INVALID);
+
+    _SIR_LOCK_SECTION(sir_plugincache, spc, SIRMI_PLUGINCACHE, false);
+    sir_plugin_queue* queue = _sir_plugin_lockqueue(spc, id);
+    if (queue) {
+        queue->policy = policy;
+        (void)_sir_condbroadcast(&queue->room);
+        bool unlocked = _sir_mutexunlock(&queue->mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+    }
+    _SIR_UNLOCK_SECTION(SIRMI_PLUGINCACHE);
+
+    return NULL != queue;
+#else
+    SIR_UNUSED(id);
+    SIR_UNUSED(policy);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
+bool _sir_plugin_getstats(sirpluginid id, sir_plugin_stats* stats) {
+#if !defined(SIR_NO_PLUGINS)
+    (void)_sir_seterror(_SIR_E_NOERROR);
+
+    if (!_sir_sanity() || !_sir_validptr(stats))
+        return false;
+
+    _SIR_LOCK_SECTION(sir_plugincache, spc, SIRMI_PLUGINCACHE, false);
+    sir_plugin_queue* queue = _sir_plugin_lockqueue(spc, id);
+    if (queue) {
+        (void)memcpy(stats, &queue->stats, sizeof(sir_plugin_stats));
+
+        uint64_t done = stats->delivered + stats->failed;
+        stats->depth  = queue->front->count + (queue->busy ? queue->back->count : 0);
+        stats->latency_avg_msec = done > 0 ? queue->latency_total / (double)done : 0.0;
+
+        bool unlocked = _sir_mutexunlock(&queue->mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+    }
+    _SIR_UNLOCK_SECTION(SIRMI_PLUGINCACHE);
+
+    return NULL != queue;
+#else
+    SIR_UNUSED(id);
+    SIR_UNUSED(stats);
+    return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+}
+
 bool _sir_plugin_cache_pred_id(const void* match, const sir_plugin* iter) {
 #if !defined(SIR_NO_PLUGINS)
     return iter->id == *((const sirpluginid*)match);
@@ -364,6 +780,8 @@ sirpluginid _sir_plugin_cache_add(sir_plugincache* spc, sir_plugin* plugin) {
     _sir_selflog("adding plugin (path: %s, id: %08"PRIx32"); count = %zu",
     plugin->path, plugin->id, spc->count + 1);
     spc->plugins[spc->count++] = plugin;
+    _sir_stats_add(SIRSD_PLUGIN, plugin->id);
+    _sir_plugin_cache_publish(spc);
     return plugin->id;
 #else
     SIR_UNUSED(spc);
@@ -402,9 +820,9 @@ sir_plugin* _sir_plugin_cache_find(const sir_plugincache* spc, const void* match
 #endif
 }
 
-bool _sir_plugin_cache_rem(sir_plugincache* spc, sirpluginid id) {
+bool _sir_plugin_cache_rem(sir_plugincache* spc, sirpluginid id, sir_plugin** removed) {
 #if !defined(SIR_NO_PLUGINS)
-    if (!_sir_validptr(spc))
+    if (!_sir_validptr(spc) || !_sir_validptrptr(removed))
         return false;
 
     for (size_t n = 0; n < spc->count; n++) {
@@ -412,14 +830,15 @@ bool _sir_plugin_cache_rem(sir_plugincache* spc, sirpluginid id) {
             _sir_selflog("removing plugin (path: '%s', id: %"PRIx32"); count = %zu",
                 spc->plugins[n]->path, spc->plugins[n]->id, spc->count - 1);
 
-            _sir_plugin_destroy(&spc->plugins[n]);
+            *removed = spc->plugins[n];
 
             for (size_t i = n; i < spc->count - 1; i++) {
                 spc->plugins[i] = spc->plugins[i + 1];
                 spc->plugins[i + 1] = NULL;
             }
 
-            spc->count--;
+            spc->plugins[--spc->count] = NULL;
+            _sir_plugin_cache_publish(spc);
             return true;
         }
     }
@@ -428,6 +847,7 @@ bool _sir_plugin_cache_rem(sir_plugincache* spc, sirpluginid id) {
 #else
     SIR_UNUSED(spc);
     SIR_UNUSED(id);
+    SIR_UNUSED(removed);
     return false;
 #endif
 }
@@ -437,13 +857,23 @@ bool _sir_plugin_cache_destroy(sir_plugincache* spc) {
     if (!_sir_validptr(spc))
         return false;
 
-    while (spc->count > 0) {
-        size_t idx = spc->count - 1;
-        _sir_plugin_destroy(&spc->plugins[idx]);
-        spc->plugins[idx] = NULL;
-        spc->count--;
+    sir_plugin* plugins[SIR_MAXPLUGINS] = {0};
+    size_t count = spc->count;
+    (void)memcpy(plugins, spc->plugins, sizeof(plugins));
+
+    spc->count = 0;
+    _sir_plugin_cache_publish(spc);
+
+    while (count > 0) {
+        sirpluginid id = plugins[--count]->id;
+        _sir_plugin_destroy(&plugins[count]);
+        _sir_stats_rem(SIRSD_PLUGIN, id);
     }
 
+# if defined(__HAVE_ATOMIC_H__)
+    atomic_store(&_sir_plugin_dispatchstate()->current, NULL);
+# endif
+
     (void)memset(spc, 0, sizeof(sir_plugincache));
     return true;
 #else
@@ -452,47 +882,130 @@ bool _sir_plugin_cache_destroy(sir_plugincache* spc) {
 #endif
 }
 
-bool _sir_plugin_cache_dispatch(const sir_plugincache* spc, sir_level level, sirbuf* buf,
+#if !defined(SIR_NO_PLUGINS)
+static
+void _sir_plugin_cache_publish(sir_plugincache* spc) {
+    size_t next         = spc->current ^ 1U;
+    sir_pluginlist* spl = &spc->lists[next];
+
+    (void)memcpy(spl->plugins, spc->plugins, sizeof(spl->plugins));
+    spl->count   = spc->count;
+    spc->current = next;
+
+# if defined(__HAVE_ATOMIC_H__)
+    sir_plugin_dispatch* pd = _sir_plugin_dispatchstate();
+    atomic_store(&pd->current, spl);
+
+    /* after this, new dispatches can only see the list just published. */
+    uint_fast32_t epoch = atomic_fetch_add(&pd->epoch, 1U);
+
+    while (0U != atomic_load(&pd->readers[epoch & 1U])) {
+#  if !defined(__WIN__)
+        (void)sched_yield();
+#  else /* __WIN__ */
+        (void)SwitchToThread();
+#  endif
+    }
+# endif
+}
+#endif
+
+bool _sir_plugin_dispatch(sir_level level, sirbuf* buf, size_t* dispatched, size_t* wanted) {
+#if !defined(SIR_NO_PLUGINS)
+# if defined(__HAVE_ATOMIC_H__)
+    sir_plugin_dispatch* pd = _sir_plugin_dispatchstate();
+    size_t slot = 0;
+    while (true) {
+        uint_fast32_t epoch = atomic_load(&pd->epoch);
+        slot = (size_t)(epoch & 1U);
+        (void)atomic_fetch_add(&pd->readers[slot], 1U);
+
+        /* if a list was published in the meantime, the publisher may not have
+         * seen this registration; try again in the new epoch. */
+        if (epoch == atomic_load(&pd->epoch))
+            break;
+
+        (void)atomic_fetch_sub(&pd->readers[slot], 1U);
+    }
+
+    const sir_pluginlist* spl = atomic_load(&pd->current);
+    bool retval = true;
+
+    if (spl) {
+        retval = _sir_plugin_cache_dispatch(spl, level, buf, dispatched, wanted);
+    } else {
+        *dispatched = 0;
+        *wanted     = 0;
+    }
+
+    (void)atomic_fetch_sub(&pd->readers[slot], 1U);
+    return retval;
+# else
+    _SIR_LOCK_SECTION(const sir_plugincache, spc, SIRMI_PLUGINCACHE, false);
+    bool retval = _sir_plugin_cache_dispatch(&spc->lists[spc->current], level, buf,
+        dispatched, wanted);
+    _SIR_UNLOCK_SECTION(SIRMI_PLUGINCACHE);
+    return retval;
+# endif
+#else
+    SIR_UNUSED(level);
+    SIR_UNUSED(buf);
+    SIR_UNUSED(dispatched);
+    SIR_UNUSED(wanted);
+    return false;
+#endif
+}
+
+bool _sir_plugin_cache_dispatch(const sir_pluginlist* spl, sir_level level, sirbuf* buf,
     size_t* dispatched, size_t* wanted) {
 #if !defined(SIR_NO_PLUGINS)
-    if (!_sir_validptr(spc) || !_sir_validlevel(level) || !_sir_validptr(buf) ||
+    if (!_sir_validptr(spl) || !_sir_validlevel(level) || !_sir_validptr(buf) ||
         !_sir_validptr(dispatched) || !_sir_validptr(wanted))
         return false;
 
     const char* wrote    = NULL;
     sir_options lastopts = 0;
+    size_t msg_len       = (size_t)-1;
 
     *dispatched = 0;
     *wanted     = 0;
 
-    for (size_t n = 0; n < spc->count; n++) {
-        if (!_sir_bittest(spc->plugins[n]->info.levels, level)) {
+    for (size_t n = 0; n < spl->count; n++) {
+        if (!_sir_bittest(spl->plugins[n]->info.levels, level)) {
             _sir_selflog("level %04"PRIx16" not set in level mask (%04"PRIx16
                          ") for plugin (path: '%s', id: %08"PRIx32"); skipping",
-                         level, spc->plugins[n]->info.levels, spc->plugins[n]->path,
-                         spc->plugins[n]->id);
+                         level, spl->plugins[n]->info.levels, spl->plugins[n]->path,
+                         spl->plugins[n]->id);
             continue;
         }
 
         (*wanted)++;
 
-        if (!wrote || spc->plugins[n]->info.opts != lastopts) {
-            wrote = _sir_format(false, spc->plugins[n]->info.opts, buf);
+        if (!wrote || spl->plugins[n]->info.opts != lastopts) {
+            wrote = _sir_format(false, spl->plugins[n]->info.opts, buf);
             SIR_ASSERT(wrote);
-            lastopts = spc->plugins[n]->info.opts;
+            lastopts = spl->plugins[n]->info.opts;
         }
 
-        if (wrote && spc->plugins[n]->iface.write(level, wrote)) {
+        if (wrote && (size_t)-1 == msg_len)
+            msg_len = strnlen(buf->message, SIR_MAXMESSAGE);
+
+        _SIR_PROBE3(write__start, SIRSD_PLUGIN, spl->plugins[n]->id, level);
+        bool queued = wrote && _sir_plugin_enqueue(spl->plugins[n], level, buf, msg_len,
+            wrote, buf->output_len);
+        _SIR_PROBE4(write__done, SIRSD_PLUGIN, spl->plugins[n]->id, queued, buf->output_len);
+
+        if (queued) {
             (*dispatched)++;
         } else {
-            _sir_selflog("error: write to plugin (path: '%s', id: %08"PRIx32")"
-                         " failed!", spc->plugins[n]->path, spc->plugins[n]->id);
+            _sir_selflog("error: failed to queue message for plugin (path: '%s',"
+                         " id: %08"PRIx32")!", spl->plugins[n]->path, spl->plugins[n]->id);
         }
     }
 
     return (*dispatched == *wanted);
 #else
-    SIR_UNUSED(spc);
+    SIR_UNUSED(spl);
     SIR_UNUSED(level);
     SIR_UNUSED(buf);
     SIR_UNUSED(dispatched);
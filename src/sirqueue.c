@@ -32,114 +32,221 @@
 #include "sir/queue.h"
 #include "sir/helpers.h"
 #include "sir/errors.h"
-
-sir_queue_node* _sir_queue_node_create(void* data) {
-    sir_queue_node* retval = calloc(1, sizeof(sir_queue_node));
-    if (!retval)
-        (void)_sir_handleerr(errno);
-    else
-        retval->data = data;
-
-    return retval;
-}
-
-bool _sir_queue_node_destroy(sir_queue_node** node, void** data) {
-    bool valid = _sir_validptrptr(node) && _sir_validptr(*node);
-
-    if (valid) {
-        if (data)
-            *data = (*node)->data;
-
-        _sir_safefree(node);
+#include "sir/mutex.h"
+
+/** The largest capacity a sir_queue may be created with. */
+#define SIR_QUEUE_MAXCAPACITY ((size_t)1 << 24)
+
+#if defined(__HAVE_ATOMIC_H__)
+/**
+ * The queue is a fixed-size ring of cells, each with a sequence number that
+ * tells producers and consumers whether it is theirs to use (D. Vyukov's
+ * bounded MPMC queue). A producer claims the cell at `enqueue_pos` when its
+ * sequence equals the position, and publishes the item by setting it to the
+ * position + 1; a consumer claims the cell at `dequeue_pos` when its sequence
+ * equals the position + 1, and hands it back to producers for the next lap by
+ * setting it to the position + the capacity. Each push or pop is therefore a
+ * single compare-and-swap in the common case, and never allocates.
+ */
+typedef struct {
+    atomic_size_t seq;
+    void* data;
+} sir_queue_cell;
+
+struct _sir_queue {
+    sir_queue_cell* cells;
+    size_t mask;
+    char pad0[SIR_CACHELINE];
+    atomic_size_t enqueue_pos;
+    char pad1[SIR_CACHELINE - sizeof(atomic_size_t)];
+    atomic_size_t dequeue_pos;
+    char pad2[SIR_CACHELINE - sizeof(atomic_size_t)];
+};
+#else
+/** Without atomics, the same ring, protected by a mutex. */
+struct _sir_queue {
+    void** cells;
+    size_t mask;
+    size_t enqueue_pos;
+    size_t dequeue_pos;
+    sir_mutex mutex;
+};
+#endif
+
+bool _sir_queue_create(sir_queue** q, size_t capacity) {
+    if (!_sir_validptrptr(q))
+        return false;
+
+    if (0 == capacity || capacity > SIR_QUEUE_MAXCAPACITY)
+        return _sir_seterror(_SIR_E_INVALID);
+
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+
+    *q = calloc(1, sizeof(sir_queue));
+    if (!*q)
+        return _sir_handleerr(errno);
+
+    (*q)->cells = calloc(size, sizeof(*(*q)->cells));
+    if (!(*q)->cells) {
+        int err = errno;
+        _sir_safefree(q);
+        return _sir_handleerr(err);
     }
 
-    return valid;
-}
+    (*q)->mask = size - 1;
 
-bool _sir_queue_create(sir_queue** q) {
-    bool valid = _sir_validptrptr(q);
+#if defined(__HAVE_ATOMIC_H__)
+    for (size_t n = 0; n < size; n++)
+        atomic_init(&(*q)->cells[n].seq, n);
 
-    if (valid) {
-        *q = calloc(1, sizeof(sir_queue));
-        if (!_sir_validptrnofail(*q))
-            (void)_sir_handleerr(errno);
+    atomic_init(&(*q)->enqueue_pos, 0);
+    atomic_init(&(*q)->dequeue_pos, 0);
+#else
+    if (!_sir_mutexcreate(&(*q)->mutex)) {
+        _sir_safefree(&(*q)->cells);
+        _sir_safefree(q);
+        return false;
     }
+#endif
 
-    return valid && _sir_validptrnofail(*q);
+    return true;
 }
 
 bool _sir_queue_destroy(sir_queue** q) {
     bool valid = _sir_validptrptr(q) && _sir_validptr(*q);
 
     if (valid) {
-        sir_queue_node* next = (*q)->head;
-        while (next) {
-            sir_queue_node* this_node = next;
-            void* data                = NULL;
-            next                      = this_node->next;
-
-            if (_sir_queue_node_destroy(&this_node, &data))
-                _sir_safefree(&data);
-        }
+        void* data = NULL;
+        while (_sir_queue_pop(*q, &data))
+            _sir_safefree(&data);
+
+#if !defined(__HAVE_ATOMIC_H__)
+        bool destroyed = _sir_mutexdestroy(&(*q)->mutex);
+        SIR_ASSERT_UNUSED(destroyed, destroyed);
+#endif
 
+        _sir_safefree(&(*q)->cells);
         _sir_safefree(q);
     }
 
     return valid;
 }
 
-size_t _sir_queue_size(sir_queue* q) {
-    if (_sir_queue_isempty(q))
+size_t _sir_queue_size(const sir_queue* q) {
+    if (!q)
         return 0;
 
-    sir_queue_node* next = q->head->next;
-    size_t idx           = 1;
-    while (next) {
-        idx++;
-        next = next->next;
-    }
+#if defined(__HAVE_ATOMIC_H__)
+    /* read the consumer's end first, so that the difference can't be negative. */
+    size_t dequeue_pos = atomic_load_explicit(&q->dequeue_pos, memory_order_acquire);
+    size_t enqueue_pos = atomic_load_explicit(&q->enqueue_pos, memory_order_acquire);
+    size_t size        = enqueue_pos - dequeue_pos;
+    return size > q->mask + 1 ? q->mask + 1 : size;
+#else
+    sir_queue* mq = (sir_queue*)q;
+    bool locked   = _sir_mutexlock(&mq->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    size_t size = mq->enqueue_pos - mq->dequeue_pos;
+
+    bool unlocked = _sir_mutexunlock(&mq->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+    return size;
+#endif
+}
 
-    return idx;
+size_t _sir_queue_capacity(const sir_queue* q) {
+    return q ? q->mask + 1 : 0;
 }
 
 bool _sir_queue_isempty(const sir_queue* q) {
-    return !q || !q->head;
+    return 0 == _sir_queue_size(q);
 }
 
 bool _sir_queue_push(sir_queue* q, void* data) {
-    bool retval = false;
-
-    if (_sir_validptr(q)) {
-        if (!q->head) {
-            q->head = _sir_queue_node_create(data);
-            retval = NULL != q->head;
+    if (!_sir_validptr(q))
+        return false;
+
+#if defined(__HAVE_ATOMIC_H__)
+    sir_queue_cell* cell = NULL;
+    size_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+
+    while (true) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq    = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (0 == diff) {
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1,
+                memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* the cell hasn't been consumed since the last lap: full. */
+            return _sir_seterror(_SIR_E_NOROOM);
         } else {
-            sir_queue_node* next = q->head;
-            while (next) {
-                if (!next->next) {
-                    next->next = _sir_queue_node_create(data);
-                    if (next->next) {
-                        retval = true;
-                        break;
-                    }
-                }
-                next = next->next;
-            }
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
         }
     }
 
-    return retval;
+    cell->data = data;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+#else
+    bool locked = _sir_mutexlock(&q->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    bool pushed = q->enqueue_pos - q->dequeue_pos <= q->mask;
+    if (pushed)
+        q->cells[q->enqueue_pos++ & q->mask] = data;
+
+    bool unlocked = _sir_mutexunlock(&q->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return pushed ? true : _sir_seterror(_SIR_E_NOROOM);
+#endif
 }
 
 bool _sir_queue_pop(sir_queue* q, void** data) {
-    bool retval = false;
+    if (!q || !_sir_validptrptr(data))
+        return false;
+
+#if defined(__HAVE_ATOMIC_H__)
+    sir_queue_cell* cell = NULL;
+    size_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+
+    while (true) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq    = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (0 == diff) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1,
+                memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* the cell hasn't been published yet: empty. */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
 
-    if (!_sir_queue_isempty(q) && _sir_validptrptr(data)) {
-        sir_queue_node* old_head = q->head;
-        q->head                  = old_head->next;
+    *data = cell->data;
+    atomic_store_explicit(&cell->seq, pos + q->mask + 1, memory_order_release);
+    return true;
+#else
+    bool locked = _sir_mutexlock(&q->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
 
-        retval = _sir_queue_node_destroy(&old_head, data);
-    }
+    bool popped = q->enqueue_pos != q->dequeue_pos;
+    if (popped)
+        *data = q->cells[q->dequeue_pos++ & q->mask];
+
+    bool unlocked = _sir_mutexunlock(&q->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
 
-    return retval;
+    return popped;
+#endif
 }
@@ -0,0 +1,209 @@
+/*
+ * sirratelimit.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#include "sir/ratelimit.h"
+#include "sir/internal.h"
+
+/*
+ * The rate limit is a token bucket, implemented as the generic cell rate
+ * algorithm (GCRA): rather than a count of tokens, `tat` holds the time at which
+ * the bucket would be full again. A message arriving at `now` is let through if
+ * that is no more than `burst - 1` intervals away, and moves `tat` one interval
+ * later; so the whole state is one word, updated with compare-and-swap.
+ *
+ * Sites which have suppressed messages are pushed onto a list (once each, and
+ * never removed until libsir is cleaned up), so that the ticker thread can
+ * report them even if the site is never called again.
+ *
+ * Without the GCC/Clang atomic builtins, the state is read and written without
+ * synchronization, and the limits are only approximate under contention.
+ */
+
+static inline
+int64_t _sir_limit_load(volatile int64_t* ptr) {
+#if defined(__GNUC__)
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+#else
+    return *ptr;
+#endif
+}
+
+static inline
+bool _sir_limit_cas(volatile int64_t* ptr, int64_t* expected, int64_t desired) {
+#if defined(__GNUC__)
+    return __atomic_compare_exchange_n(ptr, expected, desired, false,
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#else
+    if (*ptr != *expected) {
+        *expected = *ptr;
+        return false;
+    }
+    *ptr = desired;
+    return true;
+#endif
+}
+
+static inline
+uint64_t _sir_limit_add(volatile uint64_t* ptr, uint64_t val) {
+#if defined(__GNUC__)
+    return __atomic_fetch_add(ptr, val, __ATOMIC_RELAXED);
+#else
+    uint64_t old = *ptr;
+    *ptr         = old + val;
+    return old;
+#endif
+}
+
+/** Call sites which have suppressed messages, most recent first. */
+static sir_limitsite* volatile _sir_limit_list = NULL;
+
+static inline
+bool _sir_limit_pending(const sir_limitsite* site) {
+#if defined(__GNUC__)
+    return 0U != __atomic_load_n(&site->suppressed, __ATOMIC_RELAXED);
+#else
+    return 0U != site->suppressed;
+#endif
+}
+
+static inline
+uint64_t _sir_limit_take(volatile uint64_t* ptr) {
+#if defined(__GNUC__)
+    return __atomic_exchange_n(ptr, 0, __ATOMIC_RELAXED);
+#else
+    uint64_t old = *ptr;
+    *ptr         = 0;
+    return old;
+#endif
+}
+
+static inline
+int64_t _sir_limit_now(void) {
+    time_t sec = 0;
+    long nsec  = 0L;
+    bool gettime = _sir_clock_gettimens(SIR_INTERVALCLOCK, &sec, &nsec);
+    SIR_ASSERT_UNUSED(gettime, gettime);
+
+    return ((int64_t)sec * 1000000000LL) + nsec;
+}
+
+bool _sir_limit_admit(sir_limitsite* site) {
+    /* the first call is always among those sampled. */
+    if (site->sample > 1U && 0U != _sir_limit_add(&site->calls, 1) % site->sample)
+        return false;
+
+    if (0U == site->per_sec)
+        return true;
+
+    int64_t now       = _sir_limit_now();
+    int64_t interval  = 1000000000LL / site->per_sec;
+    uint32_t burst    = 0U != site->burst ? site->burst : site->per_sec;
+    int64_t tolerance = interval * (int64_t)(burst - 1U);
+
+    int64_t tat = _sir_limit_load(&site->tat);
+    do {
+        int64_t start = tat > now ? tat : now;
+        if (start - now > tolerance)
+            return false;
+
+        if (_sir_limit_cas(&site->tat, &tat, start + interval))
+            return true;
+    } while (true);
+}
+
+bool _sir_limit_suppress(sir_limitsite* site, sir_level level, sir_context* ctx) {
+    (void)_sir_limit_add(&site->suppressed, 1);
+
+#if defined(__GNUC__)
+    __atomic_store_n(&site->level, (uint32_t)level, __ATOMIC_RELAXED);
+    __atomic_store_n(&site->ctx, ctx, __ATOMIC_RELAXED);
+
+    /* the site is added to the list once, by the thread that marks it. */
+    uint32_t listed = 0U;
+    if (!__atomic_compare_exchange_n(&site->listed, &listed, 1U, false,
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        return false;
+
+    sir_limitsite* head = __atomic_load_n(&_sir_limit_list, __ATOMIC_RELAXED);
+    do {
+        site->next = head;
+    } while (!__atomic_compare_exchange_n(&_sir_limit_list, &head, site, true,
+        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#else
+    site->level = (uint32_t)level;
+    site->ctx   = ctx;
+
+    if (0U != site->listed)
+        return false;
+
+    site->listed    = 1U;
+    site->next      = _sir_limit_list;
+    _sir_limit_list = site;
+#endif
+
+    return true;
+}
+
+uint64_t _sir_limit_collect(sir_limitsite* site, bool force) {
+    if (!_sir_limit_pending(site))
+        return 0U;
+
+    /* only the thread that moves `reported` up collects the count. */
+    int64_t now      = _sir_limit_now();
+    int64_t reported = _sir_limit_load(&site->reported);
+    if ((force || now - reported >= (int64_t)SIR_LIMIT_REPORT_INTERVAL * 1000000LL) &&
+        _sir_limit_cas(&site->reported, &reported, now))
+        return _sir_limit_take(&site->suppressed);
+
+    return 0U;
+}
+
+sir_limitsite* _sir_limit_next(const sir_limitsite* site) {
+#if defined(__GNUC__)
+    return site ? site->next : __atomic_load_n(&_sir_limit_list, __ATOMIC_ACQUIRE);
+#else
+    return site ? site->next : _sir_limit_list;
+#endif
+}
+
+void _sir_limit_forget(void) {
+    sir_limitsite* site = _sir_limit_list;
+    _sir_limit_list     = NULL;
+
+    while (site) {
+        sir_limitsite* next = site->next;
+        site->next          = NULL;
+        site->ctx           = NULL;
+        site->listed        = 0U;
+        site                = next;
+    }
+}
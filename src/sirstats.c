@@ -0,0 +1,308 @@
+/*
+ * sirstats.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#include "sir/stats.h"
+#include "sir/internal.h"
+#include "sir/helpers.h"
+#include "sir/errors.h"
+
+#if !defined(SIR_NO_STATS)
+/** The number of destinations with counters: stdout, stderr, syslog, then a
+ * slot for each possible log file and plugin. */
+# define SIR_STATS_DESTS (3 + SIR_MAXFILES + SIR_MAXPLUGINS)
+
+typedef atomic_uint_fast64_t sir_stat;
+
+typedef struct {
+    sir_stat lines;
+    sir_stat bytes;
+    sir_stat errors;
+    sir_stat latency[SIR_STATS_BUCKETS];
+} sir_stats_dest_shard;
+
+/**
+ * One set of counters. Threads are assigned one of these round-robin when they
+ * first log, so that they rarely contend for the same cache lines; every update
+ * is a relaxed atomic add, and reads add up all of the sets.
+ */
+typedef struct {
+    sir_stat messages[SIR_NUMLEVELS];
+    sir_stat squelched;
+    sir_stat limited;
+    sir_stat nodest;
+    sir_stat logv[SIR_STATS_BUCKETS];
+    sir_stats_dest_shard dests[SIR_STATS_DESTS];
+    char pad[SIR_CACHELINE];
+} sir_stats_shard;
+
+static sir_stats_shard _sir_stats_shards[SIR_STATS_SHARDS];
+
+/** The file or plugin ID that each slot is assigned to (zero if none). */
+static atomic_uint_fast32_t _sir_stats_ids[SIR_MAXFILES + SIR_MAXPLUGINS];
+
+static atomic_size_t _sir_stats_nextshard;
+static _sir_thread_local sir_stats_shard* _sir_stats_myshard;
+
+static inline
+sir_stats_shard* _sir_stats_shard(void) {
+    if (!_sir_stats_myshard) {
+        size_t idx = atomic_fetch_add_explicit(&_sir_stats_nextshard, 1,
+            memory_order_relaxed);
+        _sir_stats_myshard = &_sir_stats_shards[idx % SIR_STATS_SHARDS];
+    }
+
+    return _sir_stats_myshard;
+}
+
+static inline
+void _sir_stats_inc(sir_stat* stat, uint64_t n) {
+    (void)atomic_fetch_add_explicit(stat, n, memory_order_relaxed);
+}
+
+/** Returns the histogram bucket for a sample of `nsec` nanoseconds. */
+static inline
+size_t _sir_stats_bucket(uint64_t nsec) {
+    size_t idx = 0;
+# if defined(__GNUC__)
+    if (nsec > 1ULL)
+        idx = 63 - (size_t)__builtin_clzll(nsec);
+# else
+    while (nsec > 1ULL) {
+        nsec >>= 1;
+        idx++;
+    }
+# endif
+    return idx < SIR_STATS_BUCKETS ? idx : SIR_STATS_BUCKETS - 1;
+}
+
+/** Returns the slot for a destination, or SIR_STATS_DESTS if there isn't one. */
+static
+size_t _sir_stats_slot(sir_stats_dest dest, uint32_t id) {
+    size_t first = 0;
+    size_t count = 0;
+
+    switch (dest) {
+        case SIRSD_STDOUT:
+        case SIRSD_STDERR:
+        case SIRSD_SYSLOG:
+            return (size_t)dest;
+        case SIRSD_FILE:
+            count = SIR_MAXFILES;
+            break;
+        case SIRSD_PLUGIN:
+            first = SIR_MAXFILES;
+            count = SIR_MAXPLUGINS;
+            break;
+        default: // GCOVR_EXCL_START
+            return SIR_STATS_DESTS;
+    } // GCOVR_EXCL_STOP
+
+    for (size_t n = first; n < first + count; n++)
+        if (id == atomic_load_explicit(&_sir_stats_ids[n], memory_order_relaxed))
+            return 3 + n;
+
+    return SIR_STATS_DESTS;
+}
+
+# if defined(SIR_STATS_LATENCY)
+uint64_t _sir_stats_clock(void) {
+#  if defined(__WIN__)
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER now;
+    if (0LL == freq.QuadPart)
+        (void)QueryPerformanceFrequency(&freq);
+    (void)QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * (1e9 / (double)freq.QuadPart));
+#  elif defined(SIR_MSEC_POSIX)
+    struct timespec ts = {0};
+    (void)clock_gettime(SIR_INTERVALCLOCK, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#  else
+    return (uint64_t)time(NULL) * 1000000000ULL;
+#  endif
+}
+# endif
+
+void _sir_stats_reset(void) {
+    for (size_t s = 0; s < SIR_STATS_SHARDS; s++) {
+        sir_stats_shard* shard = &_sir_stats_shards[s];
+        for (size_t n = 0; n < SIR_NUMLEVELS; n++)
+            atomic_store_explicit(&shard->messages[n], 0, memory_order_relaxed);
+        atomic_store_explicit(&shard->squelched, 0, memory_order_relaxed);
+        atomic_store_explicit(&shard->limited, 0, memory_order_relaxed);
+        atomic_store_explicit(&shard->nodest, 0, memory_order_relaxed);
+        for (size_t n = 0; n < SIR_STATS_BUCKETS; n++)
+            atomic_store_explicit(&shard->logv[n], 0, memory_order_relaxed);
+        for (size_t d = 0; d < SIR_STATS_DESTS; d++) {
+            atomic_store_explicit(&shard->dests[d].lines, 0, memory_order_relaxed);
+            atomic_store_explicit(&shard->dests[d].bytes, 0, memory_order_relaxed);
+            atomic_store_explicit(&shard->dests[d].errors, 0, memory_order_relaxed);
+            for (size_t n = 0; n < SIR_STATS_BUCKETS; n++)
+                atomic_store_explicit(&shard->dests[d].latency[n], 0, memory_order_relaxed);
+        }
+    }
+}
+
+void _sir_stats_message(sir_level level) {
+    size_t idx = _sir_levelidx(level);
+    if (idx < SIR_NUMLEVELS)
+        _sir_stats_inc(&_sir_stats_shard()->messages[idx], 1);
+}
+
+void _sir_stats_squelched(void) {
+    _sir_stats_inc(&_sir_stats_shard()->squelched, 1);
+}
+
+void _sir_stats_limited(void) {
+    _sir_stats_inc(&_sir_stats_shard()->limited, 1);
+}
+
+void _sir_stats_nodest(void) {
+    _sir_stats_inc(&_sir_stats_shard()->nodest, 1);
+}
+
+# if defined(SIR_STATS_LATENCY)
+void _sir_stats_logv(uint64_t start) {
+    uint64_t now = _sir_stats_clock();
+    _sir_stats_inc(&_sir_stats_shard()->logv[_sir_stats_bucket(now - start)], 1);
+}
+# endif
+
+void _sir_stats_add(sir_stats_dest dest, uint32_t id) {
+    size_t first = SIRSD_FILE == dest ? 0 : SIR_MAXFILES;
+    size_t count = SIRSD_FILE == dest ? SIR_MAXFILES : SIR_MAXPLUGINS;
+
+    for (size_t n = first; n < first + count; n++) {
+        /* contexts add destinations concurrently, so a slot must be claimed
+         * atomically; the new owner doesn't write to it until this returns. */
+        uint_fast32_t free_id = 0U;
+        if (!atomic_compare_exchange_strong_explicit(&_sir_stats_ids[n], &free_id, id,
+            memory_order_acq_rel, memory_order_relaxed))
+            continue;
+
+        /* the slot's last owner may have left counts behind. */
+        for (size_t s = 0; s < SIR_STATS_SHARDS; s++) {
+            sir_stats_dest_shard* ds = &_sir_stats_shards[s].dests[3 + n];
+            atomic_store_explicit(&ds->lines, 0, memory_order_relaxed);
+            atomic_store_explicit(&ds->bytes, 0, memory_order_relaxed);
+            atomic_store_explicit(&ds->errors, 0, memory_order_relaxed);
+            for (size_t b = 0; b < SIR_STATS_BUCKETS; b++)
+                atomic_store_explicit(&ds->latency[b], 0, memory_order_relaxed);
+        }
+
+        return;
+    }
+
+    _sir_selflog("error: no free %s stats slot for %08"PRIx32"; its counters will"
+        " not be kept", SIRSD_FILE == dest ? "file" : "plugin", id);
+}
+
+void _sir_stats_rem(sir_stats_dest dest, uint32_t id) {
+    size_t slot = 0U != id ? _sir_stats_slot(dest, id) : SIR_STATS_DESTS;
+    if (slot >= 3 && slot < SIR_STATS_DESTS)
+        atomic_store_explicit(&_sir_stats_ids[slot - 3], 0U, memory_order_release);
+}
+
+void _sir_stats_write(sir_stats_dest dest, uint32_t id, bool ok, size_t lines,
+    size_t bytes, uint64_t start) {
+    size_t slot = _sir_stats_slot(dest, id);
+    if (slot >= SIR_STATS_DESTS)
+        return;
+
+    sir_stats_dest_shard* ds = &_sir_stats_shard()->dests[slot];
+
+    if (ok) {
+        _sir_stats_inc(&ds->lines, lines);
+        _sir_stats_inc(&ds->bytes, bytes);
+    } else {
+        _sir_stats_inc(&ds->errors, 1);
+    }
+
+# if defined(SIR_STATS_LATENCY)
+    uint64_t now = _sir_stats_clock();
+    _sir_stats_inc(&ds->latency[_sir_stats_bucket(now - start)], 1);
+# else
+    SIR_UNUSED(start);
+# endif
+}
+
+static
+void _sir_stats_sumdest(size_t slot, sir_dest_stats* out) {
+    for (size_t s = 0; s < SIR_STATS_SHARDS; s++) {
+        sir_stats_dest_shard* ds = &_sir_stats_shards[s].dests[slot];
+        out->lines  += atomic_load_explicit(&ds->lines, memory_order_relaxed);
+        out->bytes  += atomic_load_explicit(&ds->bytes, memory_order_relaxed);
+        out->errors += atomic_load_explicit(&ds->errors, memory_order_relaxed);
+        for (size_t b = 0; b < SIR_STATS_BUCKETS; b++)
+            out->latency.count[b] += atomic_load_explicit(&ds->latency[b],
+                memory_order_relaxed);
+    }
+}
+
+bool _sir_stats_get(sir_stats* stats) {
+    if (!_sir_validptr(stats))
+        return false;
+
+    (void)memset(stats, 0, sizeof(sir_stats));
+
+    for (size_t s = 0; s < SIR_STATS_SHARDS; s++) {
+        sir_stats_shard* shard = &_sir_stats_shards[s];
+        for (size_t n = 0; n < SIR_NUMLEVELS; n++)
+            stats->messages[n] += atomic_load_explicit(&shard->messages[n], memory_order_relaxed);
+        stats->squelched += atomic_load_explicit(&shard->squelched, memory_order_relaxed);
+        stats->limited   += atomic_load_explicit(&shard->limited, memory_order_relaxed);
+        stats->nodest    += atomic_load_explicit(&shard->nodest, memory_order_relaxed);
+        for (size_t n = 0; n < SIR_STATS_BUCKETS; n++)
+            stats->logv.count[n] += atomic_load_explicit(&shard->logv[n], memory_order_relaxed);
+    }
+
+    _sir_stats_sumdest(SIRSD_STDOUT, &stats->d_stdout);
+    _sir_stats_sumdest(SIRSD_STDERR, &stats->d_stderr);
+    _sir_stats_sumdest(SIRSD_SYSLOG, &stats->d_syslog);
+
+    for (size_t n = 0; n < SIR_MAXFILES + SIR_MAXPLUGINS; n++) {
+        uint32_t id = (uint32_t)atomic_load_explicit(&_sir_stats_ids[n], memory_order_acquire);
+        if (0U == id)
+            continue;
+
+        if (n < SIR_MAXFILES) {
+            stats->file_ids[stats->num_files] = id;
+            _sir_stats_sumdest(3 + n, &stats->files[stats->num_files++]);
+        } else {
+            stats->plugin_ids[stats->num_plugins] = id;
+            _sir_stats_sumdest(3 + n, &stats->plugins[stats->num_plugins++]);
+        }
+    }
+
+    return true;
+}
+#endif /* !SIR_NO_STATS */
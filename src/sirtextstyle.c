@@ -44,26 +44,55 @@ sir_text_style_data sir_text_style_section = {
     &sir_color_mode
 };
 
-const char* _sir_gettextstyle(sir_level level) {
-    static const size_t low  = 0;
-    static const size_t high = SIR_NUMLEVELS - 1;
+/**
+ * Published copies of the rendered per-level styles, indexed by level bit
+ * position. Written only while holding the SIRMI_TEXTSTYLE mutex; read without
+ * it by ::_sir_gettextstyle, which retries if a writer was active mid-copy. */
+static char _sir_ts_published[SIR_NUMLEVELS][SIR_MAXSTYLE];
+
+#if defined(__HAVE_ATOMIC_H__)
+/** Sequence counter for ::_sir_ts_published; odd while an update is underway. */
+static atomic_uint_fast32_t _sir_ts_seq;
+#endif
 
-    _SIR_LOCK_SECTION(sir_text_style_data, data, SIRMI_TEXTSTYLE, NULL);
-    const char* retval = SIR_UNKNOWN;
+/** Publishes the rendered styles in the map. Must hold SIRMI_TEXTSTYLE. */
+static void _sir_publishtextstyles(const sir_text_style_data* data) {
+#if defined(__HAVE_ATOMIC_H__)
+    uint_fast32_t seq = atomic_load_explicit(&_sir_ts_seq, memory_order_relaxed);
+    atomic_store_explicit(&_sir_ts_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+#endif
 
-    _SIR_DECLARE_BIN_SEARCH(low, high);
-    _SIR_BEGIN_BIN_SEARCH()
+    for (size_t n = 0; n < SIR_NUMLEVELS; n++)
+        (void)memcpy(_sir_ts_published[n], data->map[n].str, SIR_MAXSTYLE);
 
-    if (data->map[_mid].level == level) {
-        retval = data->map[_mid].str;
-        break;
-    }
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_store_explicit(&_sir_ts_seq, seq + 2, memory_order_release);
+#endif
+}
+
+bool _sir_gettextstyle(sir_level level, char buf[SIR_MAXSTYLE]) {
+    size_t idx = _sir_levelidx(level);
+    if (idx >= SIR_NUMLEVELS)
+        return false;
 
-    _SIR_ITERATE_BIN_SEARCH((data->map[_mid].level < level ? 1 : -1));
-    _SIR_END_BIN_SEARCH();
+#if defined(__HAVE_ATOMIC_H__)
+    uint_fast32_t seq = 0;
+    do {
+        while (0U != ((seq = atomic_load_explicit(&_sir_ts_seq,
+            memory_order_acquire)) & 1U))
+            ;
+        (void)memcpy(buf, _sir_ts_published[idx], SIR_MAXSTYLE);
+        atomic_thread_fence(memory_order_acquire);
+    } while (seq != atomic_load_explicit(&_sir_ts_seq, memory_order_relaxed));
+#else
+    _SIR_LOCK_SECTION(sir_text_style_data, data, SIRMI_TEXTSTYLE, false);
+    (void)memcpy(buf, _sir_ts_published[idx], SIR_MAXSTYLE);
     _SIR_UNLOCK_SECTION(SIRMI_TEXTSTYLE);
+#endif
 
-    return retval;
+    buf[SIR_MAXSTYLE - 1] = '\0';
+    return true;
 }
 
 bool _sir_settextstyle(sir_level level, const sir_textstyle* style) {
@@ -72,22 +101,20 @@ bool _sir_settextstyle(sir_level level, const sir_textstyle* style) {
     if (!_sir_sanity() || !_sir_validlevel(level))
         return false;
 
-    _SIR_LOCK_SECTION(sir_text_style_data, data, SIRMI_TEXTSTYLE, false);
-    bool updated              = false;
-    static const size_t low   = 0;
-    static const size_t high  = SIR_NUMLEVELS - 1;
+    size_t idx = _sir_levelidx(level);
+    SIR_ASSERT(idx < SIR_NUMLEVELS && sir_level_to_style_map[idx].level == level);
 
-    _SIR_DECLARE_BIN_SEARCH(low, high);
-    _SIR_BEGIN_BIN_SEARCH()
+    _SIR_LOCK_SECTION(sir_text_style_data, data, SIRMI_TEXTSTYLE, false);
+    sir_level_style_tuple* tuple = &data->map[idx];
+    sir_textstyle old_style      = tuple->style;
 
-    if (data->map[_mid].level == level) {
-        (void)memcpy(&data->map[_mid].style, style, sizeof(sir_textstyle));
-        updated = _sir_formatstyle(*data->color_mode, style, data->map[_mid].str);
-        break;
-    }
+    (void)memcpy(&tuple->style, style, sizeof(sir_textstyle));
+    bool updated = _sir_formatstyle(*data->color_mode, style, tuple->str);
+    if (updated)
+        _sir_publishtextstyles(data);
+    else
+        tuple->style = old_style;
 
-    _SIR_ITERATE_BIN_SEARCH((data->map[_mid].level < level ? 1 : -1));
-    _SIR_END_BIN_SEARCH();
     _SIR_UNLOCK_SECTION(SIRMI_TEXTSTYLE);
 
     SIR_ASSERT(updated);
@@ -127,6 +154,8 @@ bool _sir_resettextstyles(void) {
             data->map[n].str));
     }
 
+    _sir_publishtextstyles(data);
+
     _SIR_UNLOCK_SECTION(SIRMI_TEXTSTYLE);
     return all_ok;
 }
@@ -224,10 +253,11 @@ bool _sir_settextstyle(sir_level level, const sir_textstyle* style) {
     return false;
 }
 
-const char* _sir_gettextstyle(sir_level level) { // GCOVR_EXCL_START
+bool _sir_gettextstyle(sir_level level, char buf[SIR_MAXSTYLE]) { // GCOVR_EXCL_START
     SIR_UNUSED(level);
+    SIR_UNUSED(buf);
     SIR_ASSERT(false);
-    return NULL;
+    return false;
 }
 
 const sir_textstyle* _sir_getdefstyle(sir_level level) {
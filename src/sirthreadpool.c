@@ -36,6 +36,46 @@
 #include "sir/queue.h"
 #include "sir/mutex.h"
 
+/**
+ * Each worker has its own queue. Jobs submitted from outside the pool are dealt
+ * out round-robin; jobs submitted by a job go to the queue of the worker
+ * running it. A worker whose queue is empty steals from the others before it
+ * goes to sleep, and a submission wakes at most one sleeping worker per job.
+ *
+ * Jobs live in a slab allocated with the pool and are recycled through a free
+ * list, so submitting one never allocates; the slab also bounds the number of
+ * jobs outstanding, which guarantees that no worker's queue can overflow.
+ */
+typedef struct {
+    sir_threadpool* pool; /**< The pool the worker belongs to. */
+    sir_queue* jobs;      /**< Jobs assigned to this worker (FIFO). */
+    sir_thread thread;    /**< The worker's thread. */
+    size_t index;         /**< The worker's index in the pool. */
+} sir_threadpool_worker;
+
+struct _sir_threadpool {
+    sir_threadpool_worker* workers; /**< One per thread. */
+    size_t num_threads;             /**< The number of threads in the pool. */
+    sir_threadpool_job* slab;       /**< Storage for every job in the pool. */
+    sir_queue* free;                /**< Jobs in `slab` not currently in use. */
+    sir_condition cond;             /**< Signaled when a job is ready. */
+    sir_mutex mutex;                /**< Paired with `cond`. */
+    char name[SIR_THREADPOOL_MAXNAME]; /**< Prefix for the threads' names. */
+    int nice;                       /**< Added to each thread's niceness. */
+#if defined(__HAVE_ATOMIC_H__)
+    atomic_size_t next;             /**< Round-robin index for submissions. */
+    atomic_size_t sleeping;         /**< Workers waiting on `cond`. */
+    atomic_bool cancel;             /**< Causes workers to exit when true. */
+#else
+    size_t next;
+    size_t sleeping;
+    bool cancel;
+#endif
+};
+
+/** The worker running on the current thread, if any. */
+static _sir_thread_local sir_threadpool_worker* _sir_tp_self;
+
 #if !defined(__WIN__)
 static void* thread_pool_proc(void* arg);
 #else
@@ -44,30 +84,135 @@ static unsigned __stdcall thread_pool_proc(void* arg);
 # pragma warning(disable: 6001)
 #endif
 
-bool _sir_threadpool_create(sir_threadpool** pool, size_t num_threads) {
-    if (!pool || !num_threads || num_threads > SIR_THREADPOOL_MAX_THREADS)
+#if defined(__GLIBC__) && defined(_GNU_SOURCE) && defined(CPU_SET)
+# define SIR_THREADPOOL_AFFINITY
+#endif
+
+#if !defined(__WIN__)
+/** Applies the stack size and CPU affinity in `config` to `attr`. */
+static
+bool _sir_threadpool_setattr(pthread_attr_t* attr, const sir_threadpool_config* config) {
+    if (config->stack_size > 0) {
+        int op = pthread_attr_setstacksize(attr, config->stack_size);
+        if (0 != op)
+            return _sir_handleerr(op);
+    }
+
+    if (config->num_cpus > 0) {
+# if defined(SIR_THREADPOOL_AFFINITY)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (size_t n = 0; n < config->num_cpus; n++) {
+            if (config->cpus[n] >= CPU_SETSIZE)
+                return _sir_seterror(_SIR_E_INVALID);
+            CPU_SET(config->cpus[n], &cpus);
+        }
+
+        int op = pthread_attr_setaffinity_np(attr, sizeof(cpus), &cpus);
+        if (0 != op)
+            return _sir_handleerr(op);
+# else
+        return _sir_seterror(_SIR_E_UNAVAIL);
+# endif
+    }
+
+    return true;
+}
+#else /* __WIN__ */
+/** Applies the CPU affinity and niceness in `config` to a suspended thread. */
+static
+bool _sir_threadpool_setthread(HANDLE thread, const sir_threadpool_config* config) {
+    if (config->num_cpus > 0) {
+        DWORD_PTR mask = 0;
+        for (size_t n = 0; n < config->num_cpus; n++) {
+            if (config->cpus[n] >= sizeof(DWORD_PTR) * CHAR_BIT)
+                return _sir_seterror(_SIR_E_INVALID);
+            mask |= (DWORD_PTR)1 << config->cpus[n];
+        }
+
+        if (!SetThreadAffinityMask(thread, mask))
+            return _sir_handlewin32err(GetLastError());
+    }
+
+    if (0 != config->nice) {
+        int priority = config->nice >= 10 ? THREAD_PRIORITY_LOWEST :
+                       config->nice > 0 ? THREAD_PRIORITY_BELOW_NORMAL :
+                       config->nice > -10 ? THREAD_PRIORITY_ABOVE_NORMAL :
+                       THREAD_PRIORITY_HIGHEST;
+        if (!SetThreadPriority(thread, priority))
+            return _sir_handlewin32err(GetLastError());
+    }
+
+    return true;
+}
+#endif
+
+bool _sir_threadpool_create(sir_threadpool** pool, const sir_threadpool_config* config) {
+    sir_threadpool_config defaults = {0};
+    if (!config)
+        config = &defaults;
+
+    if (!pool || config->num_threads > SIR_THREADPOOL_MAX_THREADS ||
+        (config->num_cpus > 0 && !config->cpus))
         return _sir_seterror(_SIR_E_INVALID);
 
+#if !defined(SIR_THREADPOOL_AFFINITY) && !defined(__WIN__)
+    if (config->num_cpus > 0)
+        return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+#if !defined(__linux__) && !defined(__WIN__)
+    if (0 != config->nice)
+        return _sir_seterror(_SIR_E_UNAVAIL);
+#endif
+
+    size_t num_threads = config->num_threads;
+    if (0 == num_threads) {
+        long nprocs = __sir_nprocs(false);
+        num_threads = nprocs < 1 ? 1 : nprocs > SIR_THREADPOOL_MAX_THREADS ?
+            SIR_THREADPOOL_MAX_THREADS : (size_t)nprocs;
+    }
+
     *pool = calloc(1, sizeof(sir_threadpool));
     if (!*pool)
         return _sir_handleerr(errno);
 
-    (*pool)->threads = calloc(num_threads, sizeof(sir_thread));
-    if (!(*pool)->threads) {
+    (*pool)->workers = calloc(num_threads, sizeof(sir_threadpool_worker));
+    (*pool)->slab    = calloc(SIR_THREADPOOL_QUEUE_SIZE, sizeof(sir_threadpool_job));
+    if (!(*pool)->workers || !(*pool)->slab) {
         int err = errno;
+        _sir_safefree(&(*pool)->workers);
+        _sir_safefree(&(*pool)->slab);
         _sir_safefree(pool);
         return _sir_handleerr(err);
     }
 
-    (*pool)->num_threads = num_threads;
+    (*pool)->nice = config->nice;
+    _sir_snprintf_trunc((*pool)->name, SIR_THREADPOOL_MAXNAME, "%s", config->name ?
+        config->name : SIR_THREADPOOL_NAME);
 
-    if (!_sir_queue_create(&(*pool)->jobs) || !_sir_condcreate(&(*pool)->cond) ||
-        !_sir_mutexcreate(&(*pool)->mutex)) {
+    if (!_sir_condcreate(&(*pool)->cond) || !_sir_mutexcreate(&(*pool)->mutex) ||
+        !_sir_queue_create(&(*pool)->free, SIR_THREADPOOL_QUEUE_SIZE)) {
         bool destroy = _sir_threadpool_destroy(pool);
         SIR_ASSERT_UNUSED(destroy, destroy);
         return false;
     }
 
+    for (size_t n = 0; n < SIR_THREADPOOL_QUEUE_SIZE; n++) {
+        bool pushed = _sir_queue_push((*pool)->free, &(*pool)->slab[n]);
+        SIR_ASSERT_UNUSED(pushed, pushed);
+    }
+
+    (*pool)->num_threads = num_threads;
+    for (size_t n = 0; n < num_threads; n++) {
+        (*pool)->workers[n].pool  = *pool;
+        (*pool)->workers[n].index = n;
+        if (!_sir_queue_create(&(*pool)->workers[n].jobs, SIR_THREADPOOL_QUEUE_SIZE)) {
+            bool destroy = _sir_threadpool_destroy(pool);
+            SIR_ASSERT_UNUSED(destroy, destroy);
+            return false;
+        }
+    }
+
 #if !defined(__WIN__)
     pthread_attr_t attr = {0};
     int op = pthread_attr_init(&attr);
@@ -76,27 +221,48 @@ bool _sir_threadpool_create(sir_threadpool** pool, size_t num_threads) {
         SIR_ASSERT_UNUSED(destroy, destroy);
         return _sir_handleerr(op);
     }
+
+    if (!_sir_threadpool_setattr(&attr, config)) {
+        op = pthread_attr_destroy(&attr);
+        SIR_ASSERT_UNUSED(0 == op, op);
+        bool destroy = _sir_threadpool_destroy(pool);
+        SIR_ASSERT_UNUSED(destroy, destroy);
+        return false;
+    }
 #endif
 
     int thrd_err     = 0;
     bool thrd_create = true;
     for (size_t n = 0; n < num_threads; n++) {
+        sir_threadpool_worker* worker = &(*pool)->workers[n];
 #if !defined(__WIN__)
-        op = pthread_create(&(*pool)->threads[n], &attr, &thread_pool_proc, *pool);
+        op = pthread_create(&worker->thread, &attr, &thread_pool_proc, worker);
         if (0 != op) {
-            (*pool)->threads[n] = 0;
+            worker->thread = 0;
             thrd_err    = op;
             thrd_create = false;
             break;
         }
 #else /* __WIN__ */
-        (*pool)->threads[n] = (HANDLE)_beginthreadex(NULL, 0, &thread_pool_proc,
-            *pool, 0, NULL);
-        if (!(*pool)->threads[n]) {
+        /* suspended, so that it never runs anywhere it isn't supposed to. */
+        worker->thread = (HANDLE)_beginthreadex(NULL, (unsigned)config->stack_size,
+            &thread_pool_proc, worker, CREATE_SUSPENDED, NULL);
+        if (!worker->thread) {
             thrd_err    = errno;
             thrd_create = false;
             break;
         }
+
+        bool set = _sir_threadpool_setthread(worker->thread, config);
+        if ((DWORD)-1 == ResumeThread(worker->thread)) {
+            thrd_err = (int)GetLastError();
+            set      = false;
+        }
+        if (!set) {
+            /* it exits right away; _sir_threadpool_destroy joins it. */
+            thrd_create = false;
+            break;
+        }
 #endif
     }
 
@@ -108,33 +274,139 @@ bool _sir_threadpool_create(sir_threadpool** pool, size_t num_threads) {
     if (!thrd_create) {
         bool destroy = _sir_threadpool_destroy(pool);
         SIR_ASSERT_UNUSED(destroy, destroy);
-        return _sir_handleerr(thrd_err);
+        return 0 != thrd_err ? _sir_handleerr(thrd_err) : false;
     }
 
+    _sir_selflog("created %zu thread(s) named '%s.N'", num_threads, (*pool)->name);
     return !!*pool;
 }
 
-bool _sir_threadpool_add_job(sir_threadpool* pool, sir_threadpool_job* job) {
-    bool retval = false;
+size_t _sir_threadpool_numthreads(const sir_threadpool* pool) {
+    return pool ? pool->num_threads : 0;
+}
 
-    if (pool && pool->jobs && job && job->fn && job->data) {
-        bool locked = _sir_mutexlock(&pool->mutex);
-        SIR_ASSERT(locked);
+static
+bool _sir_threadpool_cancelled(sir_threadpool* pool) {
+#if defined(__HAVE_ATOMIC_H__)
+    return atomic_load(&pool->cancel);
+#else
+    bool locked = _sir_mutexlock(&pool->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+    bool cancel = pool->cancel;
+    bool unlocked = _sir_mutexunlock(&pool->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+    return cancel;
+#endif
+}
 
-        if (locked) {
-            if (_sir_queue_push(pool->jobs, job)) {
-                retval = _sir_condbroadcast(&pool->cond);
-                _sir_selflog("added job; new size: %zu", _sir_queue_size(pool->jobs));
-            }
+/** Picks the queue a new job goes to: the submitting worker's own, if a job is
+ * submitting it, or the next in turn. */
+static
+sir_queue* _sir_threadpool_pickqueue(sir_threadpool* pool) {
+    if (_sir_tp_self && pool == _sir_tp_self->pool)
+        return _sir_tp_self->jobs;
 
-            bool unlocked = _sir_mutexunlock(&pool->mutex);
-            SIR_ASSERT_UNUSED(unlocked, unlocked);
+#if defined(__HAVE_ATOMIC_H__)
+    size_t next = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+#else
+    bool locked = _sir_mutexlock(&pool->mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+    size_t next = pool->next++;
+    bool unlocked = _sir_mutexunlock(&pool->mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+#endif
+
+    return pool->workers[next % pool->num_threads].jobs;
+}
+
+/** Wakes up to `count` sleeping workers. */
+static
+bool _sir_threadpool_wake(sir_threadpool* pool, size_t count) {
+#if defined(__HAVE_ATOMIC_H__)
+    /* a worker counts itself as sleeping, then looks at the queues once more
+     * before it waits; either it sees the job just pushed, or this sees it.
+     * the queue push is only a release store, so without the fence (paired
+     * with the one in the worker) the load below could be ordered before it
+     * and both sides would miss each other. */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (0 == atomic_load_explicit(&pool->sleeping, memory_order_relaxed))
+        return true;
+#endif
+
+    bool locked = _sir_mutexlock(&pool->mutex);
+    SIR_ASSERT(locked);
+
+    bool retval = locked;
+    if (locked) {
+#if defined(__HAVE_ATOMIC_H__)
+        size_t sleeping = atomic_load_explicit(&pool->sleeping, memory_order_relaxed);
+#else
+        size_t sleeping = pool->sleeping;
+#endif
+        if (count >= sleeping) {
+            retval = 0 == sleeping || _sir_condbroadcast(&pool->cond);
+        } else {
+            for (size_t n = 0; n < count; n++)
+                _sir_eqland(retval, _sir_condsignal(&pool->cond));
         }
+
+        bool unlocked = _sir_mutexunlock(&pool->mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
     }
 
     return retval;
 }
 
+bool _sir_threadpool_add_job(sir_threadpool* pool, bool (*fn)(void*), void* data) {
+    sir_threadpool_job job = {fn, data};
+    return _sir_threadpool_add_jobs(pool, &job, 1);
+}
+
+bool _sir_threadpool_add_jobs(sir_threadpool* pool, const sir_threadpool_job* jobs,
+    size_t count) {
+    if (!pool || !pool->free || !jobs || !count)
+        return _sir_seterror(_SIR_E_INVALID);
+
+    for (size_t n = 0; n < count; n++)
+        if (!jobs[n].fn || !jobs[n].data)
+            return _sir_seterror(_SIR_E_INVALID);
+
+    /* claim every job up front, so that the batch is queued all or nothing;
+     * until they're filled in, claimed jobs are chained through `data`. */
+    sir_threadpool_job* claimed = NULL;
+    for (size_t n = 0; n < count; n++) {
+        sir_threadpool_job* job = NULL;
+        if (!_sir_queue_pop(pool->free, (void**)&job)) {
+            while (claimed) {
+                job     = claimed;
+                claimed = (sir_threadpool_job*)job->data;
+                bool pushed = _sir_queue_push(pool->free, job);
+                SIR_ASSERT_UNUSED(pushed, pushed);
+            }
+
+            _sir_selflog("error: no room for %zu job(s) (capacity: %d)", count,
+                SIR_THREADPOOL_QUEUE_SIZE);
+            return _sir_seterror(_SIR_E_NOROOM);
+        }
+
+        job->data = claimed;
+        claimed   = job;
+    }
+
+    for (size_t n = 0; n < count; n++) {
+        sir_threadpool_job* job = claimed;
+        claimed                 = (sir_threadpool_job*)job->data;
+        *job                    = jobs[n];
+
+        /* there are no more jobs than any one queue can hold, so this can't fail. */
+        bool pushed = _sir_queue_push(_sir_threadpool_pickqueue(pool), job);
+        SIR_ASSERT_UNUSED(pushed, pushed);
+    }
+
+    _sir_selflog("added %zu job(s)", count);
+    return _sir_threadpool_wake(pool, count);
+}
+
 bool _sir_threadpool_destroy(sir_threadpool** pool) {
     if (!pool || !*pool)
         return _sir_seterror(_SIR_E_INVALID);
@@ -144,7 +416,11 @@ bool _sir_threadpool_destroy(sir_threadpool** pool) {
 
     if (locked) {
         _sir_selflog("broadcasting signal to condition var...");
+#if defined(__HAVE_ATOMIC_H__)
+        atomic_store(&(*pool)->cancel, true);
+#else
         (*pool)->cancel = true;
+#endif
 
         bool bcast = _sir_condbroadcast(&(*pool)->cond);
         SIR_ASSERT_UNUSED(bcast, bcast);
@@ -155,27 +431,46 @@ bool _sir_threadpool_destroy(sir_threadpool** pool) {
 
     bool destroy = true;
     for (size_t n = 0; n < (*pool)->num_threads; n++) {
-        SIR_ASSERT(0 != (*pool)->threads[n]);
-        if (0 == (*pool)->threads[n])
+        sir_threadpool_worker* worker = &(*pool)->workers[n];
+        if (0 == worker->thread)
             continue;
         _sir_selflog("joining thread %zu of %zu...", n + 1, (*pool)->num_threads);
 #if !defined(__WIN__)
-        int join = pthread_join((*pool)->threads[n], NULL);
+        int join = pthread_join(worker->thread, NULL);
         SIR_ASSERT(0 == join);
         _sir_eqland(destroy, 0 == join);
 #else /* __WIN__ */
-        DWORD join = WaitForSingleObject((*pool)->threads[n], INFINITE);
+        DWORD join = WaitForSingleObject(worker->thread, INFINITE);
         SIR_ASSERT(WAIT_OBJECT_0 == join);
         _sir_eqland(destroy, WAIT_OBJECT_0 == join);
         if (WAIT_OBJECT_0 == join) {
-            BOOL closed = CloseHandle((*pool)->threads[n]);
+            BOOL closed = CloseHandle(worker->thread);
             SIR_ASSERT_UNUSED(closed, closed);
             _sir_eqland(destroy, closed);
         }
 #endif
     }
 
-    _sir_eqland(destroy, _sir_queue_destroy(&(*pool)->jobs));
+    /* the queues hold pointers into the slab, which mustn't be freed one by one. */
+    size_t discarded = 0;
+    void* job        = NULL;
+    for (size_t n = 0; n < (*pool)->num_threads; n++) {
+        sir_queue* jobs = (*pool)->workers[n].jobs;
+        if (!jobs)
+            continue;
+        while (_sir_queue_pop(jobs, &job))
+            discarded++;
+        _sir_eqland(destroy, _sir_queue_destroy(&jobs));
+    }
+
+    if (discarded > 0)
+        _sir_selflog("discarded %zu job(s) that had not yet run", discarded);
+
+    if ((*pool)->free) {
+        while (_sir_queue_pop((*pool)->free, &job))
+            ;
+        _sir_eqland(destroy, _sir_queue_destroy(&(*pool)->free));
+    }
     SIR_ASSERT(destroy);
 
     _sir_eqland(destroy, _sir_conddestroy(&(*pool)->cond));
@@ -184,55 +479,110 @@ bool _sir_threadpool_destroy(sir_threadpool** pool) {
     _sir_eqland(destroy, _sir_mutexdestroy(&(*pool)->mutex));
     SIR_ASSERT(destroy);
 
-    _sir_safefree(&(*pool)->threads);
+    _sir_safefree(&(*pool)->workers);
+    _sir_safefree(&(*pool)->slab);
     _sir_safefree(pool);
 
     return destroy;
 }
 
+/** Takes the next job from the worker's own queue or, failing that, from one
+ * of the others'. */
+static
+sir_threadpool_job* _sir_threadpool_take(sir_threadpool_worker* worker) {
+    sir_threadpool* pool    = worker->pool;
+    sir_threadpool_job* job = NULL;
+
+    for (size_t n = 0; n < pool->num_threads; n++) {
+        sir_queue* jobs = pool->workers[(worker->index + n) % pool->num_threads].jobs;
+        if (_sir_queue_pop(jobs, (void**)&job))
+            return job;
+    }
+
+    return NULL;
+}
+
 #if !defined(__WIN__)
 static void* thread_pool_proc(void* arg)
 #else
 static unsigned __stdcall thread_pool_proc(void* arg)
 #endif
 {
-    sir_threadpool* pool = (sir_threadpool*)arg;
-    while (true) {
-        bool locked = _sir_mutexlock(&pool->mutex);
-        SIR_ASSERT_UNUSED(locked, locked);
+    sir_threadpool_worker* worker = (sir_threadpool_worker*)arg;
+    sir_threadpool* pool          = worker->pool;
+
+    _sir_tp_self = worker;
+
+    /* most platforms limit thread names to 15 characters; keep the index. */
+    char name[SIR_THREADPOOL_MAXNAME] = {0};
+    _sir_snprintf_trunc(name, SIR_THREADPOOL_MAXNAME, "%.*s.%zu",
+        SIR_THREADPOOL_MAXNAME - 5, pool->name, worker->index);
+    (void)_sir_setthreadname(name);
+
+#if defined(__linux__)
+    /* on Linux, niceness is per-thread; elsewhere, it's set before the thread
+     * runs, or not supported. */
+    if (0 != pool->nice) {
+        errno  = 0;
+        int cur = getpriority(PRIO_PROCESS, (id_t)_sir_gettid());
+        if ((-1 == cur && 0 != errno) ||
+            0 != setpriority(PRIO_PROCESS, (id_t)_sir_gettid(), cur + pool->nice))
+            _sir_selflog("error: failed to adjust niceness of '%s' by %d (%d)", name,
+                pool->nice, errno);
+    }
+#endif
 
-        while (_sir_queue_isempty(pool->jobs) && !pool->cancel) {
+    while (!_sir_threadpool_cancelled(pool)) {
+        sir_threadpool_job* job = _sir_threadpool_take(worker);
+        if (!job) {
+            bool locked = _sir_mutexlock(&pool->mutex);
+            SIR_ASSERT_UNUSED(locked, locked);
+
+#if defined(__HAVE_ATOMIC_H__)
+            (void)atomic_fetch_add(&pool->sleeping, 1);
+            /* pairs with the fence in _sir_threadpool_wake. */
+            atomic_thread_fence(memory_order_seq_cst);
+            while (!(job = _sir_threadpool_take(worker)) && !atomic_load(&pool->cancel)) {
+#else
+            pool->sleeping++;
+            while (!(job = _sir_threadpool_take(worker)) && !pool->cancel) {
+#endif
 #if !defined(__WIN__)
-            /* seconds; absolute fixed time. */
-            sir_wait wait = {time(NULL) + 2, 0};
+                /* seconds; absolute fixed time. */
+                sir_wait wait = {time(NULL) + 2, 0};
 #else
-            /* msec; relative from now. */
-            sir_wait wait = 2000;
+                /* msec; relative from now. */
+                sir_wait wait = 2000;
+#endif
+                (void)_sir_condwait_timeout(&pool->cond, &pool->mutex, &wait);
+            }
+#if defined(__HAVE_ATOMIC_H__)
+            (void)atomic_fetch_sub(&pool->sleeping, 1);
+#else
+            pool->sleeping--;
 #endif
-            (void)_sir_condwait_timeout(&pool->cond, &pool->mutex, &wait);
-        }
-
-        if (!pool->cancel) {
-            sir_threadpool_job* job = NULL;
-            bool job_popped         = _sir_queue_pop(pool->jobs, (void**)&job);
 
             bool unlocked = _sir_mutexunlock(&pool->mutex);
             SIR_ASSERT_UNUSED(unlocked, unlocked);
 
-            if (job_popped) {
-                _sir_selflog("picked up job (fn: %"PRIxPTR", data: %p)",
-                    (uintptr_t)job->fn, job->data);
-                job->fn(job->data);
-                _sir_safefree(&job);
-            }
-        } else {
-            _sir_selflog("cancel flag is set; exiting");
-            bool unlocked = _sir_mutexunlock(&pool->mutex);
-            SIR_ASSERT_UNUSED(unlocked, unlocked);
-            break;
+            if (!job)
+                continue;
         }
+
+        /* the job goes back to the free list before it runs, so that it can
+         * submit more without running out. */
+        sir_threadpool_job todo = *job;
+        bool pushed = _sir_queue_push(pool->free, job);
+        SIR_ASSERT_UNUSED(pushed, pushed);
+
+        _sir_selflog("worker %zu picked up job (fn: %"PRIxPTR", data: %p)",
+            worker->index, (uintptr_t)todo.fn, todo.data);
+        (void)todo.fn(todo.data);
     }
 
+    _sir_selflog("cancel flag is set; exiting");
+    _sir_tp_self = NULL;
+
 #if !defined(__WIN__)
     return NULL;
 #else /* __WIN__ */
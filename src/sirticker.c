@@ -0,0 +1,257 @@
+/*
+ * sirticker.c
+ *
+ * Version: 2.2.6
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * -----------------------------------------------------------------------------
+ */
+
+
+#include "sir/ticker.h"
+#include "sir/clock.h"
+#include "sir/console.h"
+#include "sir/netsyslog.h"
+#include "sir/condition.h"
+#include "sir/internal.h"
+#include "sir/mutex.h"
+
+/** State of the background ticker thread. */
+static struct {
+    sir_thread thread;
+    sir_condition cond;
+    sir_mutex mutex;
+    bool running;
+    bool cancel;
+} _sir_ticker = {0};
+
+/** Serializes starting and stopping the ticker, which may be requested by more
+ * than one subsystem. */
+static sir_mutex _sir_ticker_startstop;
+static sir_once _sir_ticker_once = SIR_ONCE_INIT;
+
+#if !defined(__WIN__)
+static
+void _sir_ticker_init_once(void) {
+    bool created = _sir_mutexcreate(&_sir_ticker_startstop);
+    SIR_ASSERT_UNUSED(created, created);
+}
+#else /* __WIN__ */
+static
+BOOL CALLBACK _sir_ticker_init_once(PINIT_ONCE ponce, PVOID param, PVOID* ctx) {
+    SIR_UNUSED(ponce);
+    SIR_UNUSED(param);
+    SIR_UNUSED(ctx);
+    return _sir_mutexcreate(&_sir_ticker_startstop) ? TRUE : FALSE;
+}
+#endif
+
+/** Acquires the start/stop mutex, creating it first if necessary. */
+static
+bool _sir_ticker_lock(void) {
+    return _sir_once(&_sir_ticker_once, _sir_ticker_init_once) &&
+        _sir_mutexlock(&_sir_ticker_startstop);
+}
+
+#if !defined(__WIN__)
+static void* _sir_ticker_proc(void* arg);
+#else
+static unsigned __stdcall _sir_ticker_proc(void* arg);
+#endif
+
+static
+bool _sir_ticker_start_locked(void) {
+    if (_sir_ticker.running)
+        return true;
+
+    if (!_sir_condcreate(&_sir_ticker.cond))
+        return false;
+
+    if (!_sir_mutexcreate(&_sir_ticker.mutex)) {
+        bool destroyed = _sir_conddestroy(&_sir_ticker.cond);
+        SIR_ASSERT_UNUSED(destroyed, destroyed);
+        return false;
+    }
+
+    _sir_ticker.cancel = false;
+
+#if !defined(__WIN__)
+    int op = pthread_create(&_sir_ticker.thread, NULL, &_sir_ticker_proc, NULL);
+    bool created = 0 == op ? true : _sir_handleerr(op);
+#else /* __WIN__ */
+    _sir_ticker.thread = (HANDLE)_beginthreadex(NULL, 0, &_sir_ticker_proc,
+        NULL, 0, NULL);
+    bool created = NULL != _sir_ticker.thread ? true : _sir_handleerr(errno);
+#endif
+
+    if (!created) {
+        bool destroyed = _sir_conddestroy(&_sir_ticker.cond);
+        _sir_eqland(destroyed, _sir_mutexdestroy(&_sir_ticker.mutex));
+        SIR_ASSERT_UNUSED(destroyed, destroyed);
+        return false;
+    }
+
+    _sir_ticker.running = true;
+    _sir_selflog("started ticker thread (interval: %d msec)", SIR_TICKER_INTERVAL);
+
+    return true;
+}
+
+bool _sir_ticker_start(void) {
+    if (!_sir_ticker_lock())
+        return false;
+
+    bool retval = _sir_ticker_start_locked();
+
+    bool unlocked = _sir_mutexunlock(&_sir_ticker_startstop);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+
+static
+bool _sir_ticker_stop_locked(void) {
+    if (!_sir_ticker.running)
+        return true;
+
+    bool locked = _sir_mutexlock(&_sir_ticker.mutex);
+    SIR_ASSERT(locked);
+
+    if (locked) {
+        _sir_ticker.cancel = true;
+
+        bool bcast = _sir_condbroadcast(&_sir_ticker.cond);
+        SIR_ASSERT_UNUSED(bcast, bcast);
+
+        bool unlocked = _sir_mutexunlock(&_sir_ticker.mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+    }
+
+#if !defined(__WIN__)
+    int join    = pthread_join(_sir_ticker.thread, NULL);
+    bool joined = 0 == join ? true : _sir_handleerr(join);
+#else /* __WIN__ */
+    bool joined = WAIT_OBJECT_0 == WaitForSingleObject(_sir_ticker.thread, INFINITE);
+    if (joined)
+        _sir_eqland(joined, FALSE != CloseHandle(_sir_ticker.thread));
+#endif
+    SIR_ASSERT(joined);
+
+    bool destroyed = _sir_conddestroy(&_sir_ticker.cond);
+    _sir_eqland(destroyed, _sir_mutexdestroy(&_sir_ticker.mutex));
+    SIR_ASSERT(destroyed);
+
+    _sir_ticker.running = false;
+    _sir_selflog("stopped ticker thread");
+
+    return joined && destroyed;
+}
+
+bool _sir_ticker_stop(void) {
+    if (!_sir_ticker_lock())
+        return false;
+
+    bool retval = _sir_ticker_stop_locked();
+
+    bool unlocked = _sir_mutexunlock(&_sir_ticker_startstop);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+    return retval;
+}
+
+bool _sir_ticker_running(void) {
+    return _sir_ticker.running;
+}
+
+#if !defined(__WIN__)
+static void* _sir_ticker_proc(void* arg)
+#else
+static unsigned __stdcall _sir_ticker_proc(void* arg)
+#endif
+{
+    SIR_UNUSED(arg);
+
+    (void)_sir_setthreadname("sir_ticker");
+
+    bool locked = _sir_mutexlock(&_sir_ticker.mutex);
+    SIR_ASSERT_UNUSED(locked, locked);
+
+    /* when publishing the time, the ticker wakes more often, but the rest of
+     * the work is still only done every SIR_TICKER_INTERVAL msec. */
+    static const int per_tick = SIR_TICKER_INTERVAL > SIR_CLOCK_CACHE_INTERVAL
+        ? SIR_TICKER_INTERVAL / SIR_CLOCK_CACHE_INTERVAL : 1;
+    int wakeups = 0;
+
+    while (!_sir_ticker.cancel) {
+        bool cached  = _sir_clock_cached();
+        int interval = cached ? SIR_CLOCK_CACHE_INTERVAL : SIR_TICKER_INTERVAL;
+#if !defined(__WIN__)
+        /* absolute time; the condition uses CLOCK_REALTIME. */
+        sir_wait wait = {0};
+        (void)clock_gettime(CLOCK_REALTIME, &wait);
+        wait.tv_nsec += (long)interval * 1000000L;
+        if (wait.tv_nsec >= 1000000000L) {
+            wait.tv_sec += wait.tv_nsec / 1000000000L;
+            wait.tv_nsec %= 1000000000L;
+        }
+#else
+        /* msec; relative from now. */
+        sir_wait wait = (sir_wait)interval;
+#endif
+        (void)_sir_condwait_timeout(&_sir_ticker.cond, &_sir_ticker.mutex, &wait);
+
+        if (_sir_ticker.cancel)
+            break;
+
+        if (cached) {
+            _sir_clock_publish();
+            if (++wakeups < per_tick)
+                continue;
+        }
+        wakeups = 0;
+
+        bool unlocked = _sir_mutexunlock(&_sir_ticker.mutex);
+        SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+        (void)_sir_flush_stdio();
+#if defined(SIR_NETSYSLOG_ENABLED)
+        (void)_sir_netsyslog_flush();
+#endif
+        (void)_sir_tsc_recalibrate();
+        (void)_sir_limit_flush();
+
+        locked = _sir_mutexlock(&_sir_ticker.mutex);
+        SIR_ASSERT_UNUSED(locked, locked);
+    }
+
+    bool unlocked = _sir_mutexunlock(&_sir_ticker.mutex);
+    SIR_ASSERT_UNUSED(unlocked, unlocked);
+
+#if !defined(__WIN__)
+    return NULL;
+#else /* __WIN__ */
+    return 0U;
+#endif
+}
@@ -0,0 +1,758 @@
+/*
+ * bench.c
+ *
+ * The libsir benchmark suite: throughput and per-call latency across thread
+ * counts, message sizes, destinations, and formatting options.
+ *
+ * Version: 2.2.6
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ * Copyright (c) 2018-2026 Jeffrey H. Johnson <johnsonjh.dev@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+#include "bench.h"
+#include <math.h>
+
+static const sir_cl_arg bench_args[] = {
+    {BENCH_CL_JSONFLAG,   SIR_ULINE("file"),   BENCH_CL_JSONDESC},
+    {BENCH_CL_CALLSFLAG,  SIR_ULINE("n"),      BENCH_CL_CALLSDESC},
+    {BENCH_CL_QUICKFLAG,  "",                  BENCH_CL_QUICKDESC},
+    {BENCH_CL_ONLYFLAG,   SIR_ULINE("prefix"), BENCH_CL_ONLYDESC},
+    {BENCH_CL_LISTFLAG,   "",                  BENCH_CL_LISTDESC},
+    {BENCH_CL_RUNSFLAG,   SIR_ULINE("n"),      BENCH_CL_RUNSDESC},
+    {BENCH_CL_COMPAREFLAG, SIR_ULINE("file"),  BENCH_CL_COMPAREDESC},
+    {BENCH_CL_THRESHFLAG, SIR_ULINE("pct"),    BENCH_CL_THRESHDESC},
+    {SIR_CL_VERSIONFLAG,  "",                  SIR_CL_VERSIONDESC},
+    {SIR_CL_HELPFLAG,     "",                  SIR_CL_HELPDESC},
+};
+
+/** Results are printed here; stdout itself goes to the null device, since it
+ * is one of the destinations being measured. */
+static FILE* report = NULL;
+
+static bool bench_parse_args(int argc, char** argv, bench_config* config);
+static bool bench_redirect_stdout(void);
+static char* bench_load(const char* path);
+static bool bench_samepath(const char* a, const char* b);
+
+int main(int argc, char** argv) {
+#include "tests_malloc.h"
+
+    bench_config config = {NULL, NULL, NULL, BENCH_DEFCALLS, 1, BENCH_DEFTHRESHOLD, false};
+    if (!bench_parse_args(argc, argv, &config))
+        return EXIT_FAILURE;
+
+    long nprocs = _sir_nprocs();
+    if (nprocs < 1)
+        nprocs = 1;
+
+    static bench_scenario scenarios[BENCH_MAXSCENARIOS];
+    static bench_result results[BENCH_MAXSCENARIOS];
+    size_t count = bench_make_scenarios(scenarios, BENCH_MAXSCENARIOS, nprocs);
+
+    if (config.list) {
+        for (size_t n = 0; n < count; n++)
+            (void)printf("%s" SIR_EOL, scenarios[n].name);
+        return EXIT_SUCCESS;
+    }
+
+    /* the baseline is read before anything is written, so that it can't be
+     * replaced by the results it is about to be compared with. */
+    char* baseline = NULL;
+    if (config.compare) {
+        if (config.json && bench_samepath(config.compare, config.json)) {
+            (void)fprintf(stderr, "the baseline (%s) would be overwritten by this run's"
+                " results; use a different --json file" SIR_EOL, config.compare);
+            return EXIT_FAILURE;
+        }
+
+        baseline = bench_load(config.compare);
+        if (!baseline) {
+            (void)fprintf(stderr, "failed to read '%s'!" SIR_EOL, config.compare);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!bench_redirect_stdout()) {
+        (void)fprintf(stderr, "failed to redirect stdout!" SIR_EOL);
+        _sir_safefree(&baseline);
+        return EXIT_FAILURE;
+    }
+
+    (void)fprintf(report, "libsir %s benchmark: %ld processor(s), %zu call(s) per thread,"
+        " %zu run(s)" SIR_EOL SIR_EOL, sir_getversionstring(), nprocs, config.calls, config.runs);
+    (void)fprintf(report, "%-28s %14s %10s %10s %10s %10s" SIR_EOL, "scenario",
+        "calls/sec", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+
+    bool ok    = true;
+    size_t ran = 0;
+    for (size_t n = 0; n < count; n++) {
+        if (config.only && 0 != strncmp(scenarios[n].name, config.only, strlen(config.only)))
+            continue;
+
+        bench_result* res = &results[ran];
+        if (!bench_run_repeated(&scenarios[n], config.calls, config.runs, res)) {
+            (void)fprintf(report, "%-28s %s" SIR_EOL, scenarios[n].name, "skipped (setup failed)");
+            ok = false;
+            continue;
+        }
+
+        (void)fprintf(report, "%-28s %14.0f %10"PRIu64" %10"PRIu64" %10"PRIu64" %10"PRIu64 SIR_EOL,
+            scenarios[n].name, res->throughput, res->p50_ns, res->p99_ns, res->p999_ns,
+            res->max_ns);
+        (void)fflush(report);
+
+        if (ran != n)
+            scenarios[ran] = scenarios[n];
+        ran++;
+    }
+
+    if (config.json) {
+        if (bench_write_json(config.json, scenarios, results, ran, nprocs, config.calls,
+            config.runs))
+            (void)fprintf(report, SIR_EOL "wrote results to %s" SIR_EOL, config.json);
+        else
+            ok = false;
+    }
+
+    if (baseline) {
+        int regressions = bench_compare(config.compare, baseline, scenarios, results, ran,
+            config.threshold);
+        if (0 != regressions)
+            ok = false;
+        _sir_safefree(&baseline);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+size_t bench_make_scenarios(bench_scenario* scenarios, size_t max, long nprocs) {
+    static const size_t sizes[] = {16, 128, 1024};
+    static const size_t files[] = {1, 4, 16};
+    static const struct {
+        const char* name;
+        sir_options opts;
+    } optsets[] = {
+        {"all",     SIRO_ALL},
+        {"notime",  SIRO_NOTIME | SIRO_NOHOST},
+        {"msgonly", SIRO_MSGONLY},
+    };
+
+    const bench_scenario base = {"", 1, 128, true, 0, false, SIRO_ALL, false};
+    size_t count = 0;
+
+#define BENCH_ADD(...) \
+    do { \
+        if (count < max) { \
+            scenarios[count] = base; \
+            _sir_snprintf_trunc(scenarios[count].name, BENCH_MAXNAME, __VA_ARGS__); \
+            count++; \
+        } \
+    } while (false)
+
+    /* thread counts: powers of two up to, and including, nprocs. */
+    size_t threads = 1;
+    while (true) {
+        BENCH_ADD("threads/stdout/%zu", threads);
+        scenarios[count - 1].threads = threads;
+
+        BENCH_ADD("threads/file/%zu", threads);
+        scenarios[count - 1].threads   = threads;
+        scenarios[count - 1].to_stdout = false;
+        scenarios[count - 1].files     = 1;
+
+        if (threads >= (size_t)nprocs)
+            break;
+        threads = threads * 2 < (size_t)nprocs ? threads * 2 : (size_t)nprocs;
+    }
+
+    for (size_t n = 0; n < _sir_countof(sizes); n++) {
+        size_t size = sizes[n] < SIR_MAXMESSAGE / 2 ? sizes[n] : SIR_MAXMESSAGE / 2;
+        BENCH_ADD("size/%zu", size);
+        scenarios[count - 1].msg_size = size;
+    }
+
+    for (size_t n = 0; n < _sir_countof(files); n++) {
+        if (files[n] > SIR_MAXFILES)
+            break;
+        BENCH_ADD("dest/files/%zu", files[n]);
+        scenarios[count - 1].to_stdout = false;
+        scenarios[count - 1].files     = files[n];
+    }
+
+#if !defined(SIR_NO_PLUGINS)
+    BENCH_ADD("dest/plugin");
+    scenarios[count - 1].to_stdout = false;
+    scenarios[count - 1].plugin    = true;
+
+    BENCH_ADD("dest/stdout+files/4+plugin");
+    scenarios[count - 1].files  = 4;
+    scenarios[count - 1].plugin = true;
+#endif
+
+    for (size_t n = 0; n < _sir_countof(optsets); n++) {
+        BENCH_ADD("opts/%s", optsets[n].name);
+        scenarios[count - 1].opts = optsets[n].opts;
+    }
+
+    BENCH_ADD("disabled/1");
+    scenarios[count - 1].disabled = true;
+
+    if (nprocs > 1) {
+        BENCH_ADD("disabled/%ld", nprocs);
+        scenarios[count - 1].disabled = true;
+        scenarios[count - 1].threads  = (size_t)nprocs;
+    }
+
+#undef BENCH_ADD
+
+    return count;
+}
+
+typedef struct {
+    const bench_scenario* scenario;
+    const char* payload;
+    size_t calls;
+    uint64_t* latency;
+} bench_thread_args;
+
+#if !defined(__WIN__)
+static void* bench_thread(void* arg)
+#else
+static unsigned __stdcall bench_thread(void* arg)
+#endif
+{
+    const bench_thread_args* args = (const bench_thread_args*)arg;
+    bool disabled                 = args->scenario->disabled;
+
+    for (size_t n = 0; n < args->calls; n++) {
+        uint64_t start = bench_clock();
+        /* the counter keeps consecutive messages from being squelched. */
+        if (disabled)
+            (void)sir_debug("%zu %s", n, args->payload);
+        else
+            (void)sir_info("%zu %s", n, args->payload);
+        args->latency[n] = bench_clock() - start;
+    }
+
+#if !defined(__WIN__)
+    return NULL;
+#else
+    return 0U;
+#endif
+}
+
+static int bench_cmp_u64(const void* a, const void* b) {
+    uint64_t lhs = *(const uint64_t*)a;
+    uint64_t rhs = *(const uint64_t*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/** Returns the `pct` percentile from a sorted array (nearest rank). */
+static uint64_t bench_percentile(const uint64_t* sorted, size_t count, double pct) {
+    size_t rank = (size_t)((pct / 100.0) * (double)count + 0.5);
+    if (rank < 1)
+        rank = 1;
+    return sorted[(rank > count ? count : rank) - 1];
+}
+
+static bool bench_setup(const bench_scenario* scenario) {
+    sirinit si = {0};
+    if (!sir_makeinit(&si))
+        return false;
+
+    si.d_stdout.levels = scenario->to_stdout ? SIRL_INFO : SIRL_NONE;
+    si.d_stdout.opts   = scenario->opts;
+    si.d_stderr.levels = SIRL_NONE;
+    si.d_syslog.levels = SIRL_NONE;
+    (void)_sir_strncpy(si.name, SIR_MAXNAME, "sirbench", strlen("sirbench"));
+
+    if (!sir_init(&si))
+        return false;
+
+    for (size_t n = 0; n < scenario->files; n++) {
+        char path[SIR_MAXPATH] = {0};
+        _sir_snprintf_trunc(path, SIR_MAXPATH, BENCH_LOGNAME, n);
+        if (0U == sir_addfile(path, SIRL_INFO, scenario->opts | SIRO_NOHDR))
+            return false;
+    }
+
+    if (scenario->plugin && 0U == sir_loadplugin(BENCH_PLUGIN))
+        return false;
+
+    return true;
+}
+
+static void bench_teardown(const bench_scenario* scenario) {
+    (void)sir_cleanup();
+
+    for (size_t n = 0; n < scenario->files; n++) {
+        char path[SIR_MAXPATH] = {0};
+        _sir_snprintf_trunc(path, SIR_MAXPATH, BENCH_LOGNAME, n);
+        rmfile(path, false);
+    }
+}
+
+bool bench_run(const bench_scenario* scenario, size_t calls, bench_result* result) {
+    size_t total      = scenario->threads * calls;
+    uint64_t* latency = (uint64_t*)calloc(total, sizeof(uint64_t));
+    char* payload     = (char*)calloc(scenario->msg_size + 1, sizeof(char));
+    bench_thread_args* args = (bench_thread_args*)calloc(scenario->threads,
+        sizeof(bench_thread_args));
+#if !defined(__WIN__)
+    pthread_t* thrds = (pthread_t*)calloc(scenario->threads, sizeof(pthread_t));
+#else
+    uintptr_t* thrds = (uintptr_t*)calloc(scenario->threads, sizeof(uintptr_t));
+#endif
+
+    bool ok = latency && payload && args && thrds;
+    if (ok) {
+        /* leave room for the counter that precedes the payload. */
+        size_t fill = scenario->msg_size > 8 ? scenario->msg_size - 8 : 1;
+        (void)memset(payload, 'x', fill);
+        ok = bench_setup(scenario);
+    }
+
+    size_t created = 0;
+    uint64_t start = bench_clock();
+
+    for (size_t n = 0; ok && n < scenario->threads; n++) {
+        args[n].scenario = scenario;
+        args[n].payload  = payload;
+        args[n].calls    = calls;
+        args[n].latency  = latency + (n * calls);
+#if !defined(__WIN__)
+        ok = 0 == pthread_create(&thrds[n], NULL, bench_thread, &args[n]);
+#else
+        thrds[n] = _beginthreadex(NULL, 0, bench_thread, &args[n], 0, NULL);
+        ok       = 0 != thrds[n];
+#endif
+        if (ok)
+            created++;
+    }
+
+    for (size_t n = 0; n < created; n++) {
+#if !defined(__WIN__)
+        (void)pthread_join(thrds[n], NULL);
+#else
+        (void)WaitForSingleObject((HANDLE)thrds[n], INFINITE);
+        (void)CloseHandle((HANDLE)thrds[n]);
+#endif
+    }
+
+    uint64_t elapsed = bench_clock() - start;
+    bench_teardown(scenario);
+
+    if (ok) {
+        qsort(latency, total, sizeof(uint64_t), bench_cmp_u64);
+        result->calls      = total;
+        result->msec       = (double)elapsed / 1e6;
+        result->throughput = elapsed > 0 ? (double)total / ((double)elapsed / 1e9) : 0.0;
+        result->p50_ns     = bench_percentile(latency, total, 50.0);
+        result->p99_ns     = bench_percentile(latency, total, 99.0);
+        result->p999_ns    = bench_percentile(latency, total, 99.9);
+        result->max_ns     = latency[total - 1];
+
+        result->runs               = 1;
+        result->throughput_runs[0] = result->throughput;
+        result->p99_runs[0]        = (double)result->p99_ns;
+    }
+
+    _sir_safefree(&thrds);
+    _sir_safefree(&args);
+    _sir_safefree(&payload);
+    _sir_safefree(&latency);
+    return ok;
+}
+
+bool bench_run_repeated(const bench_scenario* scenario, size_t calls, size_t runs,
+    bench_result* result) {
+    bench_result sum = {0};
+
+    for (size_t run = 0; run < runs; run++) {
+        bench_result one = {0};
+        if (!bench_run(scenario, calls, &one))
+            return false;
+
+        sum.calls       = one.calls;
+        sum.msec       += one.msec;
+        sum.throughput += one.throughput;
+        sum.p50_ns     += one.p50_ns;
+        sum.p99_ns     += one.p99_ns;
+        sum.p999_ns    += one.p999_ns;
+        if (one.max_ns > sum.max_ns)
+            sum.max_ns = one.max_ns;
+
+        sum.throughput_runs[run] = one.throughput;
+        sum.p99_runs[run]        = (double)one.p99_ns;
+    }
+
+    sum.runs        = runs;
+    sum.msec       /= (double)runs;
+    sum.throughput /= (double)runs;
+    sum.p50_ns     /= runs;
+    sum.p99_ns     /= runs;
+    sum.p999_ns    /= runs;
+
+    *result = sum;
+    return true;
+}
+
+static void bench_write_runs(FILE* f, const char* key, const double* samples, size_t runs) {
+    (void)fprintf(f, ", \"%s\": [", key);
+    for (size_t n = 0; n < runs; n++)
+        (void)fprintf(f, "%s%.1f", n > 0 ? ", " : "", samples[n]);
+    (void)fprintf(f, "]");
+}
+
+bool bench_write_json(const char* path, const bench_scenario* scenarios,
+    const bench_result* results, size_t count, long nprocs, size_t calls, size_t runs) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        (void)fprintf(report, "failed to open '%s': %s" SIR_EOL, path, strerror(errno));
+        return false;
+    }
+
+    (void)fprintf(f, "{\n  \"libsir\": \"%s\",\n  \"nprocs\": %ld,\n"
+        "  \"calls_per_thread\": %zu,\n  \"runs\": %zu,\n  \"scenarios\": [\n",
+        sir_getversionstring(), nprocs, calls, runs);
+
+    for (size_t n = 0; n < count; n++) {
+        const bench_scenario* s = &scenarios[n];
+        const bench_result* r   = &results[n];
+        (void)fprintf(f, "    {\"name\": \"%s\", \"threads\": %zu, \"msg_size\": %zu,"
+            " \"stdout\": %s, \"files\": %zu, \"plugin\": %s, \"opts\": %"PRIu32","
+            " \"disabled\": %s, \"calls\": %"PRIu64", \"msec\": %.3f,"
+            " \"throughput\": %.1f, \"p50_ns\": %"PRIu64", \"p99_ns\": %"PRIu64","
+            " \"p999_ns\": %"PRIu64", \"max_ns\": %"PRIu64, s->name, s->threads,
+            s->msg_size, s->to_stdout ? "true" : "false", s->files, s->plugin ? "true" : "false",
+            s->opts, s->disabled ? "true" : "false", r->calls, r->msec, r->throughput,
+            r->p50_ns, r->p99_ns, r->p999_ns, r->max_ns);
+        bench_write_runs(f, "throughput_runs", r->throughput_runs, r->runs);
+        bench_write_runs(f, "p99_runs", r->p99_runs, r->runs);
+        (void)fprintf(f, "}%s\n", n + 1 < count ? "," : "");
+    }
+
+    (void)fprintf(f, "  ]\n}\n");
+    return 0 == fclose(f);
+}
+
+uint64_t bench_clock(void) {
+#if defined(__WIN__)
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER now;
+    if (0LL == freq.QuadPart)
+        (void)QueryPerformanceFrequency(&freq);
+    (void)QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * (1e9 / (double)freq.QuadPart));
+#else
+    struct timespec ts = {0};
+    (void)clock_gettime(SIR_INTERVALCLOCK, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static bool bench_redirect_stdout(void) {
+#if !defined(__WIN__)
+    int fd = dup(STDOUT_FILENO);
+    report = -1 != fd ? fdopen(fd, "w") : NULL;
+    return report && NULL != freopen("/dev/null", "w", stdout);
+#else
+    int fd = _dup(_fileno(stdout));
+    report = -1 != fd ? _fdopen(fd, "w") : NULL;
+    return report && NULL != freopen("NUL", "w", stdout);
+#endif
+}
+
+static bool bench_parse_args(int argc, char** argv, bench_config* config) {
+    for (int n = 1; n < argc; n++) {
+        const sir_cl_arg* arg = find_cl_arg(argv[n], bench_args, _sir_countof(bench_args));
+        if (!arg) {
+            ERROR_MSG("unknown option '%s'", argv[n]);
+            print_usage_info(bench_args, _sir_countof(bench_args));
+            return false;
+        }
+
+        bool needs_value = 0 == strcmp(arg->flag, BENCH_CL_JSONFLAG) ||
+                           0 == strcmp(arg->flag, BENCH_CL_CALLSFLAG) ||
+                           0 == strcmp(arg->flag, BENCH_CL_ONLYFLAG) ||
+                           0 == strcmp(arg->flag, BENCH_CL_RUNSFLAG) ||
+                           0 == strcmp(arg->flag, BENCH_CL_COMPAREFLAG) ||
+                           0 == strcmp(arg->flag, BENCH_CL_THRESHFLAG);
+        if (needs_value && (n + 1 >= argc || '-' == *argv[n + 1])) {
+            ERROR_MSG("value expected for '%s'", arg->flag);
+            print_usage_info(bench_args, _sir_countof(bench_args));
+            return false;
+        }
+
+        if (0 == strcmp(arg->flag, BENCH_CL_JSONFLAG)) {
+            config->json = argv[++n];
+        } else if (0 == strcmp(arg->flag, BENCH_CL_CALLSFLAG)) {
+            char* end    = NULL;
+            config->calls = (size_t)strtoul(argv[++n], &end, 10);
+            if (!end || '\0' != *end || 0 == config->calls) {
+                ERROR_MSG("invalid argument to %s: '%s'", BENCH_CL_CALLSFLAG, argv[n]);
+                return false;
+            }
+        } else if (0 == strcmp(arg->flag, BENCH_CL_QUICKFLAG)) {
+            config->calls = BENCH_QUICKCALLS;
+        } else if (0 == strcmp(arg->flag, BENCH_CL_ONLYFLAG)) {
+            config->only = argv[++n];
+        } else if (0 == strcmp(arg->flag, BENCH_CL_LISTFLAG)) {
+            config->list = true;
+        } else if (0 == strcmp(arg->flag, BENCH_CL_RUNSFLAG)) {
+            char* end    = NULL;
+            config->runs = (size_t)strtoul(argv[++n], &end, 10);
+            if (!end || '\0' != *end || 0 == config->runs || config->runs > BENCH_MAXRUNS) {
+                ERROR_MSG("invalid argument to %s: '%s' (1..%d)", BENCH_CL_RUNSFLAG, argv[n],
+                    BENCH_MAXRUNS);
+                return false;
+            }
+        } else if (0 == strcmp(arg->flag, BENCH_CL_COMPAREFLAG)) {
+            config->compare = argv[++n];
+        } else if (0 == strcmp(arg->flag, BENCH_CL_THRESHFLAG)) {
+            char* end         = NULL;
+            config->threshold = strtod(argv[++n], &end);
+            if (!end || '\0' != *end || config->threshold < 0.0) {
+                ERROR_MSG("invalid argument to %s: '%s'", BENCH_CL_THRESHFLAG, argv[n]);
+                return false;
+            }
+        } else if (0 == strcmp(arg->flag, SIR_CL_VERSIONFLAG)) {
+            print_libsir_version();
+            return false;
+        } else {
+            print_usage_info(bench_args, _sir_countof(bench_args));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Two-sided 95% critical values of Student's t for 1..30 degrees of freedom. */
+static const double bench_t975[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+/** Returns the critical value for `df` degrees of freedom, rounding down (to
+ * the wider interval) between table entries. */
+static double bench_tcrit(double df) {
+    if (df < 1.0)
+        return bench_t975[0];
+    if (df < 31.0)
+        return bench_t975[(size_t)df - 1];
+    return df < 60.0 ? 2.042 : df < 120.0 ? 2.000 : 1.980;
+}
+
+static bench_sample bench_summarize(const double* samples, size_t n) {
+    bench_sample out = {n, 0.0, 0.0};
+    for (size_t i = 0; i < n; i++)
+        out.mean += samples[i];
+    out.mean /= n > 0 ? (double)n : 1.0;
+
+    if (n > 1) {
+        for (size_t i = 0; i < n; i++)
+            out.var += (samples[i] - out.mean) * (samples[i] - out.mean);
+        out.var /= (double)(n - 1);
+    }
+
+    return out;
+}
+
+/** Reads the numbers in the JSON array following `"key": [` in `obj`, up to
+ * `max`; returns how many were read. */
+static size_t bench_json_array(const char* obj, const char* key, double* out, size_t max) {
+    char pattern[BENCH_MAXNAME] = {0};
+    _sir_snprintf_trunc(pattern, BENCH_MAXNAME, "\"%s\": [", key);
+
+    const char* p = strstr(obj, pattern);
+    if (!p)
+        return 0;
+
+    p += strlen(pattern);
+    size_t count = 0;
+    while (count < max && ']' != *p) {
+        char* end    = NULL;
+        out[count++] = strtod(p, &end);
+        if (end == p)
+            return 0;
+        p = end;
+        while (',' == *p || ' ' == *p)
+            p++;
+    }
+
+    return count;
+}
+
+/** Reads the number following `"key": ` in `obj`. */
+static bool bench_json_number(const char* obj, const char* key, double* out) {
+    char pattern[BENCH_MAXNAME] = {0};
+    _sir_snprintf_trunc(pattern, BENCH_MAXNAME, "\"%s\": ", key);
+
+    const char* p = strstr(obj, pattern);
+    if (!p)
+        return false;
+
+    char* end = NULL;
+    *out      = strtod(p + strlen(pattern), &end);
+    return end != p + strlen(pattern);
+}
+
+/** Whether two paths name the same file (or would, once it exists). */
+static bool bench_samepath(const char* a, const char* b) {
+    if (0 == strcmp(a, b))
+        return true;
+
+#if !defined(__WIN__)
+    char real_a[SIR_MAXPATH] = {0};
+    char real_b[SIR_MAXPATH] = {0};
+    if (realpath(a, real_a) && realpath(b, real_b))
+        return 0 == strcmp(real_a, real_b);
+#endif
+
+    return false;
+}
+
+/** Loads a whole file into a NUL-terminated buffer. */
+static char* bench_load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+
+    char* buf = NULL;
+    long size = -1L;
+    if (0 == fseek(f, 0L, SEEK_END) && (size = ftell(f)) > 0 && 0 == fseek(f, 0L, SEEK_SET)) {
+        buf = (char*)calloc((size_t)size + 1, sizeof(char));
+        if (buf && (size_t)size != fread(buf, sizeof(char), (size_t)size, f))
+            _sir_safefree(&buf);
+    }
+
+    _sir_safefclose(&f);
+    return buf;
+}
+
+/**
+ * Finds a scenario in a JSON file written by bench_write_json, and reads its
+ * per-run samples (or, for files with no samples, the single result).
+ */
+static bool bench_find_baseline(const char* json, const char* name, double* thru,
+    size_t* thru_n, double* p99, size_t* p99_n) {
+    char pattern[BENCH_MAXNAME + 16] = {0};
+    _sir_snprintf_trunc(pattern, sizeof(pattern), "{\"name\": \"%s\",", name);
+
+    const char* start = strstr(json, pattern);
+    const char* end   = start ? strchr(start, '}') : NULL;
+    if (!end)
+        return false;
+
+    char obj[4096] = {0};
+    size_t len     = (size_t)(end - start);
+    (void)memcpy(obj, start, len < sizeof(obj) - 1 ? len : sizeof(obj) - 1);
+
+    *thru_n = bench_json_array(obj, "throughput_runs", thru, BENCH_MAXRUNS);
+    if (0 == *thru_n && bench_json_number(obj, "throughput", thru))
+        *thru_n = 1;
+
+    *p99_n = bench_json_array(obj, "p99_runs", p99, BENCH_MAXRUNS);
+    if (0 == *p99_n && bench_json_number(obj, "p99_ns", p99))
+        *p99_n = 1;
+
+    return *thru_n > 0 && *p99_n > 0;
+}
+
+/** Compares one metric and prints a row. Returns 1 if it regressed, -1 if there
+ * weren't enough runs on either side to tell, and 0 otherwise. */
+static int bench_compare_metric(const char* name, const char* metric, bool higher_better,
+    const double* base, size_t base_n, const double* cur, size_t cur_n, double threshold) {
+    bench_sample b = bench_summarize(base, base_n);
+    bench_sample c = bench_summarize(cur, cur_n);
+
+    double change = b.mean > 0.0 ? 100.0 * (c.mean - b.mean) / b.mean : 0.0;
+    bool enough   = b.n > 1 && c.n > 1 && b.mean > 0.0;
+    bool regress  = false;
+    char ci[32]   = "n/a";
+
+    if (enough) {
+        /* Welch's t-interval for the difference in means. */
+        double vb = b.var / (double)b.n;
+        double vc = c.var / (double)c.n;
+        double se = sqrt(vb + vc);
+        double df = se > 0.0 ? ((vb + vc) * (vb + vc)) /
+            ((vb * vb) / (double)(b.n - 1) + (vc * vc) / (double)(c.n - 1)) : 1e9;
+        double lo = 100.0 * ((c.mean - b.mean) - bench_tcrit(df) * se) / b.mean;
+        double hi = 100.0 * ((c.mean - b.mean) + bench_tcrit(df) * se) / b.mean;
+
+        _sir_snprintf_trunc(ci, sizeof(ci), "[%+.1f%%, %+.1f%%]", lo, hi);
+        regress = higher_better ? (hi < 0.0 && change < -threshold)
+                                : (lo > 0.0 && change > threshold);
+    }
+
+    (void)fprintf(report, "%-28s %-10s %14.0f %14.0f %+8.1f%% %-20s %s" SIR_EOL, name,
+        metric, b.mean, c.mean, change, ci, regress ? "REGRESSION" : enough ? "" : "TOO FEW RUNS");
+    return regress ? 1 : enough ? 0 : -1;
+}
+
+int bench_compare(const char* path, const char* json, const bench_scenario* scenarios,
+    const bench_result* results, size_t count, double threshold) {
+    (void)fprintf(report, SIR_EOL "comparison with %s (95%% confidence; threshold: %.1f%%)"
+        SIR_EOL SIR_EOL "%-28s %-10s %14s %14s %9s %-20s" SIR_EOL, path, threshold,
+        "scenario", "metric", "baseline", "current", "change", "95% CI");
+
+    int regressions = 0;
+    int unjudged    = 0;
+    for (size_t n = 0; n < count; n++) {
+        double thru[BENCH_MAXRUNS] = {0};
+        double p99[BENCH_MAXRUNS]  = {0};
+        size_t thru_n              = 0;
+        size_t p99_n               = 0;
+
+        if (!bench_find_baseline(json, scenarios[n].name, thru, &thru_n, p99, &p99_n)) {
+            (void)fprintf(report, "%-28s (not in baseline)" SIR_EOL, scenarios[n].name);
+            continue;
+        }
+
+        int thru_cmp = bench_compare_metric(scenarios[n].name, "calls/sec", true, thru,
+            thru_n, results[n].throughput_runs, results[n].runs, threshold);
+        int p99_cmp  = bench_compare_metric(scenarios[n].name, "p99 ns", false, p99, p99_n,
+            results[n].p99_runs, results[n].runs, threshold);
+
+        regressions += (thru_cmp > 0 ? 1 : 0) + (p99_cmp > 0 ? 1 : 0);
+        unjudged    += (thru_cmp < 0 ? 1 : 0) + (p99_cmp < 0 ? 1 : 0);
+    }
+
+    (void)fprintf(report, SIR_EOL "%d regression(s)" SIR_EOL, regressions);
+
+    /* passing without having been able to tell would hide regressions. */
+    if (unjudged > 0) {
+        (void)fprintf(report, "%d metric(s) could not be compared: at least 2 runs are"
+            " needed on each side (see --runs)" SIR_EOL, unjudged);
+        return regressions > 0 ? regressions : -1;
+    }
+
+    return regressions;
+}
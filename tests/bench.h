@@ -0,0 +1,177 @@
+/*
+ * bench.h
+ *
+ * Scenarios, results, and helpers for the libsir benchmark suite (sirbench).
+ *
+ * Version: 2.2.6
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2018-2026 Ryan M. Lederman <lederman@gmail.com>
+ * Copyright (c) 2018-2026 Jeffrey H. Johnson <johnsonjh.dev@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+#ifndef _SIR_BENCH_H_INCLUDED
+# define _SIR_BENCH_H_INCLUDED
+
+# include "tests_shared.h"
+
+/**
+ * Macros
+ */
+
+/** The maximum number of scenarios in one run. */
+# define BENCH_MAXSCENARIOS 64
+
+/** The maximum length of a scenario's name. */
+# define BENCH_MAXNAME 48
+
+/** Calls made by each thread in each scenario, unless overridden. */
+# define BENCH_DEFCALLS 20000
+
+/** Calls made by each thread in each scenario with `--quick`. */
+# define BENCH_QUICKCALLS 2000
+
+/** The maximum number of times each scenario may be repeated. */
+# define BENCH_MAXRUNS 32
+
+/** Default for `--threshold`: changes smaller than this (percent) are noise. */
+# define BENCH_DEFTHRESHOLD 5.0
+
+/** The dummy plugin that the plugin scenarios load. */
+# if !defined(__WIN__)
+#  define BENCH_PLUGIN "build/lib/plugin_dummy.so"
+# else
+#  define BENCH_PLUGIN "build/lib/plugin_dummy.dll"
+# endif
+
+/** Log files are created in the test log directory, and removed afterwards. */
+# define BENCH_LOGNAME MAKE_LOG_NAME("bench-%zu.log")
+
+/**
+ * Command line arguments.
+ */
+
+# define BENCH_CL_JSONFLAG    "--json"
+# define BENCH_CL_CALLSFLAG   "--calls"
+# define BENCH_CL_QUICKFLAG   "--quick"
+# define BENCH_CL_ONLYFLAG    "--only"
+# define BENCH_CL_LISTFLAG    "--list"
+# define BENCH_CL_RUNSFLAG    "--runs"
+# define BENCH_CL_COMPAREFLAG "--compare"
+# define BENCH_CL_THRESHFLAG  "--threshold"
+
+# define BENCH_CL_JSONDESC    "Writes the results as JSON to the specified file"
+# define BENCH_CL_CALLSDESC   "Calls made by each thread in each scenario (default: 20000)"
+# define BENCH_CL_QUICKDESC   "Makes 2000 calls per thread; for a quick sanity check"
+# define BENCH_CL_ONLYDESC    "Only runs scenarios whose names begin with the specified prefix"
+# define BENCH_CL_LISTDESC    "Prints the names of the scenarios, then exits"
+# define BENCH_CL_RUNSDESC    "Repeats each scenario n times (default: 1)"
+# define BENCH_CL_COMPAREDESC "Compares the results to a previous --json file; exits with 1 on regressions"
+# define BENCH_CL_THRESHDESC  "Smallest change (percent) that --compare reports as a regression (default: 5)"
+
+/**
+ * Types
+ */
+
+/** A combination of settings to measure. */
+typedef struct {
+    char name[BENCH_MAXNAME]; /**< Unique; results are matched by name. */
+    size_t threads;           /**< Number of threads logging concurrently. */
+    size_t msg_size;          /**< Size of each message, in bytes. */
+    bool to_stdout;           /**< Whether stdout (redirected to the null device) is a destination. */
+    size_t files;             /**< Number of log files. */
+    bool plugin;              /**< Whether the dummy plugin is loaded. */
+    sir_options opts;         /**< Formatting options for every destination. */
+    bool disabled;            /**< If true, log at a level that no destination wants. */
+} bench_scenario;
+
+/** The measurements for one scenario. With more than one run, each figure is
+ * the mean across runs, and the per-run samples are kept for --compare. */
+typedef struct {
+    uint64_t calls;                        /**< Total calls made, across all threads. */
+    double msec;                           /**< Wall-clock time for all threads to finish. */
+    double throughput;                     /**< Calls per second. */
+    uint64_t p50_ns;                       /**< Median per-call latency, in nanoseconds. */
+    uint64_t p99_ns;                       /**< 99th percentile per-call latency. */
+    uint64_t p999_ns;                      /**< 99.9th percentile per-call latency. */
+    uint64_t max_ns;                       /**< Worst per-call latency. */
+    size_t runs;                           /**< Number of runs. */
+    double throughput_runs[BENCH_MAXRUNS]; /**< Throughput of each run. */
+    double p99_runs[BENCH_MAXRUNS];        /**< p99 latency of each run. */
+} bench_result;
+
+/** Summary statistics for a set of samples. */
+typedef struct {
+    size_t n;     /**< Number of samples. */
+    double mean;  /**< Arithmetic mean. */
+    double var;   /**< Sample variance (zero if n < 2). */
+} bench_sample;
+
+/** Options from the command line. */
+typedef struct {
+    const char* json;  /**< --json */
+    const char* only;     /**< --only */
+    const char* compare;  /**< --compare */
+    size_t calls;         /**< --calls/--quick */
+    size_t runs;          /**< --runs */
+    double threshold;     /**< --threshold */
+    bool list;            /**< --list */
+} bench_config;
+
+/**
+ * Functions
+ */
+
+/** Fills `scenarios` with the sweep for this machine; returns how many. */
+size_t bench_make_scenarios(bench_scenario* scenarios, size_t max, long nprocs);
+
+/** Runs one scenario once; returns false if it couldn't be set up. */
+bool bench_run(const bench_scenario* scenario, size_t calls, bench_result* result);
+
+/** Runs one scenario `runs` times, averaging the results into `result`. */
+bool bench_run_repeated(const bench_scenario* scenario, size_t calls, size_t runs,
+    bench_result* result);
+
+/**
+ * Compares results to those in a previous JSON file. For throughput and p99
+ * latency in each scenario present in both, computes a 95% confidence interval
+ * for the difference in means (Welch's t-interval), and reports a regression if
+ * the interval excludes zero on the worse side and the mean changed by more than
+ * `threshold` percent of the baseline. `json` is the contents of the file at
+ * `path`. Needs at least two runs on each side; if any metric has fewer, it is
+ * shown as such, and the comparison fails. Returns the number of regressions,
+ * or -1 if there were none but some metrics couldn't be compared.
+ */
+int bench_compare(const char* path, const char* json, const bench_scenario* scenarios,
+    const bench_result* results, size_t count, double threshold);
+
+/** Writes results as JSON to `path`. */
+bool bench_write_json(const char* path, const bench_scenario* scenarios,
+    const bench_result* results, size_t count, long nprocs, size_t calls, size_t runs);
+
+/** Returns a monotonic timestamp in nanoseconds. */
+uint64_t bench_clock(void);
+
+#endif /* !_SIR_BENCH_H_INCLUDED */
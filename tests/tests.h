@@ -40,6 +40,15 @@
 # include "sir/threadpool.h"
 # include "sir/queue.h"
 
+# if !defined(SIR_NO_PLUGINS)
+#  include "../plugins/shipper/shipper.h"
+#  if !defined(__WIN__)
+#   include <sys/socket.h>
+#   include <netinet/in.h>
+#   include <poll.h>
+#  endif
+# endif
+
 /**
  * @defgroup tests Tests
  *
@@ -261,6 +270,22 @@ bool sirtest_os_log(void);
  */
 bool sirtest_win_eventlog(void);
 
+/**
+ * @test sirtest_syslognative
+ * @brief Ensure the built-in RFC 5424 transport sends well-formed messages to
+ * Unix datagram and UDP listeners.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_syslognative(void);
+
+/**
+ * @test sirtest_syslogjournal
+ * @brief Ensure the built-in transport sends well-formed systemd journal
+ * records, including source locations and multi-line messages.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_syslogjournal(void);
+
 /**
  * @test sirtest_filesystem
  * @brief Ensure the proper functionality of portable filesystem implementation.
@@ -284,6 +309,39 @@ bool sirtest_squelchspam(void);
  */
 bool sirtest_pluginloader(void);
 
+/**
+ * @test sirtest_pluginrecords
+ * @brief Ensure that v2 plugins with the records capability receive complete,
+ * well-formed batches of structured records.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_pluginrecords(void);
+
+/**
+ * @test sirtest_pluginqueue
+ * @brief Ensure that a slow plugin does not block logging threads, and that
+ * plugin queue overflow policies and counters behave as documented.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_pluginqueue(void);
+
+/**
+ * @test sirtest_pluginswap
+ * @brief Ensure that logging is not held up while a plugin that is slow to
+ * initialize and clean up is unloaded and loaded again.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_pluginswap(void);
+
+/**
+ * @test sirtest_pluginshipper
+ * @brief Ensure that the bundled log shipper plugin delivers length-prefixed
+ * frames to a local listener, reconnects when the connection is lost, and
+ * counts what it has to drop.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_pluginshipper(void);
+
 /**
  * @test sirtest_stringutils
  * @brief Ensure the string utility routines are functioning properly.
@@ -305,14 +363,114 @@ bool sirtest_getcpucount(void);
  */
 bool sirtest_getversioninfo(void);
 
+/**
+ * @test sirtest_consolebatching
+ * @brief Ensure that console output which is not going to a terminal is
+ * batched, unstyled, and written out when an error is logged.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_consolebatching(void);
+
 /**
  * @test sirtest_threadpool
  * @brief Ensure the proper functioning of the thread pool and job queue mech-
- * anisms.
+ * anisms, including batch submission, jobs that submit jobs, and work stealing.
  * @returns bool `true` if the test succeeded, `false` otherwise.
  */
 bool sirtest_threadpool(void);
 
+/**
+ * @test sirtest_threadpoolconfig
+ * @brief Ensure that thread pool threads are named, pinned, and reniced as
+ * configured.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_threadpoolconfig(void);
+
+/**
+ * @test sirtest_lockstats
+ * @brief Ensure that lock contention counters are collected and reset in
+ * SIR_LOCK_PROFILE builds, and unavailable otherwise.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_lockstats(void);
+
+/**
+ * @test sirtest_runtimestats
+ * @brief Ensure that sir_getstats counts messages per level, lines and bytes
+ * per destination, and records latency histograms.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_runtimestats(void);
+
+/**
+ * @test sirtest_jsonoutput
+ * @brief Ensure that SIRO_JSON destinations write one valid, correctly escaped
+ * JSON object per line, even when the message must be truncated.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_jsonoutput(void);
+
+/**
+ * @test sirtest_kvfields
+ * @brief Ensure that key/value fields attached with sir_logkv are rendered as
+ * logfmt pairs in text output, and as members of the object in JSON output.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_kvfields(void);
+
+/**
+ * @test sirtest_timeformats
+ * @brief Ensure that each time stamp format and precision produces time stamps
+ * of the expected shape, and that invalid settings are rejected.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_timeformats(void);
+
+/**
+ * @test sirtest_timesources
+ * @brief Ensure that time stamps from each time source (including the CPU's
+ * time stamp counter, or the wall clock if it can't be used) agree with the
+ * wall clock, and that an invalid source is rejected.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_timesources(void);
+
+/**
+ * @test sirtest_contexts
+ * @brief Ensure that contexts created with sir_ctx_init have their own
+ * destinations, and outlive the default instance.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_contexts(void);
+
+/**
+ * @test sirtest_categories
+ * @brief Ensure that category rules are parsed and validated, that categories
+ * follow the rule of their nearest parent (or the default rule), and that
+ * changing the rules invalidates the decisions cached in call sites.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_categories(void);
+
+/**
+ * @test sirtest_ratelimits
+ * @brief Ensure that sir_loglimit lets through one in N sampled calls, and no
+ * more than the burst of a rate limit at once, and that it reports the number
+ * of messages suppressed: before the next one let through, from the ticker
+ * thread, or when the context is cleaned up.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_ratelimits(void);
+
+/**
+ * @test sirtest_queuempmc
+ * @brief Ensure that sir_queue is bounded, FIFO, and loses or duplicates
+ * nothing with multiple producers and consumers.
+ * @returns bool `true` if the test succeeded, `false` otherwise.
+ */
+bool sirtest_queuempmc(void);
+
 /** @} */
 
 /**
@@ -369,4 +527,10 @@ char* get_wineversion(void);
  */
 bool roll_and_archive(const char* filename, const char* extension);
 
+/**
+ * Used by the time-sources test: logs to a file with the given time source, and
+ * checks that each time stamp is within `slack_nsec` of the wall clock.
+ */
+bool check_time_source(sir_time_source source, uint32_t pause_msec, int64_t slack_nsec);
+
 #endif /* !_SIR_TESTS_H_INCLUDED */